@@ -3,6 +3,11 @@ newoption {
     description = "enable sanitizers"
 }
 
+newoption {
+    trigger = "memtrack",
+    description = "enable memory allocations tracker"
+}
+
 workspace "carnage3d"
    location '.build'
    configurations { "Debug", "Release" }
@@ -16,6 +21,12 @@ if _OPTIONS["sanitize"] then
     linkoptions { "-fsanitize=address", "-fsanitize=undefined" }
 end
 
+if _OPTIONS["memtrack"] then
+    defines { "ENABLE_MEMORY_TRACKER" }
+    -- export symbols so allocation call sites can be resolved
+    linkoptions { "-rdynamic" }
+end
+
 filter 'system:linux'
    platforms { 'x86_64' }
 
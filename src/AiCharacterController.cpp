@@ -5,6 +5,8 @@
 #include "CarnageGame.h"
 #include "DebugRenderer.h"
 #include "BroadcastEventsManager.h"
+#include "AiManager.h"
+#include "TimeManager.h"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -102,6 +104,7 @@ AiCharacterController::AiCharacterController(Pedestrian* character)
     mFollowNearDistance = gGameParams.mPedestrianBoundsSphereRadius * 2.0f;
     mFollowFarDistance = Convert::MapUnitsToMeters(0.5f);
     mDefaultNearDistance = gGameParams.mPedestrianBoundsSphereRadius;
+    mDriveLaneNode = AiRoadLaneGraph::InvalidNodeIndex;
 
     if (mCharacter)
     {
@@ -110,6 +113,11 @@ AiCharacterController::AiCharacterController(Pedestrian* character)
     }
 }
 
+AiCharacterController::~AiCharacterController()
+{
+    ResetPath();
+}
+
 void AiCharacterController::DebugDraw(DebugRenderer& debugRender)
 {
     if (mAiMode == ePedestrianAiMode_None || mAiMode == ePedestrianAiMode_Disabled)
@@ -123,6 +131,8 @@ void AiCharacterController::DebugDraw(DebugRenderer& debugRender)
 
 bool AiCharacterController::ScanForThreats()
 {
+    mHasPanicEvent = false;
+
     if (mCharacter->HasFear_GunShots() && ScanForGunshots())
         return true;
 
@@ -134,14 +144,11 @@ bool AiCharacterController::ScanForThreats()
 
 bool AiCharacterController::ScanForExplosions()
 {
-    float reactionDistance2 = glm::pow(gGameParams.mAiReactOnExplosionsDistance, 2.0f);
-
     BroadcastEvent eventData;
-    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_Explosion, mCharacter->GetPosition2(), eventData))
+    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_Explosion, mCharacter->GetPosition2(), gGameParams.mAiReactOnExplosionsDistance, eventData))
     {
-        if (glm::distance2(eventData.mPosition, mCharacter->GetPosition2()) > reactionDistance2) // too far away
-            return false;
-
+        mPanicEvent = eventData;
+        mHasPanicEvent = true;
         return true;
     }
     return false;
@@ -149,17 +156,12 @@ bool AiCharacterController::ScanForExplosions()
 
 bool AiCharacterController::ScanForGunshots()
 {
-    float reactionDistance2 = glm::pow(gGameParams.mAiReactOnGunshotsDistance, 2.0f);
-
     BroadcastEvent eventData;
-    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_GunShot, mCharacter->GetPosition2(), eventData))
+    // ignore own gunshots
+    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_GunShot, mCharacter->GetPosition2(), gGameParams.mAiReactOnGunshotsDistance, mCharacter, eventData))
     {
-        if (eventData.mCharacter == mCharacter) // hear own gunshots
-            return false; 
-
-        if (glm::distance2(eventData.mPosition, mCharacter->GetPosition2()) > reactionDistance2) // too far away
-            return false;
-
+        mPanicEvent = eventData;
+        mHasPanicEvent = true;
         return true;
     }
     return false;
@@ -210,6 +212,7 @@ void AiCharacterController::UpdateFrame()
     }
     else if (mCharacter->IsBurn())
     {
+        mHasPanicEvent = false;
         StartPanic();
         return;
     }
@@ -266,6 +269,7 @@ void AiCharacterController::StartPanic()
 {
     mAiMode = ePedestrianAiMode_Panic;
     mFollowPedestrian.reset();
+    ResetPath();
 
     mRunToTarget = true;
 
@@ -280,6 +284,7 @@ void AiCharacterController::StartWandering()
 {
     mAiMode = ePedestrianAiMode_Wandering;
     mFollowPedestrian.reset();
+    ResetPath();
 
     mCharacter->mCtlState.Clear();
     if (!ChooseWalkWaypoint(false) || !ContinueWalkToWaypoint(mDefaultNearDistance))
@@ -304,8 +309,16 @@ bool AiCharacterController::ChooseWalkWaypoint(bool isPanic)
 
     glm::ivec3 currentLogPos = Convert::MetersToMapUnits(mCharacter->GetPosition());
     glm::ivec3 newWayPoint (0, 0, 0);
+    if (isPanic && mHasPanicEvent)
+    {
+        ChooseFleeBlock(currentLogPos, newWayPoint);
+    }
+
     for (eMapDirection curr: moveDirs)
     {
+        if (newWayPoint != glm::ivec3(0, 0, 0))
+            break;
+
         glm::ivec3 moveBlockPos = currentLogPos + GetVectorFromMapDirection(curr);
 
         const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(moveBlockPos.x, moveBlockPos.z, moveBlockPos.y);
@@ -348,6 +361,21 @@ bool AiCharacterController::ChooseWalkWaypoint(bool isPanic)
     return true;
 }
 
+bool AiCharacterController::ChooseFleeBlock(const glm::ivec3& currentBlock, glm::ivec3& outputBlock)
+{
+    if (gTimeManager.mGameTime > mPanicEvent.mEventTimestamp + mPanicEvent.mEventDurationTime)
+    {
+        mHasPanicEvent = false; // event is over
+        return false;
+    }
+
+    const AiFlowField* fleeField = gAiManager.mFlowFields.GetFleeField(mPanicEvent, currentBlock.y);
+    if (fleeField == nullptr)
+        return false;
+
+    return fleeField->GetNextBlock(currentBlock, outputBlock);
+}
+
 bool AiCharacterController::ContinueWalkToWaypoint(float distance)
 {
     float tolerance2 = pow(gGameParams.mPedestrianBoundsSphereRadius, 2.0f);
@@ -370,10 +398,80 @@ bool AiCharacterController::ContinueWalkToWaypoint(float distance)
     return true;
 }
 
+bool AiCharacterController::ContinueWalkAlongPath(const glm::ivec3& goalBlock)
+{
+    AiPathfinder& pathfinder = gAiManager.mPathfinder;
+
+    if (mPathRequest != AiPathRequestID_Null)
+    {
+        if (pathfinder.GetPathStatus(mPathRequest) == eAiPathStatus_Pending)
+            return false;
+
+        mPathBlockIndex = 0;
+        if (!pathfinder.TakePathResult(mPathRequest, mPathBlocks))
+        {
+            mPathRetryTime = gTimeManager.mGameTime + 1.0f;
+        }
+        mPathRequest = AiPathRequestID_Null;
+    }
+
+    glm::ivec3 currentBlock = Convert::MetersToMapUnits(mCharacter->GetPosition());
+    if (currentBlock.x == goalBlock.x && currentBlock.z == goalBlock.z)
+        return false;
+
+    // skip reached blocks
+    for (; mPathBlockIndex < (int) mPathBlocks.size(); ++mPathBlockIndex)
+    {
+        const glm::ivec3& pathBlock = mPathBlocks[mPathBlockIndex];
+        if (pathBlock.x != currentBlock.x || pathBlock.z != currentBlock.z)
+            break;
+    }
+
+    bool isPathCompleted = (mPathBlockIndex >= (int) mPathBlocks.size());
+    bool isGoalMoved = (abs(goalBlock.x - mPathGoalBlock.x) + abs(goalBlock.z - mPathGoalBlock.z)) > 2;
+    bool isOffPath = !isPathCompleted && 
+        (abs(mPathBlocks[mPathBlockIndex].x - currentBlock.x) + abs(mPathBlocks[mPathBlockIndex].z - currentBlock.z)) > 1;
+
+    if (isPathCompleted || isGoalMoved || isOffPath)
+    {
+        mPathBlocks.clear();
+        mPathBlockIndex = 0;
+
+        if (mPathRetryTime <= gTimeManager.mGameTime)
+        {
+            mPathGoalBlock = goalBlock;
+            mPathRequest = pathfinder.RequestPath(currentBlock, goalBlock);
+            if (mPathRequest == AiPathRequestID_Null) // requests queue is full
+            {
+                mPathRetryTime = gTimeManager.mGameTime + 1.0f;
+            }
+        }
+        return false;
+    }
+
+    const glm::ivec3& nextBlock = mPathBlocks[mPathBlockIndex];
+    mDestinationPoint.x = Convert::MapUnitsToMeters(nextBlock.x + 0.5f);
+    mDestinationPoint.y = Convert::MapUnitsToMeters(nextBlock.z + 0.5f);
+    return ContinueWalkToWaypoint(mFollowNearDistance);
+}
+
+void AiCharacterController::ResetPath()
+{
+    if (mPathRequest != AiPathRequestID_Null)
+    {
+        gAiManager.mPathfinder.CancelRequest(mPathRequest);
+        mPathRequest = AiPathRequestID_Null;
+    }
+    mPathBlocks.clear();
+    mPathBlockIndex = 0;
+}
+
 void AiCharacterController::StartDrivingCar()
 {
     mAiMode = ePedestrianAiMode_DrivingCar;
     mFollowPedestrian.reset();
+    ResetPath();
+    mDriveLaneNode = AiRoadLaneGraph::InvalidNodeIndex;
 
     mCharacter->mCtlState.Clear();
     if (!ChooseDriveWaypoint() || !ContinueDriveToWaypoint())
@@ -427,14 +525,84 @@ void AiCharacterController::UpdateDrivingCar()
 
 bool AiCharacterController::ChooseDriveWaypoint()
 {
-    // todo: implement
-    return false;
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+
+    CarPhysicsBody* carPhysics = mCharacter->mCurrentCar->mPhysicsBody;
+
+    // continue from reached node or find out where car is now
+    int currentNode = mDriveLaneNode;
+    if (currentNode == AiRoadLaneGraph::InvalidNodeIndex)
+    {
+        glm::ivec3 carLogPos = Convert::MetersToMapUnits(carPhysics->GetPosition());
+        currentNode = laneGraph.GetNodeIndex(carLogPos.x, carLogPos.z, carLogPos.y);
+        if (currentNode == AiRoadLaneGraph::InvalidNodeIndex)
+            return false;
+    }
+
+    // choose random lane but never turn back
+    glm::vec2 carHeading = carPhysics->GetSignVector();
+    glm::vec2 currentNodePosition = laneGraph.GetNodePosition2(currentNode);
+
+    int candidateNodes[4];
+    int candidatesCount = 0;
+
+    const int* nodeEdges = laneGraph.GetNodeEdges(currentNode);
+    for (int iedge = 0, EdgesCount = laneGraph.GetNodeEdgesCount(currentNode); 
+        iedge < EdgesCount && candidatesCount < CountOf(candidateNodes); ++iedge)
+    {
+        glm::vec2 toNextNode = laneGraph.GetNodePosition2(nodeEdges[iedge]) - currentNodePosition;
+        if (glm::dot(glm::normalize(toNextNode), carHeading) < -0.5f)
+            continue;
+
+        candidateNodes[candidatesCount++] = nodeEdges[iedge];
+    }
+
+    if (candidatesCount == 0)
+    {
+        mDriveLaneNode = AiRoadLaneGraph::InvalidNodeIndex;
+        return false;
+    }
+
+    int chooseCandidate = gCarnageGame.mGameRand.generate_int(0, candidatesCount - 1);
+    mDriveLaneNode = candidateNodes[chooseCandidate];
+    mDestinationPoint = laneGraph.GetNodePosition2(mDriveLaneNode);
+    return true;
 }
 
 bool AiCharacterController::ContinueDriveToWaypoint()
 {
-    // todo: implement
-    return false;
+    if (mDriveLaneNode == AiRoadLaneGraph::InvalidNodeIndex)
+        return false;
+
+    CarPhysicsBody* carPhysics = mCharacter->mCurrentCar->mPhysicsBody;
+
+    glm::vec2 carPosition = carPhysics->GetPosition2();
+    float distanceToTarget2 = glm::distance2(carPosition, mDestinationPoint);
+
+    // waypoint reached, keep controls as is until next one gets chosen
+    if (distanceToTarget2 <= glm::pow(Convert::MapUnitsToMeters(0.5f), 2.0f))
+        return false;
+
+    // car was pushed away from lane
+    if (distanceToTarget2 > glm::pow(Convert::MapUnitsToMeters(2.5f), 2.0f))
+    {
+        mDriveLaneNode = AiRoadLaneGraph::InvalidNodeIndex;
+        return false;
+    }
+
+    glm::vec2 carHeading = carPhysics->GetSignVector();
+    glm::vec2 toTarget = glm::normalize(mDestinationPoint - carPosition);
+
+    // signed angle between heading and direction to target, positive is clockwise
+    float turnAngle = atan2f(carHeading.x * toTarget.y - carHeading.y * toTarget.x, glm::dot(carHeading, toTarget));
+
+    float desiredSpeed = (fabs(turnAngle) > glm::radians(30.0f)) ? gGameParams.mAiCarTurnSpeed : gGameParams.mAiCarDriveSpeed;
+    float currentSpeed = carPhysics->GetCurrentSpeed();
+
+    mCharacter->mCtlState.mSteerDirection = glm::clamp(turnAngle / glm::radians(45.0f), -1.0f, 1.0f);
+    mCharacter->mCtlState.mAcceleration = (currentSpeed < desiredSpeed) ? 1.0f : 0.0f;
+    mCharacter->mCtlState.mHandBrake = false;
+    return true;
 }
 
 void AiCharacterController::FollowPedestrian(Pedestrian* pedestrian)
@@ -459,6 +627,7 @@ void AiCharacterController::StartFollowTarget()
 
     mCharacter->mCtlState.Clear();
     mAiMode = ePedestrianAiMode_FollowTarget;
+    ResetPath();
 
     mDestinationPoint = mFollowPedestrian->mPhysicsBody->GetPosition2();
 }
@@ -491,6 +660,15 @@ void AiCharacterController::UpdateFollowTarget()
     }
 
     mRunToTarget = mFollowPedestrian->IsRunning() || (distanceToTarget2 > glm::pow(mFollowFarDistance, 2.0f));
+
+    // target is far away, walk around obstacles
+    if (distanceToTarget2 > glm::pow(Convert::MapUnitsToMeters(1.5f), 2.0f))
+    {
+        glm::ivec3 targetBlock = Convert::MetersToMapUnits(mFollowPedestrian->GetPosition());
+        if (ContinueWalkAlongPath(targetBlock))
+            return;
+    }
+
     mDestinationPoint = targetPosition2 + glm::normalize(targetPosition2 - characterPosition2) * mFollowNearDistance;
     ContinueWalkToWaypoint(mFollowNearDistance);
 }
@@ -539,4 +717,3 @@ bool AiCharacterController::TryFollowHumanCharacterNearby()
     }
     return false;
 }
-
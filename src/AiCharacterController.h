@@ -2,6 +2,8 @@
 
 #include "CharacterController.h"
 #include "Pedestrian.h"
+#include "AiPathfinder.h"
+#include "BroadcastEventsManager.h"
 
 enum ePedestrianAiMode
 {
@@ -32,8 +34,11 @@ decl_enum_as_flags(ePedestrianAiFlags);
 // defines ai character controller
 class AiCharacterController final: public CharacterController
 {
+    friend class AiManager;
+
 public:
     AiCharacterController(Pedestrian* character);
+    ~AiCharacterController();
 
     // process controller logic
     void UpdateFrame() override;
@@ -63,6 +68,10 @@ private:
     bool ChooseWalkWaypoint(bool isPanic);
     bool ContinueWalkToWaypoint(float distance);
 
+    // walk to distant location using pathfinding, returns false while path is not ready
+    bool ContinueWalkAlongPath(const glm::ivec3& goalBlock);
+    void ResetPath();
+
     // drive
     bool ChooseDriveWaypoint();
     bool ContinueDriveToWaypoint();
@@ -73,12 +82,17 @@ private:
     bool ScanForGunshots();
     bool ScanForExplosions();
 
+    // choose next block to run away from panic event using its flee field
+    bool ChooseFleeBlock(const glm::ivec3& currentBlock, glm::ivec3& outputBlock);
+
 private:
     ePedestrianAiMode mAiMode = ePedestrianAiMode_None;
     ePedestrianAiState mAiState = ePedestrianAiState_Idle;
 
     glm::vec2 mDestinationPoint;
     float mDefaultNearDistance;
+
+    int mDriveLaneNode; // road lane graph node car currently drives to
     
     ePedestrianAiFlags mAiFlags = ePedestrianAiFlags_None;
 
@@ -87,4 +101,18 @@ private:
     float mFollowFarDistance;
 
     bool mRunToTarget = false;
+
+    BroadcastEvent mPanicEvent; // last threat character runs away from
+    bool mHasPanicEvent = false;
+
+    // managed by ai manager
+    float mLastUpdateTime = 0.0f; // game time of last update
+    int mControllersListIndex = -1;
+
+    // path following
+    AiPathRequestID mPathRequest = AiPathRequestID_Null;
+    std::vector<glm::ivec3> mPathBlocks;
+    int mPathBlockIndex = 0;
+    glm::ivec3 mPathGoalBlock {};
+    float mPathRetryTime = 0.0f;
 };
\ No newline at end of file
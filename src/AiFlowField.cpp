@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "AiFlowField.h"
+#include "AiManager.h"
+
+// straight moves for each field direction
+static const int FieldDirectionOffsets[4][2] =
+{
+    { 0, -1},
+    { 1,  0},
+    { 0,  1},
+    {-1,  0},
+};
+
+bool AiFlowField::GetNextBlock(const glm::ivec3& mapBlock, glm::ivec3& outputBlock) const
+{
+    int localx = mapBlock.x - mOriginX;
+    int localy = mapBlock.z - mOriginY;
+    if (localx < 0 || localx >= FieldSize || localy < 0 || localy >= FieldSize)
+        return false;
+
+    unsigned char direction = mDirections[localy * FieldSize + localx];
+    if (direction == NoDirection)
+        return false;
+
+    outputBlock.x = mapBlock.x + FieldDirectionOffsets[direction][0];
+    outputBlock.y = mapBlock.y;
+    outputBlock.z = mapBlock.z + FieldDirectionOffsets[direction][1];
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void AiFlowFieldsCache::Clear()
+{
+    mFieldsCount = 0;
+}
+
+const AiFlowField* AiFlowFieldsCache::GetFleeField(const BroadcastEvent& eventData, int mapLayer)
+{
+    // find existing field or choose one to replace
+    AiFlowField* replaceField = nullptr;
+    for (int ifield = 0; ifield < mFieldsCount; ++ifield)
+    {
+        AiFlowField& currField = mFields[ifield];
+        if ((currField.mEventType == eventData.mEventType) &&
+            (currField.mEventTimestamp == eventData.mEventTimestamp) &&
+            (currField.mEventPosition == eventData.mPosition) &&
+            (currField.mMapLayer == mapLayer))
+        {
+            return &currField;
+        }
+
+        if (replaceField == nullptr || currField.mExpireTime < replaceField->mExpireTime)
+        {
+            replaceField = &currField;
+        }
+    }
+
+    // when all fields are in use, replace the one which expires first
+    if (mFieldsCount < MaxFields)
+    {
+        replaceField = &mFields[mFieldsCount++];
+    }
+
+    replaceField->mEventType = eventData.mEventType;
+    replaceField->mEventTimestamp = eventData.mEventTimestamp;
+    replaceField->mExpireTime = eventData.mEventTimestamp + eventData.mEventDurationTime;
+    replaceField->mEventPosition = eventData.mPosition;
+    replaceField->mMapLayer = mapLayer;
+    GenerateFleeField(*replaceField);
+    return replaceField;
+}
+
+void AiFlowFieldsCache::GenerateFleeField(AiFlowField& flowField)
+{
+    const int FieldSize = AiFlowField::FieldSize;
+    const int CellsCount = FieldSize * FieldSize;
+    const int Unreachable = INT_MAX;
+
+    glm::ivec2 eventBlock (Convert::MetersToMapUnits(flowField.mEventPosition));
+    flowField.mOriginX = eventBlock.x - FieldSize / 2;
+    flowField.mOriginY = eventBlock.y - FieldSize / 2;
+
+    const AiPathfinder& pathfinder = gAiManager.mPathfinder;
+
+    // mark walkable cells, closest layers are also counted as pedestrians walk along slopes
+    bool walkableCells[CellsCount];
+    for (int iy = 0; iy < FieldSize; ++iy)
+    for (int ix = 0; ix < FieldSize; ++ix)
+    {
+        bool isWalkable = false;
+        for (int mapLayer: { flowField.mMapLayer, flowField.mMapLayer - 1, flowField.mMapLayer + 1 })
+        {
+            if (pathfinder.IsWalkableBlock({flowField.mOriginX + ix, mapLayer, flowField.mOriginY + iy}))
+            {
+                isWalkable = true;
+                break;
+            }
+        }
+        walkableCells[iy * FieldSize + ix] = isWalkable;
+    }
+
+    auto Dijkstra = [this, &walkableCells]()
+    {
+        std::make_heap(mOpenList.begin(), mOpenList.end(), std::greater<std::pair<int, int>>());
+        while (!mOpenList.empty())
+        {
+            std::pop_heap(mOpenList.begin(), mOpenList.end(), std::greater<std::pair<int, int>>());
+            std::pair<int, int> currEntry = mOpenList.back();
+            mOpenList.pop_back();
+
+            const int currCell = currEntry.second;
+            if (currEntry.first != mDistances[currCell]) // already visited with lower cost
+                continue;
+
+            for (const auto& currOffset: FieldDirectionOffsets)
+            {
+                int neighbourx = (currCell % FieldSize) + currOffset[0];
+                int neighboury = (currCell / FieldSize) + currOffset[1];
+                if (neighbourx < 0 || neighbourx >= FieldSize || neighboury < 0 || neighboury >= FieldSize)
+                    continue;
+
+                int neighbourCell = neighboury * FieldSize + neighbourx;
+                if (!walkableCells[neighbourCell])
+                    continue;
+
+                int neighbourDistance = currEntry.first + 10;
+                if (neighbourDistance < mDistances[neighbourCell])
+                {
+                    mDistances[neighbourCell] = neighbourDistance;
+                    mOpenList.emplace_back(neighbourDistance, neighbourCell);
+                    std::push_heap(mOpenList.begin(), mOpenList.end(), std::greater<std::pair<int, int>>());
+                }
+            }
+        }
+    };
+
+    // pass 1: distance from event
+    mOpenList.clear();
+    for (int& currDistance: mDistances)
+    {
+        currDistance = Unreachable;
+    }
+    int eventCell = (FieldSize / 2) * FieldSize + (FieldSize / 2);
+    mDistances[eventCell] = 0;
+    mOpenList.emplace_back(0, eventCell);
+    Dijkstra();
+
+    // pass 2: invert and scale distances and relax them again, so that pedestrians
+    // prefer open areas far from event instead of running into nearest dead end,
+    // field borders are treated as exits from danger area
+    mOpenList.clear();
+    for (int icell = 0; icell < CellsCount; ++icell)
+    {
+        if (mDistances[icell] == Unreachable)
+            continue;
+
+        int cellx = icell % FieldSize;
+        int celly = icell / FieldSize;
+        if (cellx == 0 || cellx == FieldSize - 1 || celly == 0 || celly == FieldSize - 1)
+        {
+            mDistances[icell] += FieldSize * 10;
+        }
+        mDistances[icell] = -(mDistances[icell] * 12) / 10;
+        mOpenList.emplace_back(mDistances[icell], icell);
+    }
+    Dijkstra();
+
+    // choose direction to lowest neighbour
+    for (int icell = 0; icell < CellsCount; ++icell)
+    {
+        flowField.mDirections[icell] = AiFlowField::NoDirection;
+        if (mDistances[icell] == Unreachable)
+            continue;
+
+        int bestDistance = mDistances[icell];
+        for (int idirection = 0; idirection < 4; ++idirection)
+        {
+            int neighbourx = (icell % FieldSize) + FieldDirectionOffsets[idirection][0];
+            int neighboury = (icell / FieldSize) + FieldDirectionOffsets[idirection][1];
+            if (neighbourx < 0 || neighbourx >= FieldSize || neighboury < 0 || neighboury >= FieldSize)
+                continue;
+
+            int neighbourDistance = mDistances[neighboury * FieldSize + neighbourx];
+            if (neighbourDistance < bestDistance)
+            {
+                bestDistance = neighbourDistance;
+                flowField.mDirections[icell] = (unsigned char) idirection;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BroadcastEventsManager.h"
+
+// Flee directions over local map area around broadcast event, shared by all pedestrians affected by that event
+struct AiFlowField
+{
+public:
+    static const int FieldSize = 32; // blocks
+    static const unsigned char NoDirection = 0xFF;
+
+public:
+    // Get next map block to run to from specified location
+    // @param mapBlock: Current map block coordinate, where y is map layer
+    // @param outputBlock: Next map block coordinate
+    // @returns false if location is outside of field or there is nowhere to run
+    bool GetNextBlock(const glm::ivec3& mapBlock, glm::ivec3& outputBlock) const;
+
+public:
+    eBroadcastEvent mEventType;
+    float mEventTimestamp = 0.0f;
+    float mExpireTime = 0.0f;
+    glm::vec2 mEventPosition;
+
+    int mOriginX = 0; // map block coordinate of field corner
+    int mOriginY = 0;
+    int mMapLayer = 0;
+
+    unsigned char mDirections[FieldSize * FieldSize]; // direction index for each block
+};
+
+// Generates and caches flee flow fields for active broadcast events
+class AiFlowFieldsCache final: public cxx::noncopyable
+{
+public:
+    // Find existing flee field for event or generate new one
+    // @param eventData: Source event
+    // @param mapLayer: Map layer where field should be generated
+    const AiFlowField* GetFleeField(const BroadcastEvent& eventData, int mapLayer);
+
+    void Clear();
+
+private:
+    void GenerateFleeField(AiFlowField& flowField);
+
+private:
+    static const int MaxFields = 16;
+
+    AiFlowField mFields[MaxFields];
+    int mFieldsCount = 0;
+
+    // generation buffers
+    int mDistances[AiFlowField::FieldSize * AiFlowField::FieldSize];
+    std::vector<std::pair<int, int>> mOpenList; // distance and cell
+};
\ No newline at end of file
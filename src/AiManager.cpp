@@ -2,6 +2,36 @@
 #include "AiManager.h"
 #include "AiCharacterController.h"
 #include "Pedestrian.h"
+#include "CarnageGame.h"
+#include "TimeManager.h"
+#include "cvars.h"
+#include "MemoryTracker.h"
+
+CvarInt gCvarAiUpdateBudget("ai_updateBudget", 2000, 100, 100000, "Max time spent on ai controllers update per frame, microseconds", CvarFlags_Archive);
+
+//////////////////////////////////////////////////////////////////////////
+
+// distance based update cadences, map units
+static const float AiUpdateNearDistance = 8.0f; // controllers closer are updated each frame
+static const float AiUpdateMidDistance = 16.0f;
+static const float AiUpdateMidInterval = 1.0f / 10.0f;
+static const float AiUpdateFarInterval = 1.0f / 3.0f;
+
+//////////////////////////////////////////////////////////////////////////
+
+void AiSchedulerStats::FrameBegin()
+{
+    mTickedControllers = 0;
+    mSkippedControllers = 0;
+    mOverBudgetControllers = 0;
+    mUpdateTime = 0.0f;
+}
+
+void AiSchedulerStats::FrameEnd()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
 
 AiManager gAiManager;
 
@@ -9,27 +39,133 @@ AiManager::AiManager()
 {
 }
 
+void AiManager::EnterWorld()
+{
+    MEMORY_TAG_SCOPE(eMemoryTag_Ai);
+
+    mRoadLaneGraph.BuildFromMap();
+    mPathfinder.BuildFromMap();
+}
+
+void AiManager::ClearWorld()
+{
+    ReleaseAiControllers();
+    mRoadLaneGraph.Clear();
+    mPathfinder.Clear();
+    mFlowFields.Clear();
+}
+
 void AiManager::UpdateFrame()
 {
-    // update all character controllers
-    bool hasInactiveControllers = false;
-    for (size_t iController = 0, Count = mCharacterControllers.size(); iController < Count; ++iController)
+    MEMORY_TAG_SCOPE(eMemoryTag_Ai);
+
+    mSchedulerStats.FrameBegin();
+    UpdateControllers();
+    mSchedulerStats.FrameEnd();
+
+    mPathfinder.UpdateFrame();
+}
+
+void AiManager::UpdateControllers()
+{
+    // collect human players locations
+    mPlayersCount = 0;
+    for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
+    {
+        if (humanPlayer == nullptr || humanPlayer->mCharacter == nullptr)
+            continue;
+
+        mPlayerPositions[mPlayersCount++] = humanPlayer->mCharacter->GetPosition2();
+    }
+
+    const size_t ControllersCount = mCharacterControllers.size();
+    if (mUpdateCursor >= ControllersCount)
+    {
+        mUpdateCursor = 0;
+    }
+
+    const double budgetSeconds = gCvarAiUpdateBudget.mValue / 1000000.0;
+    const double startTime = gSystem.GetSystemSeconds();
+    const float currentGameTime = gTimeManager.mGameTime;
+
+    // process controllers in round-robin order, those that did not fit into budget will be first in next frame
+    bool isOutOfBudget = false;
+    size_t nextUpdateCursor = 0;
+    for (size_t icounter = 0; icounter < ControllersCount; ++icounter)
     {
+        size_t iController = (mUpdateCursor + icounter) % ControllersCount;
+
         AiCharacterController* currController = mCharacterControllers[iController];
-        if (currController->IsControllerActive())
+        if (!currController->IsControllerActive())
+        {
+            mInactiveControllers.push_back(currController);
+            continue;
+        }
+
+        float updateInterval = GetControllerUpdateInterval(currController);
+        if ((currentGameTime - currController->mLastUpdateTime) < updateInterval)
         {
-            currController->UpdateFrame();
+            ++mSchedulerStats.mSkippedControllers;
+            continue;
         }
-        else
+
+        // controllers nearby players are never postponed
+        if (isOutOfBudget && (updateInterval > 0.0f))
         {
-            SafeDelete(mCharacterControllers[iController]);
-            hasInactiveControllers = true;
+            ++mSchedulerStats.mSkippedControllers;
+            continue;
         }
+
+        currController->mLastUpdateTime = currentGameTime;
+        currController->UpdateFrame();
+        ++mSchedulerStats.mTickedControllers;
+
+        if (isOutOfBudget)
+        {
+            ++mSchedulerStats.mOverBudgetControllers;
+        }
+        else if ((gSystem.GetSystemSeconds() - startTime) > budgetSeconds)
+        {
+            isOutOfBudget = true;
+            nextUpdateCursor = iController + 1;
+        }
+    }
+
+    // destroy inactive controllers after whole list is processed,
+    // cursor position becomes inaccurate due to swaps but all controllers will get their turn anyway
+    for (AiCharacterController* currController: mInactiveControllers)
+    {
+        DestroyAiController(currController);
+    }
+    mInactiveControllers.clear();
+    mUpdateCursor = nextUpdateCursor;
+    mSchedulerStats.mUpdateTime = (float) ((gSystem.GetSystemSeconds() - startTime) * 1000.0);
+}
+
+float AiManager::GetControllerUpdateInterval(const AiCharacterController* controller) const
+{
+    if (mPlayersCount == 0)
+        return 0.0f;
+
+    glm::vec2 position = controller->mCharacter->GetPosition2();
+
+    float closestDistance2 = glm::distance2(position, mPlayerPositions[0]);
+    for (int iplayer = 1; iplayer < mPlayersCount; ++iplayer)
+    {
+        closestDistance2 = std::min(closestDistance2, glm::distance2(position, mPlayerPositions[iplayer]));
     }
-    if (hasInactiveControllers)
+
+    if (closestDistance2 <= glm::pow(Convert::MapUnitsToMeters(AiUpdateNearDistance), 2.0f))
+        return 0.0f;
+
+    // drivers need frequent steering even far away
+    if (controller->mCharacter->IsCarDriver() ||
+        closestDistance2 <= glm::pow(Convert::MapUnitsToMeters(AiUpdateMidDistance), 2.0f))
     {
-        cxx::erase_elements(mCharacterControllers, nullptr);
+        return AiUpdateMidInterval;
     }
+
+    return AiUpdateFarInterval;
 }
 
 void AiManager::DebugDraw(DebugRenderer& debugRender)
@@ -42,12 +178,12 @@ void AiManager::DebugDraw(DebugRenderer& debugRender)
 
 void AiManager::ReleaseAiControllers()
 {
-    for (AiCharacterController* currController: mCharacterControllers)
+    while (!mCharacterControllers.empty())
     {
-        delete currController;
+        DestroyAiController(mCharacterControllers.back());
     }
-
-    mCharacterControllers.clear();
+    mInactiveControllers.clear();
+    mUpdateCursor = 0;
 }
 
 AiCharacterController* AiManager::CreateAiController(Pedestrian* pedestrian)
@@ -64,7 +200,8 @@ AiCharacterController* AiManager::CreateAiController(Pedestrian* pedestrian)
         return nullptr;
     }
 
-    AiCharacterController* controller = new AiCharacterController(pedestrian);
+    AiCharacterController* controller = mControllersPool.create(pedestrian);
+    controller->mControllersListIndex = (int) mCharacterControllers.size();
     mCharacterControllers.push_back(controller);
     return controller;
 }
@@ -77,6 +214,19 @@ void AiManager::ReleaseAiController(AiCharacterController* controller)
         return;
     }
 
-    cxx::erase_elements(mCharacterControllers, controller);
-    delete controller;
+    DestroyAiController(controller);
+}
+
+void AiManager::DestroyAiController(AiCharacterController* controller)
+{
+    debug_assert(mCharacterControllers[controller->mControllersListIndex] == controller);
+
+    // move last element into freed position
+    AiCharacterController* lastController = mCharacterControllers.back();
+    lastController->mControllersListIndex = controller->mControllersListIndex;
+    mCharacterControllers[controller->mControllersListIndex] = lastController;
+    mCharacterControllers.pop_back();
+
+    controller->mControllersListIndex = -1;
+    mControllersPool.destroy(controller);
 }
@@ -1,14 +1,46 @@
 #pragma once
 
-class AiCharacterController;
+#include "AiRoadLaneGraph.h"
+#include "AiPathfinder.h"
+#include "AiFlowField.h"
+#include "AiCharacterController.h"
+
 class DebugRenderer;
 
+// ai controllers update statistics info
+struct AiSchedulerStats
+{
+public:
+    AiSchedulerStats() = default;
+    void FrameBegin();
+    void FrameEnd();
+
+public:
+    int mTickedControllers = 0; // controllers updated per frame
+    int mSkippedControllers = 0; // controllers not due or postponed per frame
+    int mOverBudgetControllers = 0; // controllers updated after budget was exhausted per frame
+    float mUpdateTime = 0.0f; // milliseconds spent on controllers update per frame
+};
+
 // Artificial Intelligence manager class
 class AiManager final: public cxx::noncopyable
 {
+    friend class GameCheatsWindow;
+
+public:
+    // readonly
+    AiRoadLaneGraph mRoadLaneGraph;
+    AiPathfinder mPathfinder;
+    AiFlowFieldsCache mFlowFields;
+    AiSchedulerStats mSchedulerStats;
+
 public:
     AiManager();
 
+    // Setup navigation data for current map or release it
+    void EnterWorld();
+    void ClearWorld();
+
     // Update all ai character controllers
     void UpdateFrame();
     void DebugDraw(DebugRenderer& debugRender);
@@ -22,7 +54,22 @@ public:
     void ReleaseAiController(AiCharacterController* controller);
 
 private:
-    std::vector<AiCharacterController*> mCharacterControllers;
+    // get how often controller should be updated depending on distance to closest human player, seconds
+    float GetControllerUpdateInterval(const AiCharacterController* controller) const;
+
+    void UpdateControllers();
+
+    // Remove controller from list by swapping it with last list element and return it to pool
+    void DestroyAiController(AiCharacterController* controller);
+
+private:
+    cxx::object_pool<AiCharacterController> mControllersPool;
+    std::vector<AiCharacterController*> mCharacterControllers; // dense list of all active controllers
+    std::vector<AiCharacterController*> mInactiveControllers; // pending destruction
+    size_t mUpdateCursor = 0; // first controller to process in next frame
+
+    glm::vec2 mPlayerPositions[GAME_MAX_PLAYERS];
+    int mPlayersCount = 0;
 };
 
 extern AiManager gAiManager;
\ No newline at end of file
@@ -0,0 +1,823 @@
+#include "stdafx.h"
+#include "AiPathfinder.h"
+#include "GameMapManager.h"
+#include "cvars.h"
+
+CvarInt gCvarAiPathBudget("ai_pathBudget", 2048, 64, 65536, "Max pathfinding search nodes processed per frame", CvarFlags_Archive);
+CvarInt gCvarAiPathCacheSize("ai_pathCacheSize", 512, 0, 65536, "Max number of cached path segments between portals", CvarFlags_Archive);
+
+//////////////////////////////////////////////////////////////////////////
+
+enum : unsigned char
+{
+    CellFlags_Walkable = BIT(0),
+    CellFlags_Slope = BIT(1),
+};
+
+// test whether pedestrian can walk on map block with specific ground type
+inline bool IsWalkableGround(eGroundType groundType)
+{
+    return (groundType == eGroundType_Pawement) || (groundType == eGroundType_Road) || (groundType == eGroundType_Field);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void AiPathfinderStats::FrameBegin()
+{
+    mProcessedNodes = 0;
+}
+
+void AiPathfinderStats::FrameEnd()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void AiPathfinder::Clear()
+{
+    mCellFlags.clear();
+    mNodes.clear();
+    mEdgesStart.clear();
+    mEdges.clear();
+    mClusterNodesStart.clear();
+    mClusterNodes.clear();
+    mSearchCost.clear();
+    mSearchParent.clear();
+    mSearchStamp.clear();
+    mSearchOpenList.clear();
+    mCurrentSearchStamp = 0;
+    mRequests.clear();
+    mFreeRequestSlots.clear();
+    mPendingRequests.clear();
+    mRequestsQueueFull = false;
+    mSegmentsCache.clear();
+    mSegmentsUsage.clear();
+    mStats = AiPathfinderStats();
+}
+
+void AiPathfinder::BuildFromMap()
+{
+    Clear();
+
+    // collect walkable cells
+    mCellFlags.resize(MAP_LAYERS_COUNT * MAP_DIMENSIONS * MAP_DIMENSIONS, 0);
+    for (int ilayer = 0; ilayer < MAP_LAYERS_COUNT; ++ilayer)
+    for (int iy = 0; iy < MAP_DIMENSIONS; ++iy)
+    for (int ix = 0; ix < MAP_DIMENSIONS; ++ix)
+    {
+        const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(ix, iy, ilayer);
+        if (!IsWalkableGround(blockInfo->mGroundType))
+            continue;
+
+        // ground is covered with another block
+        if (ilayer + 1 < MAP_LAYERS_COUNT)
+        {
+            const MapBlockInfo* upperBlockInfo = gGameMap.GetBlockInfo(ix, iy, ilayer + 1);
+            if (upperBlockInfo->mGroundType != eGroundType_Air)
+                continue;
+        }
+
+        unsigned char cellFlags = CellFlags_Walkable;
+        if (blockInfo->mSlopeType)
+        {
+            cellFlags |= CellFlags_Slope;
+        }
+        mCellFlags[GetCellIndex(ix, iy, ilayer)] = cellFlags;
+    }
+
+    // find all moves between clusters
+    struct Transition
+    {
+        int mClusterA;
+        int mClusterB;
+        int mCellA;
+        int mCellB;
+    };
+    std::vector<Transition> transitions;
+
+    int neighbourCells[4];
+    for (int icell = 0, CellsCount = (int) mCellFlags.size(); icell < CellsCount; ++icell)
+    {
+        if ((mCellFlags[icell] & CellFlags_Walkable) == 0)
+            continue;
+
+        int clusterA = GetCellCluster(icell);
+        for (int ineighbour = 0, NeighboursCount = GetNeighbourCells(icell, neighbourCells);
+            ineighbour < NeighboursCount; ++ineighbour)
+        {
+            int clusterB = GetCellCluster(neighbourCells[ineighbour]);
+            if (clusterA != clusterB)
+            {
+                transitions.push_back({clusterA, clusterB, icell, neighbourCells[ineighbour]});
+            }
+        }
+    }
+
+    std::sort(transitions.begin(), transitions.end(), [](const Transition& lhs, const Transition& rhs)
+    {
+        if (lhs.mClusterA != rhs.mClusterA)
+            return lhs.mClusterA < rhs.mClusterA;
+
+        if (lhs.mClusterB != rhs.mClusterB)
+            return lhs.mClusterB < rhs.mClusterB;
+
+        return lhs.mCellA < rhs.mCellA;
+    });
+
+    // create single portal in the middle of each continuous run of moves along cluster border
+    std::map<int, int> cellNodes;
+    auto GetOrCreateNode = [&cellNodes, this](int cellIndex)
+    {
+        auto found_iterator = cellNodes.find(cellIndex);
+        if (found_iterator != cellNodes.end())
+            return found_iterator->second;
+
+        int nodeIndex = (int) mNodes.size();
+        mNodes.push_back({cellIndex, GetCellCluster(cellIndex)});
+        cellNodes[cellIndex] = nodeIndex;
+        return nodeIndex;
+    };
+
+    std::vector<std::pair<int, AbstractEdge>> edges;
+    for (size_t irun = 0, TransitionsCount = transitions.size(); irun < TransitionsCount; )
+    {
+        size_t irunEnd = irun + 1;
+        for (; irunEnd < TransitionsCount && (irunEnd - irun) < ClusterSize; ++irunEnd)
+        {
+            const Transition& prev = transitions[irunEnd - 1];
+            const Transition& curr = transitions[irunEnd];
+            if (curr.mClusterA != prev.mClusterA || curr.mClusterB != prev.mClusterB)
+                break;
+
+            int deltaA = curr.mCellA - prev.mCellA;
+            int deltaB = curr.mCellB - prev.mCellB;
+            if (deltaA != deltaB || (deltaA != 1 && deltaA != MAP_DIMENSIONS))
+                break;
+        }
+
+        const Transition& portal = transitions[(irun + irunEnd - 1) / 2];
+        int nodeA = GetOrCreateNode(portal.mCellA);
+        int nodeB = GetOrCreateNode(portal.mCellB);
+        edges.push_back({nodeA, {nodeB, 1}});
+        irun = irunEnd;
+    }
+
+    // group portals by clusters
+    const int ClustersCount = MAP_LAYERS_COUNT * ClustersPerSide * ClustersPerSide;
+    mClusterNodesStart.resize(ClustersCount + 1, 0);
+    for (const AbstractNode& currNode: mNodes)
+    {
+        ++mClusterNodesStart[currNode.mCluster + 1];
+    }
+    for (int icluster = 0; icluster < ClustersCount; ++icluster)
+    {
+        mClusterNodesStart[icluster + 1] += mClusterNodesStart[icluster];
+    }
+    mClusterNodes.resize(mNodes.size());
+    {
+        std::vector<int> clusterFillPos (mClusterNodesStart.begin(), mClusterNodesStart.end() - 1);
+        for (int inode = 0, NodesCount = (int) mNodes.size(); inode < NodesCount; ++inode)
+        {
+            mClusterNodes[clusterFillPos[mNodes[inode].mCluster]++] = inode;
+        }
+    }
+
+    // connect portals within each cluster
+    for (int icluster = 0; icluster < ClustersCount; ++icluster)
+    {
+        const int firstNode = mClusterNodesStart[icluster];
+        const int lastNode = mClusterNodesStart[icluster + 1];
+        for (int inodeA = firstNode; inodeA < lastNode; ++inodeA)
+        {
+            int nodeA = mClusterNodes[inodeA];
+            SearchCluster(icluster, mNodes[nodeA].mCell);
+
+            for (int inodeB = firstNode; inodeB < lastNode; ++inodeB)
+            {
+                int nodeB = mClusterNodes[inodeB];
+                int distance = mLocalDistance[GetCellLocalIndex(mNodes[nodeB].mCell)];
+                if (nodeA == nodeB || distance < 0)
+                    continue;
+
+                edges.push_back({nodeA, {nodeB, distance}});
+            }
+        }
+    }
+
+    // pack edges
+    std::sort(edges.begin(), edges.end(), [](const std::pair<int, AbstractEdge>& lhs, const std::pair<int, AbstractEdge>& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+    mEdgesStart.resize(mNodes.size() + 1, 0);
+    mEdges.reserve(edges.size());
+    for (const auto& currEdge: edges)
+    {
+        ++mEdgesStart[currEdge.first + 1];
+        mEdges.push_back(currEdge.second);
+    }
+    for (size_t inode = 0; inode < mNodes.size(); ++inode)
+    {
+        mEdgesStart[inode + 1] += mEdgesStart[inode];
+    }
+
+    // search state includes temporary start and goal nodes
+    mSearchCost.resize(mNodes.size() + 2, 0);
+    mSearchParent.resize(mNodes.size() + 2, -1);
+    mSearchStamp.resize(mNodes.size() + 2, 0);
+
+    gConsole.LogMessage(eLogMessage_Debug, "Pathfinding graph: %d portals, %d edges", (int) mNodes.size(), (int) mEdges.size());
+}
+
+void AiPathfinder::UpdateFrame()
+{
+    mStats.FrameBegin();
+
+    int budget = gCvarAiPathBudget.mValue;
+    while (budget > 0 && !mPendingRequests.empty())
+    {
+        PathRequest* request = GetRequest(mPendingRequests.front());
+        if (request == nullptr || request->mStatus != eAiPathStatus_Pending) // was cancelled
+        {
+            mPendingRequests.pop_front();
+            continue;
+        }
+
+        int spentBudget = ProcessRequest(*request, budget);
+        mStats.mProcessedNodes += spentBudget;
+        budget -= std::max(spentBudget, 1);
+
+        if (request->mStatus == eAiPathStatus_Pending)
+            continue;
+
+        if (request->mStatus == eAiPathStatus_Success)
+        {
+            ++mStats.mCompletedRequests;
+        }
+        else
+        {
+            ++mStats.mFailedRequests;
+        }
+        mPendingRequests.pop_front();
+    }
+
+    mStats.mPendingRequests = (int) mPendingRequests.size();
+    mStats.FrameEnd();
+}
+
+AiPathRequestID AiPathfinder::RequestPath(const glm::ivec3& startBlock, const glm::ivec3& goalBlock)
+{
+    if (mCellFlags.empty())
+        return AiPathRequestID_Null;
+
+    int requestSlot = 0;
+    if (mFreeRequestSlots.empty())
+    {
+        // many characters may request paths at once, caller will retry later
+        if ((int) mRequests.size() >= MaxRequests)
+        {
+            ++mStats.mRejectedRequests;
+            if (!mRequestsQueueFull)
+            {
+                mRequestsQueueFull = true;
+                gConsole.LogMessage(eLogMessage_Warning, "Path requests queue is full (%d requests)", MaxRequests);
+            }
+            return AiPathRequestID_Null;
+        }
+        requestSlot = (int) mRequests.size();
+        mRequests.emplace_back();
+    }
+    else
+    {
+        requestSlot = mFreeRequestSlots.back();
+        mFreeRequestSlots.pop_back();
+    }
+    mRequestsQueueFull = false;
+
+    // high bits hold request serial to detect stale handles
+    if ((++mRequestsCounter & 0xFFFF) == 0)
+    {
+        ++mRequestsCounter;
+    }
+
+    PathRequest& request = mRequests[requestSlot];
+    request.mRequestID = ((mRequestsCounter & 0xFFFF) << 16) | requestSlot;
+    request.mStatus = eAiPathStatus_Pending;
+    request.mPhase = eRequestPhase_Init;
+    request.mStartCell = FindWalkableCell(startBlock);
+    request.mGoalCell = FindWalkableCell(goalBlock);
+    request.mRefineIndex = 0;
+    request.mAbstractPath.clear();
+    request.mPathCells.clear();
+
+    if (request.mStartCell < 0 || request.mGoalCell < 0)
+    {
+        request.mStatus = eAiPathStatus_Failed;
+        ++mStats.mFailedRequests;
+        return request.mRequestID;
+    }
+
+    mPendingRequests.push_back(request.mRequestID);
+    return request.mRequestID;
+}
+
+eAiPathStatus AiPathfinder::GetPathStatus(AiPathRequestID requestID) const
+{
+    const PathRequest* request = GetRequest(requestID);
+    if (request)
+        return request->mStatus;
+
+    return eAiPathStatus_None;
+}
+
+bool AiPathfinder::TakePathResult(AiPathRequestID requestID, std::vector<glm::ivec3>& outputBlocks)
+{
+    outputBlocks.clear();
+
+    PathRequest* request = GetRequest(requestID);
+    if (request == nullptr || request->mStatus == eAiPathStatus_Pending)
+        return false;
+
+    bool isSuccess = (request->mStatus == eAiPathStatus_Success);
+    if (isSuccess)
+    {
+        outputBlocks.reserve(request->mPathCells.size());
+        for (int currCell: request->mPathCells)
+        {
+            outputBlocks.push_back(GetCellBlock(currCell));
+        }
+    }
+    CancelRequest(requestID);
+    return isSuccess;
+}
+
+void AiPathfinder::CancelRequest(AiPathRequestID requestID)
+{
+    PathRequest* request = GetRequest(requestID);
+    if (request == nullptr)
+        return;
+
+    // pending queue entry will be skipped
+    request->mRequestID = AiPathRequestID_Null;
+    request->mStatus = eAiPathStatus_None;
+    mFreeRequestSlots.push_back(requestID & 0xFFFF);
+}
+
+bool AiPathfinder::IsWalkableBlock(const glm::ivec3& mapBlock) const
+{
+    if (mCellFlags.empty())
+        return false;
+
+    if (mapBlock.x < 0 || mapBlock.x >= MAP_DIMENSIONS || mapBlock.z < 0 || mapBlock.z >= MAP_DIMENSIONS ||
+        mapBlock.y < 0 || mapBlock.y >= MAP_LAYERS_COUNT)
+    {
+        return false;
+    }
+
+    return (mCellFlags[GetCellIndex(mapBlock.x, mapBlock.z, mapBlock.y)] & CellFlags_Walkable) > 0;
+}
+
+int AiPathfinder::GetNeighbourCells(int cellIndex, int outputCells[4]) const
+{
+    static const int Offsets[4][2] =
+    {
+        { 0, -1},
+        { 1,  0},
+        { 0,  1},
+        {-1,  0},
+    };
+
+    glm::ivec3 block = GetCellBlock(cellIndex);
+    bool isSlope = (mCellFlags[cellIndex] & CellFlags_Slope) > 0;
+
+    int cellsCount = 0;
+    for (const auto& currOffset: Offsets)
+    {
+        int mapx = block.x + currOffset[0];
+        int mapy = block.z + currOffset[1];
+        if (mapx < 0 || mapx >= MAP_DIMENSIONS || mapy < 0 || mapy >= MAP_DIMENSIONS)
+            continue;
+
+        int sameLayerCell = GetCellIndex(mapx, mapy, block.y);
+        if (mCellFlags[sameLayerCell] & CellFlags_Walkable)
+        {
+            outputCells[cellsCount++] = sameLayerCell;
+            continue;
+        }
+
+        // slopes are linking neighbour layers
+        for (int mapLayer: { block.y + 1, block.y - 1 })
+        {
+            if (mapLayer < 0 || mapLayer >= MAP_LAYERS_COUNT)
+                continue;
+
+            int otherLayerCell = GetCellIndex(mapx, mapy, mapLayer);
+            unsigned char otherCellFlags = mCellFlags[otherLayerCell];
+            if ((otherCellFlags & CellFlags_Walkable) && (isSlope || (otherCellFlags & CellFlags_Slope)))
+            {
+                outputCells[cellsCount++] = otherLayerCell;
+                break;
+            }
+        }
+    }
+    return cellsCount;
+}
+
+int AiPathfinder::FindWalkableCell(const glm::ivec3& mapBlock) const
+{
+    if (mapBlock.x < 0 || mapBlock.x >= MAP_DIMENSIONS || mapBlock.z < 0 || mapBlock.z >= MAP_DIMENSIONS)
+        return -1;
+
+    // find closest walkable layer
+    for (int layerDistance = 0; layerDistance < MAP_LAYERS_COUNT; ++layerDistance)
+    {
+        for (int mapLayer: { mapBlock.y - layerDistance, mapBlock.y + layerDistance })
+        {
+            if (mapLayer < 0 || mapLayer >= MAP_LAYERS_COUNT)
+                continue;
+
+            int cellIndex = GetCellIndex(mapBlock.x, mapBlock.z, mapLayer);
+            if (mCellFlags[cellIndex] & CellFlags_Walkable)
+                return cellIndex;
+        }
+    }
+    return -1;
+}
+
+int AiPathfinder::GetHeuristicCost(int cellA, int cellB) const
+{
+    glm::ivec3 blockA = GetCellBlock(cellA);
+    glm::ivec3 blockB = GetCellBlock(cellB);
+    return std::abs(blockA.x - blockB.x) + std::abs(blockA.y - blockB.y) + std::abs(blockA.z - blockB.z);
+}
+
+int AiPathfinder::SearchCluster(int clusterIndex, int startCell)
+{
+    for (int& currDistance: mLocalDistance)
+    {
+        currDistance = -1;
+    }
+
+    int queueHead = 0;
+    int queueTail = 0;
+    mLocalDistance[GetCellLocalIndex(startCell)] = 0;
+    mLocalQueue[queueTail++] = startCell;
+
+    int neighbourCells[4];
+    while (queueHead < queueTail)
+    {
+        int currCell = mLocalQueue[queueHead++];
+        int currDistance = mLocalDistance[GetCellLocalIndex(currCell)];
+
+        for (int ineighbour = 0, NeighboursCount = GetNeighbourCells(currCell, neighbourCells);
+            ineighbour < NeighboursCount; ++ineighbour)
+        {
+            int neighbourCell = neighbourCells[ineighbour];
+            if (GetCellCluster(neighbourCell) != clusterIndex)
+                continue;
+
+            int localIndex = GetCellLocalIndex(neighbourCell);
+            if (mLocalDistance[localIndex] >= 0)
+                continue;
+
+            mLocalDistance[localIndex] = currDistance + 1;
+            mLocalQueue[queueTail++] = neighbourCell;
+        }
+    }
+    return queueTail;
+}
+
+bool AiPathfinder::ExtractClusterPath(int clusterIndex, int startCell, std::vector<int>& outputCells) const
+{
+    int currCell = startCell;
+    int currDistance = mLocalDistance[GetCellLocalIndex(currCell)];
+    if (currDistance < 0) // unreachable
+        return false;
+
+    int neighbourCells[4];
+    while (currDistance > 0)
+    {
+        int nextCell = -1;
+        for (int ineighbour = 0, NeighboursCount = GetNeighbourCells(currCell, neighbourCells);
+            ineighbour < NeighboursCount; ++ineighbour)
+        {
+            int neighbourCell = neighbourCells[ineighbour];
+            if (GetCellCluster(neighbourCell) != clusterIndex)
+                continue;
+
+            if (mLocalDistance[GetCellLocalIndex(neighbourCell)] == (currDistance - 1))
+            {
+                nextCell = neighbourCell;
+                break;
+            }
+        }
+
+        if (nextCell == -1)
+        {
+            debug_assert(false);
+            return false;
+        }
+
+        outputCells.push_back(nextCell);
+        currCell = nextCell;
+        --currDistance;
+    }
+    return true;
+}
+
+int AiPathfinder::ProcessRequest(PathRequest& request, int budget)
+{
+    int spentBudget = 0;
+    while (spentBudget < budget && request.mStatus == eAiPathStatus_Pending)
+    {
+        switch (request.mPhase)
+        {
+            case eRequestPhase_Init:
+                spentBudget += ProcessRequestInit(request);
+            break;
+            case eRequestPhase_Search:
+                spentBudget += ProcessRequestSearch(request, budget - spentBudget);
+            break;
+            case eRequestPhase_Refine:
+                spentBudget += ProcessRequestRefine(request, budget - spentBudget);
+            break;
+        }
+    }
+    return spentBudget;
+}
+
+int AiPathfinder::ProcessRequestInit(PathRequest& request)
+{
+    if (request.mStartCell == request.mGoalCell)
+    {
+        request.mStatus = eAiPathStatus_Success;
+        return 1;
+    }
+
+    const int startCluster = GetCellCluster(request.mStartCell);
+    const int goalCluster = GetCellCluster(request.mGoalCell);
+
+    int spentBudget = SearchCluster(goalCluster, request.mGoalCell);
+
+    // try direct path within cluster first
+    if (startCluster == goalCluster && ExtractClusterPath(goalCluster, request.mStartCell, request.mPathCells))
+    {
+        request.mStatus = eAiPathStatus_Success;
+        return spentBudget;
+    }
+
+    // connect goal and start to portals
+    mGoalEdges.clear();
+    for (int inode = mClusterNodesStart[goalCluster]; inode < mClusterNodesStart[goalCluster + 1]; ++inode)
+    {
+        int distance = mLocalDistance[GetCellLocalIndex(mNodes[mClusterNodes[inode]].mCell)];
+        if (distance >= 0)
+        {
+            mGoalEdges.push_back({mClusterNodes[inode], distance});
+        }
+    }
+
+    spentBudget += SearchCluster(startCluster, request.mStartCell);
+
+    mStartEdges.clear();
+    for (int inode = mClusterNodesStart[startCluster]; inode < mClusterNodesStart[startCluster + 1]; ++inode)
+    {
+        int distance = mLocalDistance[GetCellLocalIndex(mNodes[mClusterNodes[inode]].mCell)];
+        if (distance >= 0)
+        {
+            mStartEdges.push_back({mClusterNodes[inode], distance});
+        }
+    }
+
+    if (mStartEdges.empty() || mGoalEdges.empty())
+    {
+        request.mStatus = eAiPathStatus_Failed;
+        return spentBudget;
+    }
+
+    // setup portals graph search
+    if (++mCurrentSearchStamp == 0)
+    {
+        std::fill(mSearchStamp.begin(), mSearchStamp.end(), 0);
+        mCurrentSearchStamp = 1;
+    }
+
+    const int startNode = (int) mNodes.size();
+    mSearchStamp[startNode] = mCurrentSearchStamp;
+    mSearchCost[startNode] = 0;
+    mSearchParent[startNode] = -1;
+    mSearchOpenList.clear();
+    mSearchOpenList.emplace_back(GetHeuristicCost(request.mStartCell, request.mGoalCell), startNode);
+
+    request.mPhase = eRequestPhase_Search;
+    return spentBudget;
+}
+
+int AiPathfinder::ProcessRequestSearch(PathRequest& request, int budget)
+{
+    const int startNode = (int) mNodes.size();
+    const int goalNode = startNode + 1;
+    const int goalCluster = GetCellCluster(request.mGoalCell);
+
+    auto GetNodeCell = [&request, startNode, goalNode, this](int nodeIndex)
+    {
+        if (nodeIndex == startNode)
+            return request.mStartCell;
+
+        if (nodeIndex == goalNode)
+            return request.mGoalCell;
+
+        return mNodes[nodeIndex].mCell;
+    };
+
+    auto VisitNode = [&request, &GetNodeCell, this](int nodeIndex, int parentNode, int nodeCost)
+    {
+        if (mSearchStamp[nodeIndex] == mCurrentSearchStamp && mSearchCost[nodeIndex] <= nodeCost)
+            return;
+
+        mSearchStamp[nodeIndex] = mCurrentSearchStamp;
+        mSearchCost[nodeIndex] = nodeCost;
+        mSearchParent[nodeIndex] = parentNode;
+
+        int estimatedCost = nodeCost + GetHeuristicCost(GetNodeCell(nodeIndex), request.mGoalCell);
+        mSearchOpenList.emplace_back(estimatedCost, nodeIndex);
+        std::push_heap(mSearchOpenList.begin(), mSearchOpenList.end(), std::greater<std::pair<int, int>>());
+    };
+
+    int spentBudget = 0;
+    while (spentBudget < budget)
+    {
+        if (mSearchOpenList.empty())
+        {
+            request.mStatus = eAiPathStatus_Failed;
+            return spentBudget;
+        }
+
+        std::pop_heap(mSearchOpenList.begin(), mSearchOpenList.end(), std::greater<std::pair<int, int>>());
+        std::pair<int, int> currEntry = mSearchOpenList.back();
+        mSearchOpenList.pop_back();
+
+        const int currNode = currEntry.second;
+        const int currCost = mSearchCost[currNode];
+
+        // node was reached again with lower cost
+        if (currEntry.first != currCost + GetHeuristicCost(GetNodeCell(currNode), request.mGoalCell))
+            continue;
+
+        ++spentBudget;
+
+        if (currNode == goalNode)
+        {
+            request.mAbstractPath.clear();
+            for (int nodeIndex = goalNode; nodeIndex != -1; nodeIndex = mSearchParent[nodeIndex])
+            {
+                request.mAbstractPath.push_back(nodeIndex);
+            }
+            std::reverse(request.mAbstractPath.begin(), request.mAbstractPath.end());
+            request.mRefineIndex = 0;
+            request.mPhase = eRequestPhase_Refine;
+            return spentBudget;
+        }
+
+        if (currNode == startNode)
+        {
+            for (const AbstractEdge& currEdge: mStartEdges)
+            {
+                VisitNode(currEdge.mTargetNode, currNode, currCost + currEdge.mCost);
+            }
+            continue;
+        }
+
+        for (int iedge = mEdgesStart[currNode]; iedge < mEdgesStart[currNode + 1]; ++iedge)
+        {
+            VisitNode(mEdges[iedge].mTargetNode, currNode, currCost + mEdges[iedge].mCost);
+        }
+
+        if (mNodes[currNode].mCluster == goalCluster)
+        {
+            for (const AbstractEdge& currEdge: mGoalEdges)
+            {
+                if (currEdge.mTargetNode == currNode)
+                {
+                    VisitNode(goalNode, currNode, currCost + currEdge.mCost);
+                    break;
+                }
+            }
+        }
+    }
+    return spentBudget;
+}
+
+int AiPathfinder::ProcessRequestRefine(PathRequest& request, int budget)
+{
+    const int startNode = (int) mNodes.size();
+    const int goalNode = startNode + 1;
+
+    int spentBudget = 0;
+    for (; spentBudget < budget && (request.mRefineIndex + 1) < (int) request.mAbstractPath.size(); ++request.mRefineIndex)
+    {
+        int nodeA = request.mAbstractPath[request.mRefineIndex];
+        int nodeB = request.mAbstractPath[request.mRefineIndex + 1];
+
+        int cellA = (nodeA == startNode) ? request.mStartCell : mNodes[nodeA].mCell;
+        int cellB = (nodeB == goalNode) ? request.mGoalCell : mNodes[nodeB].mCell;
+
+        int clusterA = GetCellCluster(cellA);
+        if (clusterA != GetCellCluster(cellB))
+        {
+            // move between portals of neighbour clusters
+            request.mPathCells.push_back(cellB);
+            ++spentBudget;
+            continue;
+        }
+
+        if (nodeA != startNode && nodeB != goalNode)
+        {
+            const std::vector<int>* segmentCells = GetCachedSegment(nodeA, nodeB, spentBudget);
+            if (segmentCells == nullptr)
+            {
+                request.mStatus = eAiPathStatus_Failed;
+                return spentBudget;
+            }
+            request.mPathCells.insert(request.mPathCells.end(), segmentCells->begin(), segmentCells->end());
+            continue;
+        }
+
+        spentBudget += SearchCluster(clusterA, cellB);
+        if (!ExtractClusterPath(clusterA, cellA, request.mPathCells))
+        {
+            request.mStatus = eAiPathStatus_Failed;
+            return spentBudget;
+        }
+    }
+
+    if ((request.mRefineIndex + 1) >= (int) request.mAbstractPath.size())
+    {
+        request.mStatus = eAiPathStatus_Success;
+    }
+    return spentBudget;
+}
+
+AiPathfinder::PathRequest* AiPathfinder::GetRequest(AiPathRequestID requestID)
+{
+    int requestSlot = requestID & 0xFFFF;
+    if (requestID == AiPathRequestID_Null || requestSlot >= (int) mRequests.size())
+        return nullptr;
+
+    if (mRequests[requestSlot].mRequestID != requestID)
+        return nullptr;
+
+    return &mRequests[requestSlot];
+}
+
+const AiPathfinder::PathRequest* AiPathfinder::GetRequest(AiPathRequestID requestID) const
+{
+    int requestSlot = requestID & 0xFFFF;
+    if (requestID == AiPathRequestID_Null || requestSlot >= (int) mRequests.size())
+        return nullptr;
+
+    if (mRequests[requestSlot].mRequestID != requestID)
+        return nullptr;
+
+    return &mRequests[requestSlot];
+}
+
+const std::vector<int>* AiPathfinder::GetCachedSegment(int nodeA, int nodeB, int& spentBudget)
+{
+    unsigned long long segmentKey = (static_cast<unsigned long long>(nodeA) << 32) | static_cast<unsigned int>(nodeB);
+
+    auto found_iterator = mSegmentsCache.find(segmentKey);
+    if (found_iterator != mSegmentsCache.end())
+    {
+        ++mStats.mCacheHits;
+        ++spentBudget;
+        mSegmentsUsage.splice(mSegmentsUsage.begin(), mSegmentsUsage, found_iterator->second.mUsageIterator);
+        return &found_iterator->second.mCells;
+    }
+
+    ++mStats.mCacheMisses;
+
+    const int clusterIndex = mNodes[nodeA].mCluster;
+    spentBudget += SearchCluster(clusterIndex, mNodes[nodeB].mCell);
+
+    mUncachedSegment.clear();
+    if (!ExtractClusterPath(clusterIndex, mNodes[nodeA].mCell, mUncachedSegment))
+        return nullptr;
+
+    if (gCvarAiPathCacheSize.mValue < 1)
+        return &mUncachedSegment;
+
+    // evict least recently used segment
+    while ((int) mSegmentsCache.size() >= gCvarAiPathCacheSize.mValue)
+    {
+        mSegmentsCache.erase(mSegmentsUsage.back());
+        mSegmentsUsage.pop_back();
+    }
+
+    mSegmentsUsage.push_front(segmentKey);
+
+    CachedSegment& cachedSegment = mSegmentsCache[segmentKey];
+    cachedSegment.mCells.swap(mUncachedSegment);
+    cachedSegment.mUsageIterator = mSegmentsUsage.begin();
+    return &cachedSegment.mCells;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "GameDefs.h"
+
+enum eAiPathStatus
+{
+    eAiPathStatus_None, // request is unknown or already released
+    eAiPathStatus_Pending,
+    eAiPathStatus_Success,
+    eAiPathStatus_Failed,
+};
+
+// path request handle, zero is null
+using AiPathRequestID = unsigned int;
+
+const AiPathRequestID AiPathRequestID_Null = 0;
+
+// pathfinding statistics info
+struct AiPathfinderStats
+{
+public:
+    AiPathfinderStats() = default;
+    void FrameBegin();
+    void FrameEnd();
+
+public:
+    int mPendingRequests = 0; // requests in queue
+    int mProcessedNodes = 0; // search nodes processed per frame
+    int mCompletedRequests = 0; // total
+    int mFailedRequests = 0; // total
+    int mRejectedRequests = 0; // total, requests queue was full
+    int mCacheHits = 0; // total
+    int mCacheMisses = 0; // total
+};
+
+// Hierarchical pathfinding over map blocks grid
+// Each map layer is split into clusters of blocks connected with portals on their borders or along slopes,
+// path gets searched on portals graph first and then refined block by block within clusters
+// Requests are processed in background within limited number of search nodes per frame
+class AiPathfinder final: public cxx::noncopyable
+{
+public:
+    // readonly
+    AiPathfinderStats mStats;
+
+public:
+    // Scan current map and generate navigation data
+    void BuildFromMap();
+    void Clear();
+
+    // Process pending requests within frame budget
+    void UpdateFrame();
+
+    // Register new path request, result will be available on later frames
+    // @param startBlock, goalBlock: Map block coordinates, where y is map layer
+    AiPathRequestID RequestPath(const glm::ivec3& startBlock, const glm::ivec3& goalBlock);
+
+    // Get current state of path request
+    eAiPathStatus GetPathStatus(AiPathRequestID requestID) const;
+
+    // Get path blocks of completed request and release it
+    // @param outputBlocks: Path blocks excluding start block, where y is map layer
+    bool TakePathResult(AiPathRequestID requestID, std::vector<glm::ivec3>& outputBlocks);
+
+    // Release path request in any state
+    void CancelRequest(AiPathRequestID requestID);
+
+    // Test whether pedestrian can walk on map block
+    // @param mapBlock: Map block coordinate, where y is map layer
+    bool IsWalkableBlock(const glm::ivec3& mapBlock) const;
+
+private:
+    static const int ClusterSize = 16; // blocks
+    static const int ClustersPerSide = MAP_DIMENSIONS / ClusterSize;
+    static const int ClusterCellsCount = ClusterSize * ClusterSize;
+    static const int MaxRequests = 1024;
+
+    enum eRequestPhase
+    {
+        eRequestPhase_Init,
+        eRequestPhase_Search,
+        eRequestPhase_Refine,
+    };
+
+    struct PathRequest
+    {
+    public:
+        AiPathRequestID mRequestID = AiPathRequestID_Null;
+        eAiPathStatus mStatus = eAiPathStatus_None;
+        eRequestPhase mPhase = eRequestPhase_Init;
+        int mStartCell = 0;
+        int mGoalCell = 0;
+        int mRefineIndex = 0;
+        std::vector<int> mAbstractPath; // portal nodes from start to goal
+        std::vector<int> mPathCells;
+    };
+
+    struct AbstractNode
+    {
+    public:
+        int mCell;
+        int mCluster;
+    };
+
+    struct AbstractEdge
+    {
+    public:
+        int mTargetNode;
+        int mCost;
+    };
+
+    struct CachedSegment
+    {
+    public:
+        std::vector<int> mCells;
+        std::list<unsigned long long>::iterator mUsageIterator; // position in usage list
+    };
+
+private:
+    // cells helpers
+    inline int GetCellIndex(int mapx, int mapy, int mapLayer) const
+    {
+        return (mapLayer * MAP_DIMENSIONS + mapy) * MAP_DIMENSIONS + mapx;
+    }
+    inline glm::ivec3 GetCellBlock(int cellIndex) const
+    {
+        return { cellIndex % MAP_DIMENSIONS, cellIndex / (MAP_DIMENSIONS * MAP_DIMENSIONS), (cellIndex / MAP_DIMENSIONS) % MAP_DIMENSIONS };
+    }
+    inline int GetCellCluster(int cellIndex) const
+    {
+        glm::ivec3 block = GetCellBlock(cellIndex);
+        return (block.y * ClustersPerSide + block.z / ClusterSize) * ClustersPerSide + block.x / ClusterSize;
+    }
+    inline int GetCellLocalIndex(int cellIndex) const
+    {
+        glm::ivec3 block = GetCellBlock(cellIndex);
+        return (block.z % ClusterSize) * ClusterSize + (block.x % ClusterSize);
+    }
+    int GetNeighbourCells(int cellIndex, int outputCells[4]) const;
+    int FindWalkableCell(const glm::ivec3& mapBlock) const;
+    int GetHeuristicCost(int cellA, int cellB) const;
+
+    // breadth first search within cluster from specified cell, fills local distances
+    // @returns number of visited cells
+    int SearchCluster(int clusterIndex, int startCell);
+    // build path to cluster search start cell using current local distances, start cell is excluded
+    bool ExtractClusterPath(int clusterIndex, int startCell, std::vector<int>& outputCells) const;
+
+    // requests processing, returns amount of spent budget
+    int ProcessRequest(PathRequest& request, int budget);
+    int ProcessRequestInit(PathRequest& request);
+    int ProcessRequestSearch(PathRequest& request, int budget);
+    int ProcessRequestRefine(PathRequest& request, int budget);
+
+    PathRequest* GetRequest(AiPathRequestID requestID);
+    const PathRequest* GetRequest(AiPathRequestID requestID) const;
+
+    // get refined path between two portals of same cluster
+    const std::vector<int>* GetCachedSegment(int nodeA, int nodeB, int& spentBudget);
+
+private:
+    std::vector<unsigned char> mCellFlags;
+
+    // portals graph
+    std::vector<AbstractNode> mNodes;
+    std::vector<int> mEdgesStart; // first edge index for each node, last element is total edges count
+    std::vector<AbstractEdge> mEdges;
+    std::vector<int> mClusterNodesStart; // first node for each cluster within cluster nodes list
+    std::vector<int> mClusterNodes;
+
+    // search state
+    std::vector<int> mSearchCost;
+    std::vector<int> mSearchParent;
+    std::vector<unsigned int> mSearchStamp;
+    std::vector<std::pair<int, int>> mSearchOpenList; // cost and node
+    unsigned int mCurrentSearchStamp = 0;
+    int mLocalDistance[ClusterCellsCount];
+    int mLocalQueue[ClusterCellsCount];
+    std::vector<AbstractEdge> mStartEdges; // temporary start node edges to portals of its cluster
+    std::vector<AbstractEdge> mGoalEdges; // temporary goal node edges, target is portal node which leads to goal
+
+    // requests
+    std::vector<PathRequest> mRequests;
+    std::vector<int> mFreeRequestSlots;
+    std::deque<AiPathRequestID> mPendingRequests;
+    unsigned int mRequestsCounter = 0;
+    bool mRequestsQueueFull = false; // to report overflow once
+
+    // refined segments between portals
+    std::unordered_map<unsigned long long, CachedSegment> mSegmentsCache;
+    std::list<unsigned long long> mSegmentsUsage; // keys of cached segments, most recently used first
+    std::vector<int> mUncachedSegment;
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+#include "AiRoadLaneGraph.h"
+#include "GameMapManager.h"
+
+// test whether car can drive through map block
+inline bool IsDrivableRoadBlock(const MapBlockInfo* blockInfo)
+{
+    if (blockInfo->mGroundType != eGroundType_Road)
+        return false;
+
+    return blockInfo->mUpDirection || blockInfo->mDownDirection ||
+        blockInfo->mLeftDirection || blockInfo->mRightDirection;
+}
+
+void AiRoadLaneGraph::Clear()
+{
+    mNodes.clear();
+    mEdgesStart.clear();
+    mEdges.clear();
+    mColumnsStart.clear();
+}
+
+void AiRoadLaneGraph::BuildFromMap()
+{
+    Clear();
+
+    // collect nodes
+    mColumnsStart.resize(MAP_DIMENSIONS * MAP_DIMENSIONS + 1);
+    for (int iy = 0; iy < MAP_DIMENSIONS; ++iy)
+    for (int ix = 0; ix < MAP_DIMENSIONS; ++ix)
+    {
+        mColumnsStart[iy * MAP_DIMENSIONS + ix] = (int) mNodes.size();
+        for (int iz = 0; iz < MAP_LAYERS_COUNT; ++iz)
+        {
+            const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(ix, iy, iz);
+            if (!IsDrivableRoadBlock(blockInfo))
+                continue;
+
+            LaneNode laneNode;
+            laneNode.mMapX = ix;
+            laneNode.mMapY = iy;
+            laneNode.mMapLayer = iz;
+            mNodes.push_back(laneNode);
+        }
+    }
+    mColumnsStart[MAP_DIMENSIONS * MAP_DIMENSIONS] = (int) mNodes.size();
+
+    // collect edges
+    mEdgesStart.resize(mNodes.size() + 1);
+    for (int inode = 0, NodesCount = (int) mNodes.size(); inode < NodesCount; ++inode)
+    {
+        mEdgesStart[inode] = (int) mEdges.size();
+
+        const LaneNode& laneNode = mNodes[inode];
+        const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(laneNode.mMapX, laneNode.mMapY, laneNode.mMapLayer);
+
+        const struct
+        {
+            bool mEnabled;
+            int mOffsetX;
+            int mOffsetY;
+        }
+        directions[] =
+        {
+            { blockInfo->mUpDirection,     0, -1 },
+            { blockInfo->mRightDirection,  1,  0 },
+            { blockInfo->mDownDirection,   0,  1 },
+            { blockInfo->mLeftDirection,  -1,  0 },
+        };
+
+        for (const auto& currDirection: directions)
+        {
+            if (!currDirection.mEnabled)
+                continue;
+
+            int mapx = laneNode.mMapX + currDirection.mOffsetX;
+            int mapy = laneNode.mMapY + currDirection.mOffsetY;
+            if (mapx < 0 || mapx >= MAP_DIMENSIONS || mapy < 0 || mapy >= MAP_DIMENSIONS)
+                continue;
+
+            // road can go up or down along slopes
+            int targetNode = InvalidNodeIndex;
+            for (int ilayer: { laneNode.mMapLayer + 0, laneNode.mMapLayer + 1, laneNode.mMapLayer - 1 })
+            {
+                if (ilayer < 0 || ilayer >= MAP_LAYERS_COUNT)
+                    continue;
+
+                for (int icurr = mColumnsStart[mapy * MAP_DIMENSIONS + mapx],
+                    iend = mColumnsStart[mapy * MAP_DIMENSIONS + mapx + 1]; icurr < iend; ++icurr)
+                {
+                    if (mNodes[icurr].mMapLayer == ilayer)
+                    {
+                        targetNode = icurr;
+                        break;
+                    }
+                }
+
+                if (targetNode != InvalidNodeIndex)
+                    break;
+            }
+
+            if (targetNode != InvalidNodeIndex)
+            {
+                mEdges.push_back(targetNode);
+            }
+        }
+    }
+    mEdgesStart[mNodes.size()] = (int) mEdges.size();
+
+    gConsole.LogMessage(eLogMessage_Debug, "Road lanes graph: %d nodes, %d edges", (int) mNodes.size(), (int) mEdges.size());
+}
+
+int AiRoadLaneGraph::GetNodeIndex(int mapx, int mapy, int mapLayer) const
+{
+    if (mColumnsStart.empty())
+        return InvalidNodeIndex;
+
+    if (mapx < 0 || mapx >= MAP_DIMENSIONS || mapy < 0 || mapy >= MAP_DIMENSIONS)
+        return InvalidNodeIndex;
+
+    int bestNode = InvalidNodeIndex;
+    int bestLayerDistance = MAP_LAYERS_COUNT;
+    for (int icurr = mColumnsStart[mapy * MAP_DIMENSIONS + mapx],
+        iend = mColumnsStart[mapy * MAP_DIMENSIONS + mapx + 1]; icurr < iend; ++icurr)
+    {
+        int layerDistance = std::abs(mNodes[icurr].mMapLayer - mapLayer);
+        if (layerDistance < bestLayerDistance)
+        {
+            bestLayerDistance = layerDistance;
+            bestNode = icurr;
+        }
+    }
+    return bestNode;
+}
+
+glm::vec2 AiRoadLaneGraph::GetNodePosition2(int nodeIndex) const
+{
+    debug_assert(nodeIndex >= 0 && nodeIndex < (int) mNodes.size());
+
+    const LaneNode& laneNode = mNodes[nodeIndex];
+    glm::vec2 position (
+        Convert::MapUnitsToMeters(laneNode.mMapX + 0.5f),
+        Convert::MapUnitsToMeters(laneNode.mMapY + 0.5f));
+    return position;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GameDefs.h"
+
+// Directed graph of road lanes built from map blocks traffic directions, used by ai drivers
+// Nodes are drivable road blocks and edges are allowed moves to neighbour blocks,
+// both stored in flat arrays (compressed sparse rows) which are built once per map
+class AiRoadLaneGraph final: public cxx::noncopyable
+{
+public:
+    static const int InvalidNodeIndex = -1;
+
+    // road block info
+    struct LaneNode
+    {
+    public:
+        unsigned char mMapX;
+        unsigned char mMapY;
+        unsigned char mMapLayer;
+    };
+
+public:
+    // readonly
+    std::vector<LaneNode> mNodes; // sorted by map row, column and then layer
+    std::vector<int> mEdgesStart; // first edge index for each node, last element is total edges count
+    std::vector<int> mEdges; // target node indices
+
+public:
+    // Scan current map and generate lanes graph
+    void BuildFromMap();
+    void Clear();
+
+    // Find road node at specified map location
+    // @param mapx, mapy: Map block coordinate
+    // @param mapLayer: Map layer, closest layer within column will be used if there is no exact match
+    // @returns InvalidNodeIndex if there is no road at location
+    int GetNodeIndex(int mapx, int mapy, int mapLayer) const;
+
+    // Get node block center point, meters
+    glm::vec2 GetNodePosition2(int nodeIndex) const;
+
+    // Get outgoing edges of node
+    inline const int* GetNodeEdges(int nodeIndex) const
+    {
+        debug_assert(nodeIndex >= 0 && nodeIndex < (int) mNodes.size());
+        return mEdges.data() + mEdgesStart[nodeIndex];
+    }
+    inline int GetNodeEdgesCount(int nodeIndex) const
+    {
+        debug_assert(nodeIndex >= 0 && nodeIndex < (int) mNodes.size());
+        return mEdgesStart[nodeIndex + 1] - mEdgesStart[nodeIndex];
+    }
+
+private:
+    // first node index for each map column, last element is total nodes count
+    std::vector<int> mColumnsStart;
+};
\ No newline at end of file
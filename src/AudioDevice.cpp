@@ -194,54 +194,74 @@ void AudioDevice::DestroyAudioListener(AudioListener* audioListener)
     }
 }
 
-void AudioDevice::UpdateFrame()
+void AudioDevice::UpdateFrame(const std::vector<glm::vec3>& listenersPositions)
 {
     if (IsInitialized())
     {
-        UpdateSourcesPositions();
+        UpdateSourcesPositions(listenersPositions);
     }
 }
 
-void AudioDevice::UpdateSourcesPositions()
+void AudioDevice::UpdateSourcesPositions(const std::vector<glm::vec3>& listenersPositions)
 {
+    // detect listeners movement
+    bool listenersChanged = (mListenersPositions.size() != listenersPositions.size());
+    mListenersPositions.resize(listenersPositions.size());
+    for (size_t ilistener = 0; ilistener < listenersPositions.size(); ++ilistener)
+    {
+        const glm::vec3& listenerPosition = listenersPositions[ilistener];
+        if (mListenersPositions[ilistener] != listenerPosition)
+        {
+            mListenersPositions[ilistener] = listenerPosition;
+            listenersChanged = true;
+        }
+    }
+
     for (AudioSource* currSource: mAllSources)
     {
-        if (!currSource->IsPlaying())
+        if (!currSource->mStarted)
             continue;
 
+        // relative position is only changed when source or any of listeners moves
+        if (!listenersChanged && !currSource->mPositionDirty)
+            continue;
+
+        currSource->mPositionDirty = false;
+
         const glm::vec3& sourceLocation = currSource->mSourceLocation;
 
-        AudioListener* nearestListener = nullptr;
-        float distanceToListener2 = 0.0f;
         // find the nearest listener
-        for (AudioListener* currListener: mAllListeners)
+        glm::vec3 listenerLocation {0.0f, 0.0f, 1.0f};
+        float distanceToListener2 = FLT_MAX;
+        for (const glm::vec3& currListenerPosition: mListenersPositions)
         {
-            if (nearestListener == nullptr)
-            {
-                nearestListener = currListener;
-                distanceToListener2 = glm::distance2(sourceLocation, currListener->mPosition);
-                continue;
-            }
-            float dist2 = glm::distance2(sourceLocation, currListener->mPosition);
+            float dist2 = glm::distance2(sourceLocation, currListenerPosition);
             if (dist2 < distanceToListener2)
             {
-                nearestListener = currListener;
+                listenerLocation = currListenerPosition;
                 distanceToListener2 = dist2;
             }
         }
 
-        glm::vec3 listenerLocation {0.0f, 0.0f, 1.0f};
-        if (nearestListener)
+        // relative position
+        glm::vec3 relativePosition (sourceLocation.x - listenerLocation.x, sourceLocation.y, sourceLocation.z - listenerLocation.z);
+
+        // source is silent when it is too far, horizontal distance is less than actual,
+        // park it at max distance where clamped distance model mutes it, so that openal
+        // doesn't keep last audible position and further movement out of range costs nothing
+        float horizontalDistance2 = (relativePosition.x * relativePosition.x) + (relativePosition.z * relativePosition.z);
+        if (horizontalDistance2 >= (currSource->mMaxDistance * currSource->mMaxDistance))
         {
-            listenerLocation = nearestListener->mPosition;
+            relativePosition = glm::vec3(0.0f, 0.0f, currSource->mMaxDistance);
         }
 
-        // relative position
-        float posx = sourceLocation.x - listenerLocation.x;
-        float posz = sourceLocation.z - listenerLocation.z;
+        if (relativePosition == currSource->mAppliedPosition)
+            continue;
 
-        ::alSource3f(currSource->mSourceID, AL_POSITION, posx, sourceLocation.y, posz);
+        ::alSource3f(currSource->mSourceID, AL_POSITION, relativePosition.x, relativePosition.y, relativePosition.z);
         alCheckError();
+
+        currSource->mAppliedPosition = relativePosition;
     }
 }
 
@@ -20,7 +20,8 @@ public:
     bool IsInitialized() const;
 
     // Update active audio sources
-    void UpdateFrame();
+    // @param listenersPositions: Current listeners positions, could be called from audio thread
+    void UpdateFrame(const std::vector<glm::vec3>& listenersPositions);
 
     // Setup device params
     bool SetMasterVolume(float gainValue);
@@ -31,6 +32,9 @@ public:
     // Destroy virtual audio listener instance
     void DestroyAudioListener(AudioListener* audioListener);
 
+    // Get all currently existing audio listeners
+    inline const std::vector<AudioListener*>& GetAudioListeners() const { return mAllListeners; }
+
     // Create audio buffer instance
     AudioBuffer* CreateAudioBuffer(int sampleRate, int bitsPerSample, int channelsCount, int dataLength, const void* bufferData);
     AudioBuffer* CreateAudioBuffer();
@@ -48,7 +52,7 @@ public:
 
 private:
     void QueryAudioDeviceCaps();
-    void UpdateSourcesPositions();
+    void UpdateSourcesPositions(const std::vector<glm::vec3>& listenersPositions);
 
 private:
     ALCcontext* mContext = nullptr;
@@ -57,6 +61,8 @@ private:
     std::vector<AudioListener*> mAllListeners;
     std::vector<AudioSource*> mAllSources;
     std::vector<AudioBuffer*> mAllBuffers;
+    // listeners positions on last sources update
+    std::vector<glm::vec3> mListenersPositions;
     // objects pools
     cxx::object_pool<AudioBuffer> mBuffersPool;
     cxx::object_pool<AudioSource> mSourcesPool;
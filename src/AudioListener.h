@@ -20,6 +20,10 @@ public:
         mPosition.x = position.x;
         mPosition.y = position.y;
     }
+    const glm::vec3& GetPosition() const
+    {
+        return mPosition;
+    }
 private:
     glm::vec3 mPosition;
 };
\ No newline at end of file
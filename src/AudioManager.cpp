@@ -3,11 +3,26 @@
 #include "GameMapManager.h"
 #include "AudioDevice.h"
 #include "CarnageGame.h"
+#include "TimeManager.h"
+#include "cvars.h"
+#include "MemoryTracker.h"
+
+CvarFloat gCvarAudioHearingDistance("a_hearingDistance", 96.0f, 1.0f, 1000.0f, "Distance after which sounds are not heard, meters", CvarFlags_Archive);
+
+// max number of real and virtual voices
+const int MaxSfxVoices = 128;
+
+// audio thread sleep time when there are no commands
+const int AudioThreadIdleSleepMs = 1;
+
+//////////////////////////////////////////////////////////////////////////
 
 AudioManager gAudioManager;
 
 bool AudioManager::Initialize()
 {
+    mHearingDistance = gCvarAudioHearingDistance.mValue;
+
     if (!AllocateAudioSources())
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot allocate audio sources");
@@ -19,7 +34,6 @@ bool AudioManager::Initialize()
 
 void AudioManager::Deinit()
 {
-    StopAllSounds();
     FreeLevelSounds();
 
     ReleaseAudioSources();
@@ -27,14 +41,250 @@ void AudioManager::Deinit()
 
 void AudioManager::UpdateFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Audio);
+
+    // send listeners positions which has changed since last frame
+    const std::vector<AudioListener*>& listeners = gAudioDevice.GetAudioListeners();
+    if (listeners.size() != mSentListenersPositions.size())
+    {
+        mSentListenersPositions.resize(listeners.size(), glm::vec3(FLT_MAX));
+
+        AudioCommand command (eAudioCommand_SetListenersCount);
+        command.mListenerIndex = (int) listeners.size();
+        PushCommand(command);
+    }
+
+    for (size_t ilistener = 0; ilistener < listeners.size(); ++ilistener)
+    {
+        const glm::vec3& listenerPosition = listeners[ilistener]->GetPosition();
+        if (mSentListenersPositions[ilistener] == listenerPosition)
+            continue;
+
+        mSentListenersPositions[ilistener] = listenerPosition;
+
+        AudioCommand command (eAudioCommand_SetListenerPosition);
+        command.mListenerIndex = (int) ilistener;
+        command.mPosition = listenerPosition;
+        PushCommand(command);
+    }
+
+    AudioCommand command (eAudioCommand_UpdateFrame);
+    command.mDeltaTime = gTimeManager.mSystemFrameDelta;
+    command.mHearingDistance = gCvarAudioHearingDistance.mValue;
+    PushCommand(command);
+}
+
+AudioVoicesStats AudioManager::GetVoicesStats() const
+{
+    std::lock_guard<std::mutex> statsLock (mStatsMutex);
+    return mPublishedVoicesStats;
+}
 
+void AudioManager::PushCommand(const AudioCommand& command)
+{
+    if (!mAudioThread.joinable())
+    {
+        // no audio thread, process immediately
+        ProcessCommand(command);
+        return;
+    }
+
+    // audio thread is always draining queue, so it is safe to wait
+    while (!mCommandsQueue.push(command))
+    {
+        std::this_thread::yield();
+    }
+}
+
+bool AudioManager::ProcessCommands()
+{
+    bool hasCommands = false;
+
+    AudioCommand command;
+    while (mCommandsQueue.pop(command))
+    {
+        ProcessCommand(command);
+        hasCommands = true;
+    }
+    return hasCommands;
+}
+
+void AudioManager::ProcessCommand(const AudioCommand& command)
+{
+    switch (command.mCommandID)
+    {
+        case eAudioCommand_Play: 
+            StartVoice(command);
+        break;
+        case eAudioCommand_Stop:
+        {
+            SfxVoice* voice = GetVoiceByID(command.mVoiceID);
+            if (voice)
+            {
+                if (voice->mAudioSource)
+                {
+                    StopRealVoice(*voice);
+                }
+                *voice = mVoices.back();
+                mVoices.pop_back();
+            }
+        }
+        break;
+        case eAudioCommand_SetPosition:
+        {
+            SfxVoice* voice = GetVoiceByID(command.mVoiceID);
+            if (voice)
+            {
+                voice->mPosition = command.mPosition;
+                if (voice->mAudioSource)
+                {
+                    voice->mAudioSource->SetPosition3D(command.mPosition.x, command.mPosition.y, command.mPosition.z);
+                }
+            }
+        }
+        break;
+        case eAudioCommand_StopAll: 
+            StopAllVoices();
+        break;
+        case eAudioCommand_PauseAll:
+            PauseAllVoices();
+        break;
+        case eAudioCommand_ResumeAll: 
+            ResumeAllVoices();
+        break;
+        case eAudioCommand_SetListenersCount:
+            mListenersPositions.resize(command.mListenerIndex);
+        break;
+        case eAudioCommand_SetListenerPosition:
+            debug_assert(command.mListenerIndex < (int) mListenersPositions.size());
+            mListenersPositions[command.mListenerIndex] = command.mPosition;
+        break;
+        case eAudioCommand_UpdateFrame:
+            mHearingDistance = command.mHearingDistance;
+            UpdateVoices(command.mDeltaTime);
+            gAudioDevice.UpdateFrame(mListenersPositions);
+        break;
+    }
+}
+
+void AudioManager::StartAudioThread()
+{
+#ifndef __EMSCRIPTEN__
+    debug_assert(!mAudioThread.joinable());
+    debug_assert(mCommandsQueue.empty());
+
+    mAudioThreadQuit = false;
+    mAudioThread = std::thread([this]()
+        {
+            MEMORY_TAG_SCOPE(eMemoryTag_Audio);
+
+            while (!mAudioThreadQuit.load(std::memory_order_acquire))
+            {
+                if (!ProcessCommands())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(AudioThreadIdleSleepMs));
+                }
+            }
+            // process remaining commands
+            ProcessCommands();
+        });
+#endif // __EMSCRIPTEN__
+}
+
+void AudioManager::StopAudioThread()
+{
+    if (mAudioThread.joinable())
+    {
+        mAudioThreadQuit.store(true, std::memory_order_release);
+        mAudioThread.join();
+    }
+}
+
+AudioManager::SfxVoice* AudioManager::GetVoiceByID(SfxVoiceID voiceID)
+{
+    for (SfxVoice& currVoice: mVoices)
+    {
+        if (currVoice.mVoiceID == voiceID)
+            return &currVoice;
+    }
+    return nullptr;
+}
+
+void AudioManager::UpdateVoices(float deltaTime)
+{
+    if (mSoundsPaused)
+        return;
+
+    mVoicesTime += deltaTime;
+
+    // release finished voices, real voices are also tracked by time so audio sources state is not queried
+    for (size_t ivoice = 0; ivoice < mVoices.size(); )
+    {
+        SfxVoice& currVoice = mVoices[ivoice];
+        if (IsVoiceFinished(currVoice))
+        {
+            if (currVoice.mAudioSource)
+            {
+                StopRealVoice(currVoice);
+            }
+            currVoice = mVoices.back();
+            mVoices.pop_back();
+            continue;
+        }
+        ++ivoice;
+    }
+
+    // virtualize inaudible voices
+    mVirtualVoicesList.clear();
+    for (SfxVoice& currVoice: mVoices)
+    {
+        ComputeVoiceAudibility(currVoice);
+        if (currVoice.mAudioSource)
+        {
+            if (currVoice.mAudibility == 0.0f)
+            {
+                StopRealVoice(currVoice);
+            }
+            continue;
+        }
+        if (currVoice.mAudibility > 0.0f)
+        {
+            mVirtualVoicesList.push_back(&currVoice);
+        }
+    }
+
+    // start most important virtual voices first
+    if (!mVirtualVoicesList.empty())
+    {
+        std::sort(mVirtualVoicesList.begin(), mVirtualVoicesList.end(), [this](const SfxVoice* voiceA, const SfxVoice* voiceB)
+            {
+                return IsVoiceMoreImportant(*voiceA, *voiceB);
+            });
+
+        for (SfxVoice* currVoice: mVirtualVoicesList)
+        {
+            if (!TryStartRealVoice(*currVoice))
+                break;
+        }
+    }
+
+    mVoicesStats.mRealVoices = (int) (mAudioSources.size() - mFreeAudioSources.size());
+    mVoicesStats.mVirtualVoices = (int) mVoices.size() - mVoicesStats.mRealVoices;
+
+    std::lock_guard<std::mutex> statsLock (mStatsMutex);
+    mPublishedVoicesStats = mVoicesStats;
 }
 
 bool AudioManager::LoadLevelSounds()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Audio);
+
     FreeLevelSounds();
 
     gConsole.LogMessage(eLogMessage_Debug, "Loading level sounds...");
+
+    mBankStats = AudioBankStats();
+    double loadStartTime = gSystem.GetSystemSeconds();
     if (!mVoiceSounds.LoadArchive("AUDIO/VOCALCOM"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load Voice sounds");
@@ -46,14 +296,64 @@ bool AudioManager::LoadLevelSounds()
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load Level sounds");
     }
 
-    mLevelSoundsBuffers.resize(mLevelSounds.GetEntriesCount());
-    mVoiceSoundsBuffers.resize(mVoiceSounds.GetEntriesCount());
+    mBankStats.mReadBytes = mLevelSounds.GetRawDataLength() + mVoiceSounds.GetRawDataLength();
+    mBankStats.mReadTime = (float) ((gSystem.GetSystemSeconds() - loadStartTime) * 1000.0);
+
+    // create all audio buffers while level is loading, so there are no hitches on first play
+    double uploadStartTime = gSystem.GetSystemSeconds();
+    CreateSfxAudioBuffers(mLevelSounds, mLevelSoundsBuffers);
+    CreateSfxAudioBuffers(mVoiceSounds, mVoiceSoundsBuffers);
+    mBankStats.mUploadTime = (float) ((gSystem.GetSystemSeconds() - uploadStartTime) * 1000.0);
 
+    gConsole.LogMessage(eLogMessage_Debug, "Level sounds loaded: %d buffers, %d bytes (read %.2f ms, upload %.2f ms)", 
+        mBankStats.mLoadedBuffers, mBankStats.mReadBytes, mBankStats.mReadTime, mBankStats.mUploadTime);
+
+    // audio buffers are ready, from now on audio sources are controlled from audio thread
+    StartAudioThread();
     return true;
 }
 
+void AudioManager::CreateSfxAudioBuffers(SfxArchive& archive, std::vector<AudioBuffer*>& buffers)
+{
+    int entriesCount = archive.GetEntriesCount();
+    buffers.resize(entriesCount);
+
+    for (int ientry = 0; ientry < entriesCount; ++ientry)
+    {
+        SfxArchiveEntry archiveEntry;
+        if (!archive.GetEntryData(ientry, archiveEntry))
+        {
+            ++mBankStats.mFailedBuffers;
+            continue;
+        }
+        // upload audio data
+        AudioBuffer* audioBuffer = gAudioDevice.CreateAudioBuffer(
+            archiveEntry.mSampleRate,
+            archiveEntry.mBitsPerSample,
+            archiveEntry.mChannelsCount,
+            archiveEntry.mDataLength,
+            archiveEntry.mData);
+
+        if (audioBuffer == nullptr || audioBuffer->IsBufferError())
+        {
+            ++mBankStats.mFailedBuffers;
+            continue;
+        }
+
+        buffers[ientry] = audioBuffer;
+        ++mBankStats.mLoadedBuffers;
+    }
+
+    // samples data is copied to audio buffers and not needed anymore
+    archive.FreeRawData();
+}
+
 void AudioManager::FreeLevelSounds()
 {
+    // voices are referencing audio buffers
+    StopAudioThread();
+    StopAllVoices();
+
     mLevelSounds.FreeArchive();
     mVoiceSounds.FreeArchive();
 
@@ -97,109 +397,217 @@ void AudioManager::ReleaseAudioSources()
         }
     }
     mAudioSources.clear();
+    mFreeAudioSources.clear();
+    mVoices.clear();
 }
 
-AudioSource* AudioManager::PlaySfxLevel(int sfxIndex, const glm::vec3& position, bool enableLoop)
+SfxVoiceID AudioManager::PlaySfxLevel(int sfxIndex, const glm::vec3& position, bool enableLoop, eSfxPriority priority)
 {
-    if (sfxIndex < 0 || sfxIndex >= mLevelSounds.GetEntriesCount())
+    return PlaySfx(mLevelSoundsBuffers, sfxIndex, position, enableLoop, priority);
+}
+
+SfxVoiceID AudioManager::PlaySfxVoice(int sfxIndex, const glm::vec3& position, bool enableLoop, eSfxPriority priority)
+{
+    return PlaySfx(mVoiceSoundsBuffers, sfxIndex, position, enableLoop, priority);
+}
+
+SfxVoiceID AudioManager::PlaySfx(const std::vector<AudioBuffer*>& buffers, int sfxIndex, const glm::vec3& position, 
+    bool enableLoop, eSfxPriority priority)
+{
+    if (sfxIndex < 0 || sfxIndex >= (int) buffers.size())
     {
         debug_assert(false);
-        return nullptr;
+        return SfxVoiceID_Null;
     }
 
-    AudioSource* audioSource = GetFreeSfxAudioSource();
-    if (audioSource == nullptr)
-        return nullptr; // out of free audio channels
+    if (buffers[sfxIndex] == nullptr)
+        return SfxVoiceID_Null;
 
-    if (mLevelSoundsBuffers[sfxIndex] == nullptr)
+    if (++mVoicesCounter == SfxVoiceID_Null)
     {
-        SfxArchiveEntry archiveEntry;
-        if (!mLevelSounds.GetEntryData(sfxIndex, archiveEntry))
+        ++mVoicesCounter;
+    }
+
+    AudioCommand command (eAudioCommand_Play);
+    command.mVoiceID = mVoicesCounter;
+    command.mAudioBuffer = buffers[sfxIndex];
+    command.mPosition = position;
+    command.mPriority = priority;
+    command.mLoop = enableLoop;
+    PushCommand(command);
+    return mVoicesCounter;
+}
+
+void AudioManager::StopSfx(SfxVoiceID voiceID)
+{
+    if (voiceID == SfxVoiceID_Null)
+        return;
+
+    AudioCommand command (eAudioCommand_Stop);
+    command.mVoiceID = voiceID;
+    PushCommand(command);
+}
+
+void AudioManager::SetSfxPosition(SfxVoiceID voiceID, const glm::vec3& position)
+{
+    if (voiceID == SfxVoiceID_Null)
+        return;
+
+    AudioCommand command (eAudioCommand_SetPosition);
+    command.mVoiceID = voiceID;
+    command.mPosition = position;
+    PushCommand(command);
+}
+
+void AudioManager::StartVoice(const AudioCommand& command)
+{
+    SfxVoice newVoice;
+    newVoice.mVoiceID = command.mVoiceID;
+    newVoice.mAudioBuffer = command.mAudioBuffer;
+    newVoice.mPosition = command.mPosition;
+    newVoice.mPriority = command.mPriority;
+    newVoice.mStartTime = mVoicesTime;
+    newVoice.mLoop = command.mLoop;
+    ComputeVoiceAudibility(newVoice);
+
+    // steal least important voice when limit is reached
+    if (mVoices.size() >= MaxSfxVoices)
+    {
+        auto leastVoice = std::min_element(mVoices.begin(), mVoices.end(), [this](const SfxVoice& voiceA, const SfxVoice& voiceB)
+            {
+                return IsVoiceMoreImportant(voiceB, voiceA);
+            });
+
+        if (!IsVoiceMoreImportant(newVoice, *leastVoice))
         {
-            debug_assert(false);
-            return nullptr;
+            ++mVoicesStats.mDroppedVoices;
+            return;
         }
-        // upload audio data
-        AudioBuffer* audioBuffer = gAudioDevice.CreateAudioBuffer(
-            archiveEntry.mSampleRate,
-            archiveEntry.mBitsPerSample,
-            archiveEntry.mChannelsCount,
-            archiveEntry.mDataLength,
-            archiveEntry.mData);
 
-        // free source data
-        mLevelSounds.FreeEntryData(sfxIndex);
+        if (leastVoice->mAudioSource)
+        {
+            StopRealVoice(*leastVoice);
+        }
+        *leastVoice = mVoices.back();
+        mVoices.pop_back();
+        ++mVoicesStats.mDroppedVoices;
+    }
 
-        debug_assert(audioBuffer && !audioBuffer->IsBufferError());
+    mVoices.push_back(newVoice);
 
-        mLevelSoundsBuffers[sfxIndex] = audioBuffer;
-    }
-    // get buffer
-    if (!audioSource->SetupSourceBuffer(mLevelSoundsBuffers[sfxIndex]))
+    // inaudible voices stay virtual until listener come closer
+    if (newVoice.mAudibility > 0.0f)
     {
-        debug_assert(false);
+        TryStartRealVoice(mVoices.back());
     }
-    audioSource->SetPitch(1.0f);
-    audioSource->SetPosition3D(position.x, position.y, position.z);
-    audioSource->Start(enableLoop);
-    return audioSource;
 }
 
-AudioSource* AudioManager::PlaySfxVoice(int sfxIndex, const glm::vec3& position, bool enableLoop)
+void AudioManager::ComputeVoiceAudibility(SfxVoice& voice) const
 {
-    if (sfxIndex < 0 || sfxIndex >= mVoiceSounds.GetEntriesCount())
+    if (voice.mPriority == eSfxPriority_Critical)
     {
-        debug_assert(false);
-        return nullptr;
+        voice.mAudibility = 1.0f;
+        return;
     }
 
-    AudioSource* audioSource = GetFreeSfxAudioSource();
-    if (audioSource == nullptr)
-        return nullptr; // out of free audio channels
+    if (mListenersPositions.empty())
+    {
+        voice.mAudibility = 1.0f;
+        return;
+    }
 
-    if (mVoiceSoundsBuffers[sfxIndex] == nullptr)
+    // listeners are placed above map so only horizontal distance is counted
+    float minDistance2 = FLT_MAX;
+    for (const glm::vec3& listenerPosition: mListenersPositions)
     {
-        SfxArchiveEntry archiveEntry;
-        if (!mVoiceSounds.GetEntryData(sfxIndex, archiveEntry))
+        glm::vec2 toListener (listenerPosition.x - voice.mPosition.x, listenerPosition.z - voice.mPosition.z);
+        minDistance2 = std::min(minDistance2, glm::length2(toListener));
+    }
+
+    float hearingDistance = mHearingDistance;
+    if (minDistance2 >= hearingDistance * hearingDistance)
+    {
+        voice.mAudibility = 0.0f;
+        return;
+    }
+    voice.mAudibility = 1.0f - (sqrtf(minDistance2) / hearingDistance);
+}
+
+bool AudioManager::IsVoiceMoreImportant(const SfxVoice& voiceA, const SfxVoice& voiceB) const
+{
+    if (voiceA.mPriority != voiceB.mPriority)
+        return voiceA.mPriority > voiceB.mPriority;
+
+    return voiceA.mAudibility > voiceB.mAudibility;
+}
+
+bool AudioManager::IsVoiceFinished(const SfxVoice& voice) const
+{
+    if (voice.mLoop)
+        return false;
+
+    return (mVoicesTime - voice.mStartTime) >= voice.mAudioBuffer->mDuration;
+}
+
+bool AudioManager::TryStartRealVoice(SfxVoice& voice)
+{
+    debug_assert(voice.mAudioSource == nullptr);
+
+    AudioSource* audioSource = nullptr;
+    if (mFreeAudioSources.empty())
+    {
+        // steal audio source from least important real voice
+        SfxVoice* leastVoice = nullptr;
+        for (SfxVoice& currVoice: mVoices)
         {
-            debug_assert(false);
-            return nullptr;
-        }
-        // upload audio data
-        AudioBuffer* audioBuffer = gAudioDevice.CreateAudioBuffer(
-            archiveEntry.mSampleRate,
-            archiveEntry.mBitsPerSample,
-            archiveEntry.mChannelsCount,
-            archiveEntry.mDataLength,
-            archiveEntry.mData);
+            if (currVoice.mAudioSource == nullptr)
+                continue;
 
-        // free source data
-        mVoiceSounds.FreeEntryData(sfxIndex);
+            if (leastVoice == nullptr || IsVoiceMoreImportant(*leastVoice, currVoice))
+            {
+                leastVoice = &currVoice;
+            }
+        }
 
-        debug_assert(audioBuffer && !audioBuffer->IsBufferError());
+        if (leastVoice == nullptr || !IsVoiceMoreImportant(voice, *leastVoice))
+            return false;
 
-        mVoiceSoundsBuffers[sfxIndex] = audioBuffer;
+        StopRealVoice(*leastVoice);
+        ++mVoicesStats.mStolenVoices;
     }
-    // get buffer
-    if (!audioSource->SetupSourceBuffer(mVoiceSoundsBuffers[sfxIndex]))
+
+    debug_assert(!mFreeAudioSources.empty());
+    audioSource = mFreeAudioSources.back();
+    mFreeAudioSources.pop_back();
+
+    if (!audioSource->SetupSourceBuffer(voice.mAudioBuffer))
     {
         debug_assert(false);
     }
+
+    // continue playback from where virtual voice is
+    float playbackOffset = mVoicesTime - voice.mStartTime;
+    if (voice.mLoop && voice.mAudioBuffer->mDuration > 0.0f)
+    {
+        playbackOffset = fmodf(playbackOffset, voice.mAudioBuffer->mDuration);
+    }
+
     audioSource->SetPitch(1.0f);
-    audioSource->SetPosition3D(position.x, position.y, position.z);
-    audioSource->Start(enableLoop);
-    return audioSource;
+    audioSource->SetMaxDistance(mHearingDistance);
+    audioSource->SetPosition3D(voice.mPosition.x, voice.mPosition.y, voice.mPosition.z);
+    audioSource->SetPlaybackOffset(playbackOffset);
+    audioSource->Start(voice.mLoop);
+    voice.mAudioSource = audioSource;
+    return true;
 }
 
-AudioSource* AudioManager::GetFreeSfxAudioSource() const
+void AudioManager::StopRealVoice(SfxVoice& voice)
 {
-    for (AudioSource* currSource: mAudioSources)
-    {
-        if (currSource && !currSource->IsPlaying() && !currSource->IsPaused())
-            return currSource;
-    }
+    debug_assert(voice.mAudioSource);
 
-    return nullptr;
+    voice.mAudioSource->Stop();
+    mFreeAudioSources.push_back(voice.mAudioSource);
+    voice.mAudioSource = nullptr;
 }
 
 bool AudioManager::AllocateAudioSources()
@@ -212,39 +620,66 @@ bool AudioManager::AllocateAudioSources()
             break;
 
         mAudioSources.push_back(audioSource);
+        mFreeAudioSources.push_back(audioSource);
     }
+    mVoices.reserve(MaxSfxVoices);
     return true;
 }
 
 void AudioManager::StopAllSounds()
 {
-    for (AudioSource* currSource: mAudioSources)
+    PushCommand(AudioCommand(eAudioCommand_StopAll));
+}
+
+void AudioManager::PauseAllSounds()
+{
+    PushCommand(AudioCommand(eAudioCommand_PauseAll));
+}
+
+void AudioManager::ResumeAllSounds()
+{
+    PushCommand(AudioCommand(eAudioCommand_ResumeAll));
+}
+
+void AudioManager::StopAllVoices()
+{
+    for (SfxVoice& currVoice: mVoices)
     {
-        if (currSource->IsPlaying() || currSource->IsPaused())
+        if (currVoice.mAudioSource)
         {
-            currSource->Stop();
+            StopRealVoice(currVoice);
         }
     }
+    mVoices.clear();
+    mSoundsPaused = false;
 }
 
-void AudioManager::PauseAllSounds()
+void AudioManager::PauseAllVoices()
 {
-    for (AudioSource* currSource: mAudioSources)
+    if (mSoundsPaused)
+        return;
+
+    for (SfxVoice& currVoice: mVoices)
     {
-        if (currSource->IsPlaying())
+        if (currVoice.mAudioSource)
         {
-            currSource->Pause();
+            currVoice.mAudioSource->Pause();
         }
     }
+    mSoundsPaused = true;
 }
 
-void AudioManager::ResumeAllSounds()
+void AudioManager::ResumeAllVoices()
 {
-    for (AudioSource* currSource: mAudioSources)
+    if (!mSoundsPaused)
+        return;
+
+    for (SfxVoice& currVoice: mVoices)
     {
-        if (currSource->IsPaused())
+        if (currVoice.mAudioSource)
         {
-            currSource->Resume();
+            currVoice.mAudioSource->Resume();
         }
     }
+    mSoundsPaused = false;
 }
\ No newline at end of file
@@ -4,41 +4,173 @@
 #include "SfxDefs.h"
 #include "AudioSource.h"
 
+// sound voice handle, zero is null
+using SfxVoiceID = unsigned int;
+
+const SfxVoiceID SfxVoiceID_Null = 0;
+
+// sound voices statistics info
+struct AudioVoicesStats
+{
+public:
+    int mRealVoices = 0; // voices playing on audio sources
+    int mVirtualVoices = 0; // voices which are inaudible or lost their audio source
+    int mStolenVoices = 0; // total
+    int mDroppedVoices = 0; // total
+};
+
+// level sounds loading statistics info
+struct AudioBankStats
+{
+public:
+    int mLoadedBuffers = 0;
+    int mFailedBuffers = 0;
+    int mReadBytes = 0; // samples data read from archives
+    float mReadTime = 0.0f; // ms
+    float mUploadTime = 0.0f; // ms
+};
+
 // This class manages in game music and sounds
+// Sounds are played through voices, only audible voices with highest priority get audio sources,
+// others are kept virtual and tracked by time until they become audible again or finish
+// While level is loaded voices and audio sources are owned by audio thread, game thread sends commands to it
 class AudioManager final: public cxx::noncopyable
 {
 public:
     SfxArchive mLevelSounds;
     SfxArchive mVoiceSounds;
 
+    // readonly
+    AudioBankStats mBankStats;
+
 public:
     bool Initialize();
     void Deinit();
 
     void UpdateFrame();
 
-    // Preload sound archives for current level
+    // Preload sound archives for current level and create all audio buffers
     bool LoadLevelSounds();
     void FreeLevelSounds();
 
+    // Start sound playback, sound still could be dropped later if there are too many more important voices
     // @param sfxIndex: Sound index, one of SfxLevel_*
-    AudioSource* PlaySfxLevel(int sfxIndex, const glm::vec3& position, bool enableLoop);
+    // @param priority: Playback priority
+    // @returns Voice handle which remains valid until sound is finished
+    SfxVoiceID PlaySfxLevel(int sfxIndex, const glm::vec3& position, bool enableLoop, eSfxPriority priority = eSfxPriority_Normal);
 
     // @param sfxIndex: Sound index, one of SfxVoice_*
-    AudioSource* PlaySfxVoice(int sfxIndex, const glm::vec3& position, bool enableLoop);
+    // @param priority: Playback priority
+    SfxVoiceID PlaySfxVoice(int sfxIndex, const glm::vec3& position, bool enableLoop, eSfxPriority priority = eSfxPriority_Critical);
+
+    // Control sound playback, does nothing if voice is already finished
+    // @param voiceID: Voice handle
+    void StopSfx(SfxVoiceID voiceID);
+    void SetSfxPosition(SfxVoiceID voiceID, const glm::vec3& position);
 
     void StopAllSounds();
     void PauseAllSounds();
     void ResumeAllSounds();
 
+    // Get voices statistics from audio thread
+    AudioVoicesStats GetVoicesStats() const;
+
 private:
-    AudioSource* GetFreeSfxAudioSource() const;
+    enum eAudioCommand
+    {
+        eAudioCommand_Play,
+        eAudioCommand_Stop,
+        eAudioCommand_SetPosition,
+        eAudioCommand_StopAll,
+        eAudioCommand_PauseAll,
+        eAudioCommand_ResumeAll,
+        eAudioCommand_SetListenersCount,
+        eAudioCommand_SetListenerPosition,
+        eAudioCommand_UpdateFrame,
+    };
+
+    struct AudioCommand
+    {
+    public:
+        AudioCommand() = default;
+        AudioCommand(eAudioCommand commandID) : mCommandID(commandID)
+        {
+        }
+    public:
+        eAudioCommand mCommandID = eAudioCommand_UpdateFrame;
+        SfxVoiceID mVoiceID = SfxVoiceID_Null;
+        AudioBuffer* mAudioBuffer = nullptr;
+        glm::vec3 mPosition;
+        eSfxPriority mPriority = eSfxPriority_Normal;
+        int mListenerIndex = 0; // listeners count for SetListenersCount
+        float mDeltaTime = 0.0f;
+        float mHearingDistance = 0.0f;
+        bool mLoop = false;
+    };
+
+    struct SfxVoice
+    {
+    public:
+        SfxVoiceID mVoiceID = SfxVoiceID_Null;
+        AudioBuffer* mAudioBuffer = nullptr;
+        AudioSource* mAudioSource = nullptr; // null while voice is virtual
+        glm::vec3 mPosition;
+        eSfxPriority mPriority = eSfxPriority_Normal;
+        float mStartTime = 0.0f; // voices clock time
+        float mAudibility = 0.0f; // 1 is next to listener, 0 is not audible
+        bool mLoop = false;
+    };
+
+    SfxVoiceID PlaySfx(const std::vector<AudioBuffer*>& buffers, int sfxIndex, const glm::vec3& position, 
+        bool enableLoop, eSfxPriority priority);
+    void CreateSfxAudioBuffers(SfxArchive& archive, std::vector<AudioBuffer*>& buffers);
+
+    // commands, if there is no audio thread they are processed immediately
+    void PushCommand(const AudioCommand& command);
+    void ProcessCommand(const AudioCommand& command);
+    // @returns false if there was no commands
+    bool ProcessCommands();
+
+    void StartAudioThread();
+    void StopAudioThread();
+
+    // voices management, audio thread side
+    void UpdateVoices(float deltaTime);
+    void StartVoice(const AudioCommand& command);
+    void StopAllVoices();
+    void PauseAllVoices();
+    void ResumeAllVoices();
+    SfxVoice* GetVoiceByID(SfxVoiceID voiceID);
+    void ComputeVoiceAudibility(SfxVoice& voice) const;
+    bool IsVoiceMoreImportant(const SfxVoice& voiceA, const SfxVoice& voiceB) const;
+    bool IsVoiceFinished(const SfxVoice& voice) const;
+    bool TryStartRealVoice(SfxVoice& voice);
+    void StopRealVoice(SfxVoice& voice);
 
     bool AllocateAudioSources();
     void ReleaseAudioSources();
 
 private:
+    // game thread side
+    cxx::spsc_queue<AudioCommand, 1024> mCommandsQueue;
+    std::thread mAudioThread;
+    std::atomic<bool> mAudioThreadQuit {false};
+    SfxVoiceID mVoicesCounter = SfxVoiceID_Null;
+    std::vector<glm::vec3> mSentListenersPositions;
+
+    // audio thread side
+    std::vector<glm::vec3> mListenersPositions;
+    float mHearingDistance = 0.0f;
+    AudioVoicesStats mVoicesStats;
+    AudioVoicesStats mPublishedVoicesStats;
+    mutable std::mutex mStatsMutex;
+
     std::vector<AudioSource*> mAudioSources; // all audio sources
+    std::vector<AudioSource*> mFreeAudioSources;
+    std::vector<SfxVoice> mVoices; // real and virtual voices
+    std::vector<SfxVoice*> mVirtualVoicesList; // temporary list of virtual voices to be started
+    float mVoicesTime = 0.0f; // does not advance while sounds are paused
+    bool mSoundsPaused = false;
     std::vector<AudioBuffer*> mLevelSoundsBuffers;
     std::vector<AudioBuffer*> mVoiceSoundsBuffers;
 };
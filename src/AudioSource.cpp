@@ -39,6 +39,8 @@ bool AudioBuffer::SetupBufferData(int sampleRate, int bitsPerSample, int channel
         ::alBufferData(mBufferID, alFormat, bufferData, dataLength, sampleRate);
         alCheckError();
 
+        mDuration = (float) dataLength / (sampleRate * channelsCount * (bitsPerSample / 8));
+
         return true;
     }
     return false;
@@ -118,6 +120,10 @@ bool AudioSource::Start(bool enableLoop)
         ::alSourcei(mSourceID, AL_LOOPING, enableLoop ? AL_TRUE : AL_FALSE);
         alCheckError();
 
+        // new sound must get its position regardless of previous one
+        mAppliedPosition = glm::vec3(FLT_MAX);
+        mPositionDirty = true;
+        mStarted = true;
         return true;
     }
     return false;
@@ -125,6 +131,7 @@ bool AudioSource::Start(bool enableLoop)
 
 bool AudioSource::Stop()
 {
+    mStarted = false;
     if (::alIsSource(mSourceID))
     {
         ::alSourceStop(mSourceID);
@@ -202,6 +209,7 @@ bool AudioSource::SetPosition3D(float positionx, float positiony, float position
         mSourceLocation.x = positionx;
         mSourceLocation.y = positiony;
         mSourceLocation.z = positionz;
+        mPositionDirty = true;
 
         // position will be updated on next audio device update frame
         return true;
@@ -209,6 +217,31 @@ bool AudioSource::SetPosition3D(float positionx, float positiony, float position
     return false;
 }
 
+bool AudioSource::SetMaxDistance(float value)
+{
+    if (::alIsSource(mSourceID))
+    {
+        ::alSourcef(mSourceID, AL_MAX_DISTANCE, value);
+        alCheckError();
+
+        mMaxDistance = value;
+        return true;
+    }
+    return false;
+}
+
+bool AudioSource::SetPlaybackOffset(float seconds)
+{
+    if (::alIsSource(mSourceID))
+    {
+        ::alSourcef(mSourceID, AL_SEC_OFFSET, seconds);
+        alCheckError();
+
+        return true;
+    }
+    return false;
+}
+
 bool AudioSource::IsPlaying() const
 {
     if (::alIsSource(mSourceID))
@@ -5,6 +5,10 @@ class AudioBuffer final: public cxx::noncopyable
 {
     friend class AudioSource;
 
+public:
+    // readonly
+    float mDuration = 0.0f; // seconds
+
 public:
     AudioBuffer();
     ~AudioBuffer();
@@ -44,6 +48,10 @@ public:
     bool SetVolume(float value);
     bool SetPitch(float value);
     bool SetPosition3D(float positionx, float positiony, float positionz);
+    // Set distance after which sound is not heard
+    bool SetMaxDistance(float value);
+    // Set playback position, should be called before start
+    bool SetPlaybackOffset(float seconds);
     // Get current audio state
     bool IsPlaying() const;
     bool IsStopped() const;
@@ -53,5 +61,9 @@ public:
 private:
     unsigned int mSourceID = 0; // openal source handle
 
-    glm::vec3 mSourceLocation;
+    glm::vec3 mSourceLocation {0.0f};
+    glm::vec3 mAppliedPosition {0.0f}; // last position relative to listener sent to openal
+    float mMaxDistance = FLT_MAX;
+    bool mPositionDirty = true;
+    bool mStarted = false; // tracked locally, source may have already finished playing
 };
\ No newline at end of file
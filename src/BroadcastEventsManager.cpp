@@ -2,33 +2,89 @@
 #include "BroadcastEventsManager.h"
 #include "TimeManager.h"
 
+// expiry timing wheel resolution, seconds
+static const float WheelTickDuration = 0.25f;
+
 BroadcastEventsManager gBroadcastEvents;
 
 BroadcastEventsManager::BroadcastEventsManager()
 {
+    ClearEvents();
 }
 
 void BroadcastEventsManager::ClearEvents()
 {
-    mEventsList.clear();
+    mEventSlots.clear();
+    mFreeSlots.clear();
+    mSubjectEvents.clear();
+
+    for (int& currCount: mEventsCount)
+    {
+        currCount = 0;
+    }
+
+    for (auto& currTypeCells: mGridCells)
+    {
+        for (int& currCell: currTypeCells)
+        {
+            currCell = -1;
+        }
+    }
+
+    for (std::vector<int>& currWheelSlot: mWheelSlots)
+    {
+        currWheelSlot.clear();
+    }
+    mWheelTick = (long long) (gTimeManager.mGameTime / WheelTickDuration);
 }
 
 void BroadcastEventsManager::UpdateFrame()
 {
     float currentGameTime = gTimeManager.mGameTime;
 
-    // remove obsolete events from list
-    for (auto curr_event_iterator = mEventsList.begin(); 
-        curr_event_iterator != mEventsList.end(); )
+    long long currentTick = (long long) (currentGameTime / WheelTickDuration);
+    if (currentTick < mWheelTick) // game time was reset, schedule all events again
     {
-        BroadcastEvent& eventData = *curr_event_iterator;
-        if ((eventData.mEventTimestamp + eventData.mEventDurationTime) > currentGameTime)
+        for (std::vector<int>& currWheelSlot: mWheelSlots)
+        {
+            currWheelSlot.clear();
+        }
+        mWheelTick = currentTick;
+        for (int islot = 0, SlotsCount = (int) mEventSlots.size(); islot < SlotsCount; ++islot)
         {
-            ++curr_event_iterator;
-            continue;
+            if (mEventSlots[islot].mActive)
+            {
+                ScheduleEventExpiry(islot);
+            }
+        }
+    }
+    if (currentTick - mWheelTick > WheelSlotsCount) // no need to go through whole wheel more than once
+    {
+        mWheelTick = currentTick - WheelSlotsCount;
+    }
+
+    // remove obsolete events
+    for (; mWheelTick < currentTick; )
+    {
+        ++mWheelTick;
+
+        mWheelProcessList.clear();
+        mWheelProcessList.swap(mWheelSlots[mWheelTick % WheelSlotsCount]);
+        for (int currSlot: mWheelProcessList)
+        {
+            // skip stale records of removed or rescheduled events
+            const EventSlot& eventSlot = mEventSlots[currSlot];
+            if (!eventSlot.mActive || (eventSlot.mExpiryTick > mWheelTick))
+                continue;
+
+            if (IsEventExpired(mEventSlots[currSlot].mEventData, currentGameTime))
+            {
+                RemoveEvent(currSlot);
+                continue;
+            }
+            // event was prolonged
+            ScheduleEventExpiry(currSlot);
         }
-        // remove expired event
-        curr_event_iterator = mEventsList.erase(curr_event_iterator);
     }
 }
 
@@ -52,29 +108,44 @@ void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, GameObject
     }
 
     // update time and location if same event is exists
-    for (BroadcastEvent& evData: mEventsList)
+    const bool hasSubjectKey = (subject->mObjectID != GAMEOBJECT_ID_NULL);
+    if (hasSubjectKey)
     {
-        if ((evData.mEventType == eventType) &&
-            (evData.mEventSubject == subjectType) &&
-            (evData.mSubject == subject))
+        auto subject_iterator = mSubjectEvents.find(GetSubjectKey(eventType, subject->mObjectID));
+        if (subject_iterator != mSubjectEvents.end())
         {
+            EventSlot& eventSlot = mEventSlots[subject_iterator->second];
+
+            BroadcastEvent& evData = eventSlot.mEventData;
             evData.mEventTimestamp = currentGameTime;
             evData.mEventDurationTime = durationTime;
             evData.mPosition = subject->GetPosition2();
+
+            int cellIndex = GetCellIndex(evData.mPosition);
+            if (cellIndex != eventSlot.mCellIndex)
+            {
+                UnlinkEventFromCell(subject_iterator->second);
+                eventSlot.mCellIndex = cellIndex;
+                LinkEventToCell(subject_iterator->second);
+            }
             return;
         }
     }
 
-    mEventsList.emplace_back();
-    BroadcastEvent& evData = mEventsList.back();
+    int slotIndex = AllocateEvent(eventType, subject->GetPosition2());
     // fill event data
-    evData.mEventType = eventType;
+    BroadcastEvent& evData = mEventSlots[slotIndex].mEventData;
     evData.mEventSubject = subjectType;
     evData.mEventTimestamp = currentGameTime;
     evData.mEventDurationTime = durationTime;
-    evData.mPosition = subject->GetPosition2();
     evData.mSubject = subject;
     evData.mCharacter = character;
+    ScheduleEventExpiry(slotIndex);
+
+    if (hasSubjectKey)
+    {
+        mSubjectEvents[GetSubjectKey(eventType, subject->mObjectID)] = slotIndex;
+    }
 }
 
 void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, const glm::vec2& position, float durationTime)
@@ -82,10 +153,10 @@ void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, const glm:
     float currentGameTime = gTimeManager.mGameTime;
 
     // update time if same event is exists
-    for (BroadcastEvent& evData: mEventsList)
+    for (int icurr = mGridCells[eventType][GetCellIndex(position)]; icurr != -1; icurr = mEventSlots[icurr].mNextInCell)
     {
-        if ((evData.mEventType == eventType) &&
-            (evData.mEventSubject == eBroadcastEventSubject_None) &&
+        BroadcastEvent& evData = mEventSlots[icurr].mEventData;
+        if ((evData.mEventSubject == eBroadcastEventSubject_None) &&
             (evData.mPosition == position))
         {
             evData.mEventTimestamp = currentGameTime;
@@ -94,23 +165,27 @@ void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, const glm:
         }
     }
 
-    mEventsList.emplace_back();
-    BroadcastEvent& evData = mEventsList.back();
+    int slotIndex = AllocateEvent(eventType, position);
     // fill event data
-    evData.mEventType = eventType;
+    BroadcastEvent& evData = mEventSlots[slotIndex].mEventData;
     evData.mEventSubject = eBroadcastEventSubject_None;
     evData.mEventTimestamp = currentGameTime;
     evData.mEventDurationTime = durationTime;
-    evData.mPosition = position;
+    ScheduleEventExpiry(slotIndex);
 }
 
 bool BroadcastEventsManager::PeekEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData) const
 {
-    for (const BroadcastEvent& currEvent: mEventsList)
+    if (mEventsCount[eventType] == 0)
+        return false;
+
+    float currentGameTime = gTimeManager.mGameTime;
+    for (const EventSlot& currSlot: mEventSlots)
     {
-        if (currEvent.mEventType == eventType)
+        if (currSlot.mActive && (currSlot.mEventData.mEventType == eventType) &&
+            !IsEventExpired(currSlot.mEventData, currentGameTime))
         {
-            outputEventData = currEvent;
+            outputEventData = currSlot.mEventData;
             return true;
         }
     }
@@ -119,50 +194,84 @@ bool BroadcastEventsManager::PeekEvent(eBroadcastEvent eventType, BroadcastEvent
 
 bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData) const
 {
-    float closestDistance2 = 0.0f;
-    size_t counter = 0;
-    size_t bestIndex = 0;
-    for (size_t i = 0, Count = mEventsList.size(); i < Count; ++i)
+    return PeekClosestEvent(eventType, position, FLT_MAX, outputEventData);
+}
+
+bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, BroadcastEvent& outputEventData) const
+{
+    return PeekClosestEvent(eventType, position, maxDistance, nullptr, outputEventData);
+}
+
+bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, Pedestrian* excludeCharacter, BroadcastEvent& outputEventData) const
+{
+    int slotIndex = FindClosestEvent(eventType, position, maxDistance, excludeCharacter);
+    if (slotIndex == -1)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+    return true;
+}
+
+int BroadcastEventsManager::QueryEvents(eBroadcastEvent eventType, const glm::vec2& position, float radius, BroadcastEvent* outputEvents, int maxEvents) const
+{
+    return QueryEvents(eventType, position, radius, nullptr, outputEvents, maxEvents);
+}
+
+int BroadcastEventsManager::QueryEvents(eBroadcastEvent eventType, const glm::vec2& position, float radius, Pedestrian* excludeCharacter, BroadcastEvent* outputEvents, int maxEvents) const
+{
+    debug_assert(outputEvents || (maxEvents == 0));
+
+    if (mEventsCount[eventType] == 0 || maxEvents < 1)
+        return 0;
+
+    float currentGameTime = gTimeManager.mGameTime;
+    float radius2 = radius * radius;
+
+    glm::ivec2 minCell (glm::floor(Convert::MetersToMapUnits(position - radius) / (float) GridCellSize));
+    glm::ivec2 maxCell (glm::floor(Convert::MetersToMapUnits(position + radius) / (float) GridCellSize));
+    minCell = glm::clamp(minCell, 0, GridDimensions - 1);
+    maxCell = glm::clamp(maxCell, 0, GridDimensions - 1);
+
+    int eventsCount = 0;
+    for (int celly = minCell.y; celly <= maxCell.y; ++celly)
+    for (int cellx = minCell.x; cellx <= maxCell.x; ++cellx)
     {
-        const BroadcastEvent& currEvent = mEventsList[i];
-        if (currEvent.mEventType == eventType)
+        for (int icurr = mGridCells[eventType][celly * GridDimensions + cellx]; icurr != -1; icurr = mEventSlots[icurr].mNextInCell)
         {
-            ++counter;
+            const BroadcastEvent& evData = mEventSlots[icurr].mEventData;
+            if (IsEventExpired(evData, currentGameTime))
+                continue;
 
-            float currDistance2 = glm::distance2(position, currEvent.mPosition);
-            if (i == 0) // very first element if closest by default
-            {
-                closestDistance2 = currDistance2;
+            if (excludeCharacter && (evData.mCharacter == excludeCharacter))
                 continue;
-            }
 
-            if (currDistance2 < closestDistance2)
-            {
-                closestDistance2 = currDistance2;
-                bestIndex = i;
-            }
+            if (glm::distance2(position, evData.mPosition) > radius2)
+                continue;
+
+            outputEvents[eventsCount++] = evData;
+            if (eventsCount == maxEvents)
+                return eventsCount;
         }
     }
-    if (counter)
-    {
-        outputEventData = mEventsList[bestIndex];
-        return true;
-    }
-    return false;
+    return eventsCount;
 }
 
 bool BroadcastEventsManager::GetEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData)
 {
-    for (auto curr_event_iterator = mEventsList.begin(); 
-        curr_event_iterator != mEventsList.end(); ++curr_event_iterator)
+    if (mEventsCount[eventType] == 0)
+        return false;
+
+    float currentGameTime = gTimeManager.mGameTime;
+    for (int islot = 0, SlotsCount = (int) mEventSlots.size(); islot < SlotsCount; ++islot)
     {
-        BroadcastEvent& eventData = *curr_event_iterator;
-        if (eventData.mEventType == eventType)
+        const EventSlot& currSlot = mEventSlots[islot];
+        if (currSlot.mActive && (currSlot.mEventData.mEventType == eventType) &&
+            !IsEventExpired(currSlot.mEventData, currentGameTime))
         {
-            outputEventData = eventData;
+            outputEventData = currSlot.mEventData;
 
             // remove element
-            mEventsList.erase(curr_event_iterator);
+            RemoveEvent(islot);
             return true;
         }
     }
@@ -171,37 +280,190 @@ bool BroadcastEventsManager::GetEvent(eBroadcastEvent eventType, BroadcastEvent&
 
 bool BroadcastEventsManager::GetClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData)
 {
-    float closestDistance2 = 0.0f;
-    size_t counter = 0;
-    size_t bestIndex = 0;
-    for (size_t i = 0, Count = mEventsList.size(); i < Count; ++i)
+    int slotIndex = FindClosestEvent(eventType, position, FLT_MAX, nullptr);
+    if (slotIndex == -1)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+
+    // remove element
+    RemoveEvent(slotIndex);
+    return true;
+}
+
+int BroadcastEventsManager::GetCellIndex(const glm::vec2& position) const
+{
+    glm::ivec2 cell (glm::floor(Convert::MetersToMapUnits(position) / (float) GridCellSize));
+    cell = glm::clamp(cell, 0, GridDimensions - 1);
+    return cell.y * GridDimensions + cell.x;
+}
+
+int BroadcastEventsManager::FindClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, Pedestrian* excludeCharacter) const
+{
+    if (mEventsCount[eventType] == 0)
+        return -1;
+
+    float currentGameTime = gTimeManager.mGameTime;
+    float closestDistance2 = (maxDistance < FLT_MAX) ? (maxDistance * maxDistance) : FLT_MAX;
+    int bestIndex = -1;
+
+    const float CellSizeMeters = Convert::MapUnitsToMeters((float) GridCellSize);
+    const int centerCell = GetCellIndex(position);
+    const int centerx = centerCell % GridDimensions;
+    const int centery = centerCell / GridDimensions;
+
+    // scan grid cells ring by ring around location until remaining cells are too far
+    for (int iring = 0; iring < GridDimensions; ++iring)
     {
-        const BroadcastEvent& currEvent = mEventsList[i];
-        if (currEvent.mEventType == eventType)
+        if (iring > 0)
         {
-            ++counter;
+            float ringDistance = (iring - 1) * CellSizeMeters;
+            if ((ringDistance * ringDistance) > closestDistance2)
+                break;
+        }
 
-            float currDistance2 = glm::distance2(position, currEvent.mPosition);
-            if (i == 0) // very first element if closest by default
-            {
-                closestDistance2 = currDistance2;
+        for (int celly = centery - iring; celly <= centery + iring; ++celly)
+        {
+            if (celly < 0 || celly >= GridDimensions)
                 continue;
+
+            // only ring border cells
+            const int stepx = (celly == centery - iring || celly == centery + iring) ? 1 : std::max(iring * 2, 1);
+            for (int cellx = centerx - iring; cellx <= centerx + iring; cellx += stepx)
+            {
+                if (cellx < 0 || cellx >= GridDimensions)
+                    continue;
+
+                for (int icurr = mGridCells[eventType][celly * GridDimensions + cellx]; icurr != -1; icurr = mEventSlots[icurr].mNextInCell)
+                {
+                    const BroadcastEvent& evData = mEventSlots[icurr].mEventData;
+                    if (IsEventExpired(evData, currentGameTime))
+                        continue;
+
+                    if (excludeCharacter && (evData.mCharacter == excludeCharacter))
+                        continue;
+
+                    float currDistance2 = glm::distance2(position, evData.mPosition);
+                    if (currDistance2 <= closestDistance2)
+                    {
+                        closestDistance2 = currDistance2;
+                        bestIndex = icurr;
+                    }
+                }
             }
+        }
+    }
+    return bestIndex;
+}
 
-            if (currDistance2 < closestDistance2)
+int BroadcastEventsManager::AllocateEvent(eBroadcastEvent eventType, const glm::vec2& position)
+{
+    int slotIndex = 0;
+    if (mFreeSlots.empty())
+    {
+        slotIndex = (int) mEventSlots.size();
+        mEventSlots.emplace_back();
+    }
+    else
+    {
+        slotIndex = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        mEventSlots[slotIndex] = EventSlot();
+    }
+
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    eventSlot.mActive = true;
+    eventSlot.mEventData.mEventType = eventType;
+    eventSlot.mEventData.mPosition = position;
+    eventSlot.mCellIndex = GetCellIndex(position);
+    LinkEventToCell(slotIndex);
+
+    ++mEventsCount[eventType];
+    return slotIndex;
+}
+
+void BroadcastEventsManager::RemoveEvent(int slotIndex)
+{
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    if (!eventSlot.mActive)
+    {
+        debug_assert(false);
+        return;
+    }
+
+    UnlinkEventFromCell(slotIndex);
+
+    BroadcastEvent& evData = eventSlot.mEventData;
+    --mEventsCount[evData.mEventType];
+
+    if (GameObject* subject = evData.mSubject)
+    {
+        auto subject_iterator = mSubjectEvents.find(GetSubjectKey(evData.mEventType, subject->mObjectID));
+        if (subject_iterator != mSubjectEvents.end() && subject_iterator->second == slotIndex)
+        {
+            mSubjectEvents.erase(subject_iterator);
+        }
+    }
+    else if (evData.mEventSubject != eBroadcastEventSubject_None)
+    {
+        // subject object is already destroyed, find its record by slot
+        for (auto subject_iterator = mSubjectEvents.begin(); subject_iterator != mSubjectEvents.end(); ++subject_iterator)
+        {
+            if (subject_iterator->second == slotIndex)
             {
-                closestDistance2 = currDistance2;
-                bestIndex = i;
+                mSubjectEvents.erase(subject_iterator);
+                break;
             }
         }
     }
-    if (counter)
+
+    // event stays in timing wheel until its slot gets processed
+    eventSlot.mActive = false;
+    eventSlot.mEventData.mEventDurationTime = 0.0f;
+    eventSlot.mEventData.mSubject.reset();
+    eventSlot.mEventData.mCharacter.reset();
+    mFreeSlots.push_back(slotIndex);
+}
+
+void BroadcastEventsManager::ScheduleEventExpiry(int slotIndex)
+{
+    const BroadcastEvent& evData = mEventSlots[slotIndex].mEventData;
+    long long expiryTick = (long long) glm::ceil((evData.mEventTimestamp + evData.mEventDurationTime) / WheelTickDuration);
+    expiryTick = glm::clamp(expiryTick, mWheelTick + 1, mWheelTick + WheelSlotsCount);
+    mEventSlots[slotIndex].mExpiryTick = expiryTick;
+    mWheelSlots[expiryTick % WheelSlotsCount].push_back(slotIndex);
+}
+
+void BroadcastEventsManager::LinkEventToCell(int slotIndex)
+{
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+
+    int& cellHead = mGridCells[eventSlot.mEventData.mEventType][eventSlot.mCellIndex];
+    eventSlot.mPrevInCell = -1;
+    eventSlot.mNextInCell = cellHead;
+    if (cellHead != -1)
+    {
+        mEventSlots[cellHead].mPrevInCell = slotIndex;
+    }
+    cellHead = slotIndex;
+}
+
+void BroadcastEventsManager::UnlinkEventFromCell(int slotIndex)
+{
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    if (eventSlot.mPrevInCell != -1)
+    {
+        mEventSlots[eventSlot.mPrevInCell].mNextInCell = eventSlot.mNextInCell;
+    }
+    else
     {
-        outputEventData = mEventsList[bestIndex];
+        mGridCells[eventSlot.mEventData.mEventType][eventSlot.mCellIndex] = eventSlot.mNextInCell;
+    }
 
-        // remove element
-        mEventsList.erase(mEventsList.begin() + bestIndex);
-        return true;
+    if (eventSlot.mNextInCell != -1)
+    {
+        mEventSlots[eventSlot.mNextInCell].mPrevInCell = eventSlot.mPrevInCell;
     }
-    return false;
+    eventSlot.mPrevInCell = -1;
+    eventSlot.mNextInCell = -1;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ enum eBroadcastEvent
     eBroadcastEvent_StealCar,
     eBroadcastEvent_Explosion,
     eBroadcastEvent_CarBurns,
+    eBroadcastEvent_COUNT
 };
 
 decl_enum_strings(eBroadcastEvent);
@@ -47,6 +48,7 @@ public:
 };
 
 // Broadcast events manager
+// Events are indexed by location in per type grid, and expire through timing wheel
 class BroadcastEventsManager final: public cxx::noncopyable
 {
 public:
@@ -60,12 +62,72 @@ public:
     // Finds event with specific type but don't removes it from list
     bool PeekEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData) const;
     bool PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData) const;
+    bool PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, BroadcastEvent& outputEventData) const;
+    // Finds closest event with specific type which is not caused by specified character
+    // @param excludeCharacter: Events caused by this character are ignored
+    bool PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, Pedestrian* excludeCharacter, BroadcastEvent& outputEventData) const;
+    // Finds all events with specific type within radius in one pass, events don't get removed from list
+    // @param outputEvents: Caller provided buffer, extra events are skipped once it is full
+    // @param maxEvents: Output buffer capacity
+    // @param excludeCharacter: Events caused by this character are ignored
+    // @returns number of events written to output buffer
+    int QueryEvents(eBroadcastEvent eventType, const glm::vec2& position, float radius, BroadcastEvent* outputEvents, int maxEvents) const;
+    int QueryEvents(eBroadcastEvent eventType, const glm::vec2& position, float radius, Pedestrian* excludeCharacter, BroadcastEvent* outputEvents, int maxEvents) const;
     // Finds event with specific type and removes it from list
     bool GetEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData);
     bool GetClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData);
 
 private:
-    std::vector<BroadcastEvent> mEventsList;
+    static const int GridCellSize = 4; // map units
+    static const int GridDimensions = MAP_DIMENSIONS / GridCellSize;
+    static const int WheelSlotsCount = 64;
+
+    struct EventSlot
+    {
+    public:
+        BroadcastEvent mEventData;
+        bool mActive = false;
+        int mCellIndex = 0;
+        long long mExpiryTick = 0; // timing wheel tick when event should be checked
+        int mPrevInCell = -1; // events list within grid cell
+        int mNextInCell = -1;
+    };
+
+private:
+    int GetCellIndex(const glm::vec2& position) const;
+    int FindClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, Pedestrian* excludeCharacter) const;
+
+    int AllocateEvent(eBroadcastEvent eventType, const glm::vec2& position);
+    void RemoveEvent(int slotIndex);
+    void ScheduleEventExpiry(int slotIndex);
+
+    void LinkEventToCell(int slotIndex);
+    void UnlinkEventFromCell(int slotIndex);
+
+    inline bool IsEventExpired(const BroadcastEvent& eventData, float currentGameTime) const
+    {
+        return (eventData.mEventTimestamp + eventData.mEventDurationTime) <= currentGameTime;
+    }
+    inline unsigned long long GetSubjectKey(eBroadcastEvent eventType, GameObjectID objectID) const
+    {
+        return ((unsigned long long) eventType << 32) | objectID;
+    }
+
+private:
+    std::vector<EventSlot> mEventSlots;
+    std::vector<int> mFreeSlots;
+    int mEventsCount[eBroadcastEvent_COUNT];
+
+    // first event slot in each grid cell per event type
+    int mGridCells[eBroadcastEvent_COUNT][GridDimensions * GridDimensions];
+
+    // events bound to game objects, to update them in place
+    std::map<unsigned long long, int> mSubjectEvents;
+
+    // expiry timing wheel, events gets rescheduled if its lifetime was prolonged
+    std::vector<int> mWheelSlots[WheelSlotsCount];
+    std::vector<int> mWheelProcessList;
+    long long mWheelTick = 0;
 };
 
 extern BroadcastEventsManager gBroadcastEvents;
\ No newline at end of file
@@ -374,6 +374,9 @@ bool CarnageGame::StartScenario(const std::string& mapName)
         return false;
     }
 
+    // fonts are loaded in background while map data is processed
+    HUD::PreloadFonts();
+
     if (!gGameMap.LoadFromFile(mapName))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load map '%s'", mapName.c_str());
@@ -397,6 +400,7 @@ bool CarnageGame::StartScenario(const std::string& mapName)
     gPhysics.EnterWorld();
     gParticleManager.EnterWorld();
     gGameObjectsManager.EnterWorld();
+    gAiManager.EnterWorld();
     // temporary
     //glm::vec3 pos { 108.0f, 2.0f, 25.0f };
     //glm::vec3 pos { 14.0, 2.0f, 38.0f };
@@ -462,7 +466,7 @@ void CarnageGame::ShutdownCurrentScenario()
     {
         DeleteHumanPlayer(ihuman);
     }
-    gAiManager.ReleaseAiControllers();
+    gAiManager.ClearWorld();
     gTrafficManager.CleanupTraffic();
     gWeatherManager.ClearWorld();
     gGameObjectsManager.ClearWorld();
@@ -202,7 +202,10 @@ enum eConsoleLineType
 
 decl_enum_strings(eConsoleLineType);
 
-// defines single record in console
+// max length of single console line including terminating zero, longer messages get truncated
+const int ConsoleLineMaxLength = 1024;
+
+// defines single record in console, fixed size so it can be stored in preallocated buffers
 struct ConsoleLine
 {
 public:
@@ -210,8 +213,9 @@ public:
 
 public:
     eConsoleLineType mLineType = eConsoleLineType_Message;
-    eLogMessage mMessageCategory; // only valid if linetype is message
-    std::string mString;
+    eLogMessage mMessageCategory = eLogMessage_Info; // only valid if linetype is message
+    int mStringLength = 0;
+    char mString[ConsoleLineMaxLength] {};
 };
 
 // global constants
@@ -3,8 +3,6 @@
 #include "ConsoleVar.h"
 #include "cvars.h"
 
-static char ConsoleMessageBuffer[2048];
-
 #define VA_SCOPE_OPEN(firstArg, vaName) \
     { \
         va_list vaName {}; \
@@ -14,37 +12,308 @@ static char ConsoleMessageBuffer[2048];
         va_end(vaName); \
     }
 
+const int SinkThreadIdleSleepMs = 5;
+const int SuppressedReportIntervalMs = 1000;
+
+//////////////////////////////////////////////////////////////////////////
+// cvars
+CvarString gCvarConsoleLogFile("con_logFile", "", "Write console messages to specified file, empty to disable", CvarFlags_Archive);
+CvarInt gCvarConsoleRateLimit("con_rateLimit", 100, 0, 100000, "Max messages per second for each category except errors, 0 for unlimited", CvarFlags_Archive);
+
+//////////////////////////////////////////////////////////////////////////
+
 Console gConsole;
 
+Console::Console()
+{
+    for (unsigned int irecord = 0; irecord < LogRingCapacity; ++irecord)
+    {
+        mLogRing[irecord].mSequence.store(irecord, std::memory_order_relaxed);
+    }
+}
+
 bool Console::Initialize()
 {
+    mMaxMessagesPerSecond.store(gCvarConsoleRateLimit.mValue, std::memory_order_relaxed);
+    mLastSuppressedReport = std::chrono::steady_clock::now();
+
+    StartSinkThread();
     return true;
 }
 
 void Console::Deinit()
 {
+    StopSinkThread();
+    CloseLogFile();
+}
+
+void Console::UpdateFrame()
+{
+    if (gCvarConsoleRateLimit.IsModified())
+    {
+        mMaxMessagesPerSecond.store(gCvarConsoleRateLimit.mValue, std::memory_order_relaxed);
+        gCvarConsoleRateLimit.ClearModified();
+    }
+
+    if (gCvarConsoleLogFile.IsModified())
+    {
+        OpenLogFile(gCvarConsoleLogFile.mValue);
+        gCvarConsoleLogFile.ClearModified();
+    }
 }
 
 void Console::LogMessage(eLogMessage messageCat, const char* format, ...)
 {
+    if (!CheckRateLimit(messageCat))
+        return;
+
+    // claim free slot
+    unsigned int writeIndex = mLogRingWriteIndex.load(std::memory_order_relaxed);
+    LogRecord* logRecord = nullptr;
+    for (;;)
+    {
+        logRecord = &mLogRing[writeIndex & (LogRingCapacity - 1)];
+        const int sequenceDiff = (int) (logRecord->mSequence.load(std::memory_order_acquire) - writeIndex);
+        if (sequenceDiff == 0)
+        {
+            if (mLogRingWriteIndex.compare_exchange_weak(writeIndex, writeIndex + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (sequenceDiff < 0) // ring is full, sink does not keep up
+        {
+            mOverflowCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            writeIndex = mLogRingWriteIndex.load(std::memory_order_relaxed);
+        }
+    }
+
+    // format directly into slot
+    ConsoleLine& consoleLine = logRecord->mLine;
+    consoleLine.mLineType = eConsoleLineType_Message;
+    consoleLine.mMessageCategory = messageCat;
+
+    int stringLength = 0;
     VA_SCOPE_OPEN(format, vaList)
-    vsnprintf(ConsoleMessageBuffer, sizeof(ConsoleMessageBuffer), format, vaList);
+    stringLength = vsnprintf(consoleLine.mString, sizeof(consoleLine.mString), format, vaList);
     VA_SCOPE_CLOSE(vaList)
 
-    if (messageCat > eLogMessage_Debug)
+    if (stringLength < 0)
+    {
+        stringLength = 0;
+        consoleLine.mString[0] = 0;
+    }
+    consoleLine.mStringLength = std::min(stringLength, ConsoleLineMaxLength - 1);
+
+    // publish
+    logRecord->mSequence.store(writeIndex + 1, std::memory_order_release);
+
+    if (!mSinkThreadActive.load(std::memory_order_acquire))
     {
-        printf("%s\n", ConsoleMessageBuffer);
+        ProcessLogRecords();
     }
+}
+
+bool Console::CheckRateLimit(eLogMessage messageCat)
+{
+    const int maxMessagesPerSecond = mMaxMessagesPerSecond.load(std::memory_order_relaxed);
+    if (maxMessagesPerSecond < 1 || messageCat == eLogMessage_Error)
+        return true;
+
+    const unsigned int currentTimeWindow = (unsigned int) std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    LogRateLimit& rateLimit = mRateLimits[messageCat];
+    unsigned int timeWindow = rateLimit.mTimeWindow.load(std::memory_order_relaxed);
+    if (timeWindow != currentTimeWindow && 
+        rateLimit.mTimeWindow.compare_exchange_strong(timeWindow, currentTimeWindow, std::memory_order_relaxed))
+    {
+        rateLimit.mMessagesCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (rateLimit.mMessagesCount.fetch_add(1, std::memory_order_relaxed) < maxMessagesPerSecond)
+        return true;
+
+    rateLimit.mSuppressedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool Console::ProcessLogRecords()
+{
+    std::lock_guard<std::mutex> lock(mSinkMutex);
+
+    bool hasPendingLines = false;
+    for (;; ++mLogRingReadIndex)
+    {
+        LogRecord& logRecord = mLogRing[mLogRingReadIndex & (LogRingCapacity - 1)];
+        if (logRecord.mSequence.load(std::memory_order_acquire) != (mLogRingReadIndex + 1))
+            break;
+
+        WriteLine(logRecord.mLine);
+        // release slot for next round
+        logRecord.mSequence.store(mLogRingReadIndex + LogRingCapacity, std::memory_order_release);
+        hasPendingLines = true;
+    }
+
+    std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+    if (currentTime - mLastSuppressedReport >= std::chrono::milliseconds(SuppressedReportIntervalMs))
+    {
+        mLastSuppressedReport = currentTime;
+        ReportSuppressedMessages();
+    }
+
+    if (hasPendingLines)
+    {
+        fflush(stdout);
+        if (mLogFile)
+        {
+            fflush(mLogFile);
+        }
+    }
+    return hasPendingLines;
+}
+
+void Console::ReportSuppressedMessages()
+{
     ConsoleLine consoleLine;
     consoleLine.mLineType = eConsoleLineType_Message;
-    consoleLine.mMessageCategory = messageCat;
-    consoleLine.mString = ConsoleMessageBuffer;
-    mLines.push_back(std::move(consoleLine));
+    consoleLine.mMessageCategory = eLogMessage_Warning;
+
+    for (int icategory = 0; icategory < eLogMessage_COUNT; ++icategory)
+    {
+        const int suppressedCount = mRateLimits[icategory].mSuppressedCount.exchange(0, std::memory_order_relaxed);
+        if (suppressedCount == 0)
+            continue;
+
+        consoleLine.mStringLength = snprintf(consoleLine.mString, sizeof(consoleLine.mString), 
+            "%d %s messages suppressed by rate limit", suppressedCount, cxx::enum_to_string((eLogMessage) icategory));
+        consoleLine.mStringLength = std::min(consoleLine.mStringLength, ConsoleLineMaxLength - 1);
+        WriteLine(consoleLine);
+    }
+
+    const int overflowCount = mOverflowCount.exchange(0, std::memory_order_relaxed);
+    if (overflowCount > 0)
+    {
+        consoleLine.mStringLength = snprintf(consoleLine.mString, sizeof(consoleLine.mString), 
+            "%d messages dropped due to log buffer overflow", overflowCount);
+        consoleLine.mStringLength = std::min(consoleLine.mStringLength, ConsoleLineMaxLength - 1);
+        WriteLine(consoleLine);
+    }
+}
+
+void Console::WriteLine(const ConsoleLine& consoleLine)
+{
+    if (consoleLine.mMessageCategory > eLogMessage_Debug)
+    {
+        fwrite(consoleLine.mString, 1, consoleLine.mStringLength, stdout);
+        fputc('\n', stdout);
+    }
+
+    if (mLogFile)
+    {
+        fwrite(consoleLine.mString, 1, consoleLine.mStringLength, mLogFile);
+        fputc('\n', mLogFile);
+    }
+
+    std::lock_guard<std::mutex> lock(mHistoryMutex);
+
+    int historyIndex = (mHistoryStart + mHistoryLinesCount) % MaxHistoryLines;
+    if (mHistoryLinesCount < MaxHistoryLines)
+    {
+        ++mHistoryLinesCount;
+    }
+    else
+    {
+        mHistoryStart = (mHistoryStart + 1) % MaxHistoryLines; // overwrite oldest
+    }
+
+    ConsoleLine& historyLine = mHistoryLines[historyIndex];
+    historyLine.mLineType = consoleLine.mLineType;
+    historyLine.mMessageCategory = consoleLine.mMessageCategory;
+    historyLine.mStringLength = consoleLine.mStringLength;
+    ::memcpy(historyLine.mString, consoleLine.mString, consoleLine.mStringLength);
+    historyLine.mString[consoleLine.mStringLength] = 0;
+}
+
+void Console::OpenLogFile(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> sinkLock(mSinkMutex);
+
+    if (mLogFile)
+    {
+        fclose(mLogFile);
+        mLogFile = nullptr;
+    }
+
+    if (filePath.empty())
+        return;
+
+    mLogFile = fopen(filePath.c_str(), "w");
+    if (mLogFile == nullptr)
+        return;
+
+    // lines logged before file was opened are still kept in history
+    std::lock_guard<std::mutex> historyLock(mHistoryMutex);
+    for (int iline = 0; iline < mHistoryLinesCount; ++iline)
+    {
+        const ConsoleLine& historyLine = mHistoryLines[(mHistoryStart + iline) % MaxHistoryLines];
+        fwrite(historyLine.mString, 1, historyLine.mStringLength, mLogFile);
+        fputc('\n', mLogFile);
+    }
+    fflush(mLogFile);
+}
+
+void Console::CloseLogFile()
+{
+    std::lock_guard<std::mutex> lock(mSinkMutex);
+
+    if (mLogFile)
+    {
+        fclose(mLogFile);
+        mLogFile = nullptr;
+    }
+}
+
+void Console::StartSinkThread()
+{
+#ifndef __EMSCRIPTEN__
+    debug_assert(!mSinkThread.joinable());
+
+    mSinkThreadQuit = false;
+    mSinkThread = std::thread([this]()
+        {
+            while (!mSinkThreadQuit.load(std::memory_order_acquire))
+            {
+                if (!ProcessLogRecords())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(SinkThreadIdleSleepMs));
+                }
+            }
+            // write remaining lines
+            ProcessLogRecords();
+        });
+    mSinkThreadActive.store(true, std::memory_order_release);
+#endif // __EMSCRIPTEN__
+}
+
+void Console::StopSinkThread()
+{
+    if (mSinkThread.joinable())
+    {
+        // from now on messages are written by logging thread
+        mSinkThreadActive.store(false, std::memory_order_release);
+        mSinkThreadQuit.store(true, std::memory_order_release);
+        mSinkThread.join();
+    }
 }
 
 void Console::Flush()
 {
-    mLines.clear();
+    std::lock_guard<std::mutex> lock(mHistoryMutex);
+    mHistoryStart = 0;
+    mHistoryLinesCount = 0;
 }
 
 void Console::ExecuteCommands(const char* commands)
@@ -77,7 +346,7 @@ void Console::ExecuteCommands(const char* commands)
                 cxx::trim(commandParams);
             }
             cxx::trim(commandName);
-            if (commandParams.empty()) // print cvar info
+            if (commandParams.empty() && !consoleVariable->IsCommand()) // print cvar info
             {
                 std::string currValue;
                 consoleVariable->GetPrintableValue(currValue);
@@ -5,26 +5,45 @@
 // forwards
 class Cvar;
 
-// represents console system that handles debug commands
+// represents console system that handles debug commands,
+// messages can be logged from any thread: lines are formatted in place into fixed lock-free ring buffer,
+// then sink thread writes them to stdout and log file and moves to bounded history
 class Console final: public cxx::noncopyable
 {
 public:
     // readonly
-    std::deque<ConsoleLine> mLines;
     std::vector<Cvar*> mCvarsList;
 
 public:
+    Console();
+
     // Setup internal resources, returns false on error
     bool Initialize();
     void Deinit();
     void RegisterGlobalVariables();
 
-    // Write text message in console
+    // Apply console cvars changes, main thread only
+    void UpdateFrame();
+
+    // Write text message in console, can be called from any thread,
+    // message is dropped if ring buffer is full or category rate limit exceeded
     void LogMessage(eLogMessage messageCat, const char* format, ...);
 
     // Clear all console text messages
     void Flush();
 
+    // Visit recent console lines from oldest to newest, history is locked during iteration
+    // @param visitProc: Procedure which receives const ConsoleLine&
+    template<typename TVisitProc>
+    inline void VisitHistoryLines(TVisitProc visitProc)
+    {
+        std::lock_guard<std::mutex> lock(mHistoryMutex);
+        for (int iline = 0; iline < mHistoryLinesCount; ++iline)
+        {
+            visitProc(mHistoryLines[(mHistoryStart + iline) % MaxHistoryLines]);
+        }
+    }
+
     // parse and execute commands
     // @param commands: Commands string
     void ExecuteCommands(const char* commands);
@@ -33,6 +52,64 @@ public:
     // @returns false on error
     bool RegisterVariable(Cvar* consoleVariable);
     bool UnregisterVariable(Cvar* consoleVariable);
+
+private:
+    static const unsigned int LogRingCapacity = 512; // power of two
+    static const int MaxHistoryLines = 512;
+
+    // ring buffer slot, sequence number tells whether slot is free, being written or ready to consume
+    struct LogRecord
+    {
+    public:
+        std::atomic<unsigned int> mSequence;
+        ConsoleLine mLine;
+    };
+
+    // per category messages counter within current second
+    struct LogRateLimit
+    {
+    public:
+        std::atomic<unsigned int> mTimeWindow {0};
+        std::atomic<int> mMessagesCount {0};
+        std::atomic<int> mSuppressedCount {0};
+    };
+
+    bool CheckRateLimit(eLogMessage messageCat);
+
+    // write pending lines to outputs, only one consumer at a time is allowed
+    // @returns false if there were no pending lines
+    bool ProcessLogRecords();
+    void ReportSuppressedMessages();
+    void WriteLine(const ConsoleLine& consoleLine);
+
+    void OpenLogFile(const std::string& filePath);
+    void CloseLogFile();
+
+    void StartSinkThread();
+    void StopSinkThread();
+
+private:
+    LogRecord mLogRing[LogRingCapacity];
+    alignas(64) std::atomic<unsigned int> mLogRingWriteIndex {0};
+    alignas(64) unsigned int mLogRingReadIndex = 0; // guarded by sink mutex
+
+    LogRateLimit mRateLimits[eLogMessage_COUNT];
+    std::atomic<int> mMaxMessagesPerSecond {0};
+    std::atomic<int> mOverflowCount {0};
+
+    // sink state
+    std::mutex mSinkMutex;
+    std::thread mSinkThread;
+    std::atomic<bool> mSinkThreadActive {false};
+    std::atomic<bool> mSinkThreadQuit {false};
+    std::chrono::steady_clock::time_point mLastSuppressedReport;
+    FILE* mLogFile = nullptr;
+
+    // bounded history, oldest lines get overwritten
+    std::mutex mHistoryMutex;
+    ConsoleLine mHistoryLines[MaxHistoryLines];
+    int mHistoryStart = 0;
+    int mHistoryLinesCount = 0;
 };
 
 extern Console gConsole;
\ No newline at end of file
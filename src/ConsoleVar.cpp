@@ -351,4 +351,33 @@ bool CvarVec3::DeserializeValue(const std::string& input, bool& valueChanged)
         mValue = newValue;
     }
     return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+CvarCommand::CvarCommand(const std::string& cvarName, CommandProc commandProc, const std::string& description, CvarFlags cvarFlags)
+    : Cvar(cvarName, description, cvarFlags | CvarFlags_CvarCommand)
+    , mCommandProc(commandProc)
+{
+    debug_assert(mCommandProc);
+}
+
+void CvarCommand::GetPrintableValue(std::string& output) const
+{
+    output.clear();
+}
+
+void CvarCommand::GetPrintableDefaultValue(std::string& output) const
+{
+    output.clear();
+}
+
+bool CvarCommand::DeserializeValue(const std::string& input, bool& valueChanged)
+{
+    valueChanged = false;
+    if (mCommandProc)
+    {
+        mCommandProc(input);
+    }
+    return true;
 }
\ No newline at end of file
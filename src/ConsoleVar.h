@@ -20,6 +20,7 @@ enum CvarFlags: unsigned long
     CvarFlags_CvarPoint          = (1 << 14), // 2 ints
     CvarFlags_CvarVec3           = (1 << 15), // 3 floats
     CvarFlags_CVarEnum           = (1 << 16), // int
+    CvarFlags_CvarCommand        = (1 << 17), // no value, executes procedure
 };
 decl_enum_as_flags(CvarFlags)
 
@@ -76,6 +77,7 @@ public:
     bool IsEnum()       const { return (mCvarFlags & CvarFlags_CVarEnum)   > 0; }
     bool IsInt()        const { return (mCvarFlags & CvarFlags_CvarInt)    > 0; }
     bool IsFloat()      const { return (mCvarFlags & CvarFlags_CvarFloat)  > 0; }
+    bool IsCommand()    const { return (mCvarFlags & CvarFlags_CvarCommand) > 0; }
 
 protected:
     Cvar(const std::string& cvarName, const std::string& description, CvarFlags cvarFlags);
@@ -233,6 +235,28 @@ protected:
 
 //////////////////////////////////////////////////////////////////////////
 
+// Console command, value string is passed as parameters to command procedure
+class CvarCommand: public Cvar
+{
+public:
+    using CommandProc = void (*)(const std::string& commandParams);
+
+    CommandProc mCommandProc = nullptr;
+
+public:
+    CvarCommand(const std::string& cvarName, CommandProc commandProc, const std::string& description, CvarFlags cvarFlags);
+
+protected:
+    // Get current value string representation
+    void GetPrintableValue(std::string& output) const override;
+    void GetPrintableDefaultValue(std::string& output) const override;
+
+    // Execute command with input string as parameters
+    bool DeserializeValue(const std::string& input, bool& valueChanged) override;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 template<typename TEnum>
 class CvarEnum: public Cvar
 {
@@ -40,9 +40,9 @@ void ConsoleWindow::DoUI(ImGuiIO& imguiContext)
         ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoBackground);
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4,1));
 
-    for (const ConsoleLine& currentLine: gConsole.mLines)
+    gConsole.VisitHistoryLines([](const ConsoleLine& currentLine)
     {
-        const char* item = currentLine.mString.c_str();
+        const char* item = currentLine.mString;
 
         bool pop_color = false;
         if (currentLine.mMessageCategory == eLogMessage_Error) 
@@ -60,12 +60,12 @@ void ConsoleWindow::DoUI(ImGuiIO& imguiContext)
             ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.7f, 0.7f, 1.0f)); 
             pop_color = true; 
         }
-        ImGui::TextUnformatted(item);
+        ImGui::TextUnformatted(item, item + currentLine.mStringLength);
         if (pop_color)
         {
             ImGui::PopStyleColor();
         }
-    }
+    });
 
     if (mScrollToBottom || (mAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()))
     {
@@ -1,15 +1,47 @@
 #include "stdafx.h"
 #include "FileSystem.h"
 #include "cvars.h"
+#include "lz4_utils.h"
 
 //////////////////////////////////////////////////////////////////////////
 
 static const std::string GTA1MapFileExtension = ".CMP";
 
+// pack file layout, all values are little endian:
+// header: signature, version, entries count, entries table offset
+// entry: data offset, packed size, unpacked size, flags, name length, name characters without terminating zero
+static const unsigned int PackFileSignature = 0x50443343; // 'C3DP'
+static const unsigned int PackFileVersion = 1;
+static const unsigned int PackFileHeaderSize = 16;
+static const unsigned int PackEntryHeaderSize = 16;
+static const unsigned short PackEntryFlags_LZ4 = (1 << 0);
+
 //////////////////////////////////////////////////////////////////////////
 
 // cvars
 CvarString gCvarGtaDataPath("g_gtadata", "", "GTA data location", CvarFlags_Archive | CvarFlags_Init | CvarFlags_Hidden);
+CvarString gCvarPackFile("g_packfile", "", "Game data pack file to mount", CvarFlags_Archive | CvarFlags_Init);
+
+//////////////////////////////////////////////////////////////////////////
+
+FileInputStream::FileInputStream()
+    : std::istream(nullptr)
+{
+}
+
+bool FileInputStream::IsOpen() const
+{
+    return mIsMemoryOpen || mFileBuffer.is_open();
+}
+
+void FileInputStream::Close()
+{
+    mFileBuffer.close();
+    mMemoryBuffer.set_memory(nullptr, nullptr);
+    mUnpackedData.clear();
+    mIsMemoryOpen = false;
+    rdbuf(nullptr);
+}
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -28,60 +60,88 @@ bool FileSystem::Initialize()
     AddSearchPlace(mWorkingDirectoryPath);
 
     gConsole.LogMessage(eLogMessage_Info, "Working directory: '%s'", mWorkingDirectoryPath.c_str());
+
+    StartIoThread();
     return true;
 }
 
 void FileSystem::Deinit()
 {
+    StopIoThread();
+
     mExecutablePath.clear();
     mWorkingDirectoryPath.clear();
     mGameMapsList.clear();
+    mFilesIndex.clear();
+    mFilesIndexBuilt = false;
+    mPackFile.close();
 }
 
-bool FileSystem::OpenBinaryFile(const std::string& objectName, std::ifstream& instream)
+bool FileSystem::OpenBinaryFile(const std::string& objectName, FileInputStream& instream)
 {
-    instream.close();
+    instream.Close();
 
-    if (cxx::is_file_exists(objectName))
+    const FileEntry* fileEntry = FindFileEntry(objectName);
+    if (fileEntry && fileEntry->mFullPath.empty())
     {
-        instream.open(objectName, std::ios::in | std::ios::binary);
-        return instream.is_open();
+        char* dataPointer = (char*) fileEntry->mPackedData;
+        if (fileEntry->mCompressed)
+        {
+            instream.mUnpackedData.resize(fileEntry->mUnpackedSize);
+            if (!UnpackFileEntry(*fileEntry, instream.mUnpackedData.data()))
+                return false;
+
+            dataPointer = (char*) instream.mUnpackedData.data();
+        }
+        instream.mMemoryBuffer.set_memory(dataPointer, dataPointer + fileEntry->mUnpackedSize);
+        instream.mIsMemoryOpen = true;
+        instream.rdbuf(&instream.mMemoryBuffer);
+        return true;
     }
 
-    std::string pathBuffer;
-    // search file in search places
-    for (const std::string& currPlace: mSearchPlaces)
+    std::string filePath;
+    if (fileEntry)
     {
-        pathBuffer = cxx::va("%s/%s", currPlace.c_str(), objectName.c_str());
-        if (cxx::is_file_exists(pathBuffer))
-        {
-            instream.open(pathBuffer, std::ios::in | std::ios::binary);
-        }
+        filePath = fileEntry->mFullPath;
+    }
+    else if (!GetFullPathToFile(objectName, filePath))
+    {
+        return false;
     }
-    return instream.is_open();
+
+    if (!instream.mFileBuffer.open(filePath, std::ios::in | std::ios::binary))
+        return false;
+
+    instream.rdbuf(&instream.mFileBuffer);
+    return true;
 }
 
-bool FileSystem::OpenTextFile(const std::string& objectName, std::ifstream& instream)
+bool FileSystem::OpenTextFile(const std::string& objectName, FileInputStream& instream)
 {
-    instream.close();
+    instream.Close();
 
-    if (cxx::is_file_exists(objectName))
+    const FileEntry* fileEntry = FindFileEntry(objectName);
+    if (fileEntry && fileEntry->mFullPath.empty())
     {
-        instream.open(objectName, std::ios::in);
-        return instream.is_open();
+        // pack content is binary, line endings are handled by reader
+        return OpenBinaryFile(objectName, instream);
     }
 
-    std::string pathBuffer;
-    // search file in search places
-    for (const std::string& currPlace: mSearchPlaces)
+    std::string filePath;
+    if (fileEntry)
     {
-        pathBuffer = cxx::va("%s/%s", currPlace.c_str(), objectName.c_str());
-        if (cxx::is_file_exists(pathBuffer))
-        {
-            instream.open(pathBuffer, std::ios::in);
-        }
+        filePath = fileEntry->mFullPath;
+    }
+    else if (!GetFullPathToFile(objectName, filePath))
+    {
+        return false;
     }
-    return instream.is_open();
+
+    if (!instream.mFileBuffer.open(filePath, std::ios::in))
+        return false;
+
+    instream.rdbuf(&instream.mFileBuffer);
+    return true;
 }
 
 bool FileSystem::CreateBinaryFile(const std::string& objectName, std::ofstream& outstream)
@@ -136,6 +196,9 @@ bool FileSystem::IsDirectoryExists(const std::string& objectName)
 
 bool FileSystem::IsFileExists(const std::string& objectName)
 {
+    if (FindFileEntry(objectName))
+        return true;
+
     if (cxx::is_file_exists(objectName))
         return true;
 
@@ -154,13 +217,17 @@ bool FileSystem::ReadTextFile(const std::string& objectName, std::string& output
 {
     output.clear();
 
-    std::ifstream fileStream;
+    FileInputStream fileStream;
     if (!OpenTextFile(objectName, fileStream))
         return false;
 
     std::string stringLine {};
     while (std::getline(fileStream, stringLine, '\n'))
     {
+        if (!stringLine.empty() && stringLine.back() == '\r')
+        {
+            stringLine.pop_back();
+        }
         output.append(stringLine);
         output.append("\n");
     }
@@ -171,7 +238,27 @@ bool FileSystem::ReadBinaryFile(const std::string& objectName, std::vector<unsig
 {
     output.clear();
 
-    std::ifstream fileStream;
+    // pack entry content is copied directly
+    const FileEntry* fileEntry = FindFileEntry(objectName);
+    if (fileEntry && fileEntry->mFullPath.empty())
+    {
+        output.resize(fileEntry->mUnpackedSize);
+        if (fileEntry->mCompressed)
+        {
+            if (!UnpackFileEntry(*fileEntry, output.data()))
+            {
+                output.clear();
+                return false;
+            }
+        }
+        else if (fileEntry->mUnpackedSize > 0)
+        {
+            memcpy(output.data(), fileEntry->mPackedData, fileEntry->mUnpackedSize);
+        }
+        return true;
+    }
+
+    FileInputStream fileStream;
     if (!OpenBinaryFile(objectName, fileStream))
         return false;
 
@@ -188,6 +275,144 @@ bool FileSystem::ReadBinaryFile(const std::string& objectName, std::vector<unsig
     return true;
 }
 
+FileReadFuture FileSystem::ReadBinaryFileAsync(const std::string& objectName, eFileRequestPriority priority)
+{
+    std::unique_lock<std::mutex> requestsLock(mRequestsMutex);
+
+    FileReadRequest* readRequest = QueueReadRequest(objectName, priority);
+    FileReadFuture readFuture = readRequest->mFuture;
+
+#ifdef __EMSCRIPTEN__
+    // there is no io thread, service request immediately
+    while (ProcessReadRequest(requestsLock)) {}
+#endif
+    return readFuture;
+}
+
+void FileSystem::RaiseReadRequestPriority(const std::string& objectName, eFileRequestPriority priority)
+{
+    std::lock_guard<std::mutex> requestsLock(mRequestsMutex);
+
+    cxx::icase_eq isSameName;
+    for (FileReadRequest* currRequest: mPendingRequests)
+    {
+        if (isSameName(currRequest->mObjectName, objectName))
+        {
+            currRequest->mPriority = std::max(currRequest->mPriority, priority);
+            break;
+        }
+    }
+}
+
+FileSystem::FileReadRequest* FileSystem::QueueReadRequest(const std::string& objectName, eFileRequestPriority priority)
+{
+    // merge with request which is not serviced yet, content will be loaded once
+    cxx::icase_eq isSameName;
+    for (FileReadRequest* currRequest: mPendingRequests)
+    {
+        if (isSameName(currRequest->mObjectName, objectName))
+        {
+            currRequest->mPriority = std::max(currRequest->mPriority, priority);
+            return currRequest;
+        }
+    }
+
+    // request which is currently in progress can be shared as well
+    if (mActiveRequest && isSameName(mActiveRequest->mObjectName, objectName))
+        return mActiveRequest;
+
+    FileReadRequest* readRequest = new FileReadRequest;
+    readRequest->mObjectName = objectName;
+    readRequest->mPriority = priority;
+    readRequest->mSequenceNumber = mRequestsCounter++;
+    readRequest->mFuture = readRequest->mPromise.get_future().share();
+    mPendingRequests.push_back(readRequest);
+    mRequestsCondition.notify_all();
+    return readRequest;
+}
+
+bool FileSystem::ProcessReadRequest(std::unique_lock<std::mutex>& requestsLock)
+{
+    if (mPendingRequests.empty())
+        return false;
+
+    auto request_iterator = std::max_element(mPendingRequests.begin(), mPendingRequests.end(), 
+        [](const FileReadRequest* requestA, const FileReadRequest* requestB)
+        {
+            if (requestA->mPriority != requestB->mPriority)
+                return requestA->mPriority < requestB->mPriority;
+
+            return requestA->mSequenceNumber > requestB->mSequenceNumber;
+        });
+
+    FileReadRequest* readRequest = *request_iterator;
+    mPendingRequests.erase(request_iterator);
+    mActiveRequest = readRequest;
+
+    requestsLock.unlock();
+
+    std::shared_ptr<FileReadResult> readResult = std::make_shared<FileReadResult>();
+    readResult->mSuccess = ReadBinaryFile(readRequest->mObjectName, readResult->mContent);
+    readRequest->mPromise.set_value(readResult);
+
+    requestsLock.lock();
+
+    mActiveRequest = nullptr;
+    delete readRequest;
+    mRequestsCondition.notify_all();
+    return true;
+}
+
+void FileSystem::StartIoThread()
+{
+#ifndef __EMSCRIPTEN__
+    debug_assert(!mIoThread.joinable());
+
+    mIoThreadQuit = false;
+    mIoThread = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> requestsLock(mRequestsMutex);
+            for (;;)
+            {
+                mRequestsCondition.wait(requestsLock, [this]()
+                    {
+                        return mIoThreadQuit || !mPendingRequests.empty();
+                    });
+                // pending requests are serviced before quit
+                if (!ProcessReadRequest(requestsLock))
+                    break;
+            }
+        });
+#endif // __EMSCRIPTEN__
+}
+
+void FileSystem::StopIoThread()
+{
+    if (mIoThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> requestsLock(mRequestsMutex);
+            mIoThreadQuit = true;
+        }
+        mRequestsCondition.notify_all();
+        mIoThread.join();
+    }
+}
+
+void FileSystem::WaitAsyncRequests()
+{
+    std::unique_lock<std::mutex> requestsLock(mRequestsMutex);
+    if (!mIoThread.joinable())
+    {
+        while (ProcessReadRequest(requestsLock)) {}
+        return;
+    }
+    mRequestsCondition.wait(requestsLock, [this]()
+        {
+            return mPendingRequests.empty() && mActiveRequest == nullptr;
+        });
+}
+
 void FileSystem::AddSearchPlace(const std::string& searchPlace)
 {
     for (const std::string& currPlace: mSearchPlaces)
@@ -196,11 +421,25 @@ void FileSystem::AddSearchPlace(const std::string& searchPlace)
             return;
     }
 
+    WaitAsyncRequests();
+
     mSearchPlaces.emplace_back(searchPlace);
+
+    if (mFilesIndexBuilt)
+    {
+        IndexSearchPlace(searchPlace);
+    }
 }
 
 bool FileSystem::GetFullPathToFile(const std::string& objectName, std::string& fullPath) const
 {
+    const FileEntry* fileEntry = FindFileEntry(objectName);
+    if (fileEntry && !fileEntry->mFullPath.empty())
+    {
+        fullPath = fileEntry->mFullPath;
+        return true;
+    }
+
     if (cxx::is_file_exists(objectName))
     {
         fullPath = objectName;
@@ -262,6 +501,25 @@ bool FileSystem::SetupGtaDataLocation()
         GetFullPathToDirectory(gCvarCurrentBaseDir.mValue, gCvarCurrentBaseDir.mValue);
         gFiles.AddSearchPlace(gCvarCurrentBaseDir.mValue);
 
+        // build files index once, later lookups will not query file system
+        if (!mFilesIndexBuilt)
+        {
+            for (const std::string& currSearchPlace: mSearchPlaces)
+            {
+                IndexSearchPlace(currSearchPlace);
+            }
+            mFilesIndexBuilt = true;
+            gConsole.LogMessage(eLogMessage_Info, "Indexed files: %d", (int) mFilesIndex.size());
+        }
+
+        if (!gCvarPackFile.mValue.empty() && !mPackFile.is_open())
+        {
+            if (!MountPackFile(gCvarPackFile.mValue))
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Cannot mount pack file '%s'", gCvarPackFile.mValue.c_str());
+            }
+        }
+
         if (ScanGtaMaps())
         {
             gConsole.LogMessage(eLogMessage_Info, "Found gta maps:");
@@ -286,20 +544,152 @@ bool FileSystem::ScanGtaMaps()
 {
     mGameMapsList.clear();
 
-    for (const std::string& currSearchPlace: mSearchPlaces)
+    // maps are located in root of search places or pack
+    for (const auto& currEntry: mFilesIndex)
     {
-        cxx::enum_files(currSearchPlace, [this](const std::string& curr)
+        const std::string& currName = currEntry.first;
+        if (currName.find('/') != std::string::npos)
+            continue;
+
+        if (cxx::get_file_extension(currName) == GTA1MapFileExtension)
         {
-            if (cxx::get_file_extension(curr) == GTA1MapFileExtension)
-            {
-                mGameMapsList.push_back(curr);  
-            }
-        });
+            mGameMapsList.push_back(currName);
+        }
     }
+    std::sort(mGameMapsList.begin(), mGameMapsList.end());
 
     return !mGameMapsList.empty();
 }
 
+void FileSystem::IndexSearchPlace(const std::string& searchPlace)
+{
+    cxx::enum_files_recursive(searchPlace, [this, &searchPlace](const std::string& curr)
+    {
+        FileEntry fileEntry;
+        fileEntry.mFullPath = searchPlace + "/" + curr;
+        mFilesIndex.emplace(curr, std::move(fileEntry));
+    });
+}
+
+const FileSystem::FileEntry* FileSystem::FindFileEntry(const std::string& objectName) const
+{
+    if (mFilesIndex.empty())
+        return nullptr;
+
+    auto find_iterator = mFilesIndex.find(objectName);
+    if (find_iterator != mFilesIndex.end())
+        return &find_iterator->second;
+
+    // index keys are relative paths with forward slashes
+    if (objectName.find('\\') != std::string::npos || cxx::has_prefix(objectName.c_str(), "./"))
+    {
+        std::string normalizedName = objectName;
+        std::replace(normalizedName.begin(), normalizedName.end(), '\\', '/');
+        while (cxx::has_prefix(normalizedName.c_str(), "./"))
+        {
+            normalizedName.erase(0, 2);
+        }
+        find_iterator = mFilesIndex.find(normalizedName);
+        if (find_iterator != mFilesIndex.end())
+            return &find_iterator->second;
+    }
+    return nullptr;
+}
+
+bool FileSystem::MountPackFile(const std::string& packFileName)
+{
+    if (mPackFile.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Pack file is already mounted");
+        return false;
+    }
+
+    std::string packFilePath;
+    if (!GetFullPathToFile(packFileName, packFilePath))
+        return false;
+
+    WaitAsyncRequests();
+
+    if (!mPackFile.open(packFilePath))
+        return false;
+
+    const unsigned char* packData = mPackFile.data();
+    const size_t packSize = mPackFile.size();
+
+    auto ReadUInt32 = [packData](size_t offset) -> unsigned int
+    {
+        return packData[offset] | (packData[offset + 1] << 8) | (packData[offset + 2] << 16) | ((unsigned int) packData[offset + 3] << 24);
+    };
+    auto ReadUInt16 = [packData](size_t offset) -> unsigned short
+    {
+        return (unsigned short) (packData[offset] | (packData[offset + 1] << 8));
+    };
+
+    if (packSize < PackFileHeaderSize || ReadUInt32(0) != PackFileSignature || ReadUInt32(4) != PackFileVersion)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Unknown pack file format '%s'", packFileName.c_str());
+        mPackFile.close();
+        return false;
+    }
+
+    const unsigned int entriesCount = ReadUInt32(8);
+
+    // validate all entries first, so that broken pack does not leave partially mounted content
+    std::vector<std::pair<std::string, FileEntry>> packEntries;
+    packEntries.reserve(entriesCount);
+
+    size_t entryOffset = ReadUInt32(12);
+    for (unsigned int ientry = 0; ientry < entriesCount; ++ientry)
+    {
+        if (entryOffset + PackEntryHeaderSize > packSize)
+            break;
+
+        FileEntry fileEntry;
+        unsigned int dataOffset = ReadUInt32(entryOffset);
+        fileEntry.mPackedSize = ReadUInt32(entryOffset + 4);
+        fileEntry.mUnpackedSize = ReadUInt32(entryOffset + 8);
+        fileEntry.mCompressed = (ReadUInt16(entryOffset + 12) & PackEntryFlags_LZ4) > 0;
+
+        unsigned int nameLength = ReadUInt16(entryOffset + 14);
+        entryOffset += PackEntryHeaderSize;
+        if (entryOffset + nameLength > packSize || (size_t) dataOffset + fileEntry.mPackedSize > packSize ||
+            (!fileEntry.mCompressed && fileEntry.mPackedSize != fileEntry.mUnpackedSize))
+        {
+            break;
+        }
+        fileEntry.mPackedData = packData + dataOffset;
+        packEntries.emplace_back(std::string((const char*) packData + entryOffset, nameLength), fileEntry);
+        entryOffset += nameLength;
+    }
+
+    if (packEntries.size() != entriesCount)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Pack file '%s' is corrupted", packFileName.c_str());
+        mPackFile.close();
+        return false;
+    }
+
+    // pack entries override loose files
+    for (auto& currEntry: packEntries)
+    {
+        mFilesIndex[currEntry.first] = currEntry.second;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Mounted pack file '%s', entries: %d", packFileName.c_str(), (int) entriesCount);
+    return true;
+}
+
+bool FileSystem::UnpackFileEntry(const FileEntry& fileEntry, unsigned char* outputData) const
+{
+    debug_assert(fileEntry.mCompressed);
+    if (!cxx::lz4_decompress_block(fileEntry.mPackedData, fileEntry.mPackedSize, outputData, fileEntry.mUnpackedSize))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot unpack file data");
+        return false;
+    }
+    return true;
+}
+
 bool FileSystem::ReadConfig(const std::string& filePath, cxx::json_document& configDocument)
 {
     std::string configContent;
@@ -1,5 +1,41 @@
 #pragma once
 
+// Input stream over file content, data comes either from loose file or from mounted pack file
+class FileInputStream final: public std::istream
+{
+    friend class FileSystem;
+
+public:
+    FileInputStream();
+
+    bool IsOpen() const;
+    void Close();
+
+private:
+    std::filebuf mFileBuffer;
+    cxx::memory_istream mMemoryBuffer;
+    std::vector<unsigned char> mUnpackedData; // compressed pack entry content
+    bool mIsMemoryOpen = false;
+};
+
+// async read request priority, higher priority requests are serviced first
+enum eFileRequestPriority
+{
+    eFileRequestPriority_Low, // prefetch
+    eFileRequestPriority_Normal,
+    eFileRequestPriority_High, // content is required right away
+};
+
+// async read request result, shared by all requests to same file which were merged
+struct FileReadResult
+{
+public:
+    bool mSuccess = false;
+    std::vector<unsigned char> mContent;
+};
+
+using FileReadFuture = std::shared_future<std::shared_ptr<const FileReadResult>>;
+
 // file system manager
 class FileSystem final: public cxx::noncopyable
 {
@@ -24,11 +60,15 @@ public:
     // @param searchPlace: Path
     void AddSearchPlace(const std::string& searchPlace);
 
+    // Mount pack file, its content overrides files within search places
+    // @param packFileName: Pack file name
+    bool MountPackFile(const std::string& packFileName);
+
     // Open text or binary file stream for reading operations
     // @param objectName: File name
     // @param instream: Output stream
-    bool OpenBinaryFile(const std::string& objectName, std::ifstream& instream);
-    bool OpenTextFile(const std::string& objectName, std::ifstream& instream);
+    bool OpenBinaryFile(const std::string& objectName, FileInputStream& instream);
+    bool OpenTextFile(const std::string& objectName, FileInputStream& instream);
 
     // Create text or binary file stream for write operations
     bool CreateBinaryFile(const std::string& objectName, std::ofstream& outstream);
@@ -41,6 +81,19 @@ public:
 
     // Load whole binary file content to std vector
     bool ReadBinaryFile(const std::string& objectName, std::vector<unsigned char>& output);
+
+    // Queue loading of whole binary file content on io thread,
+    // request to same file which is not serviced yet will be reused and its priority raised
+    // @param objectName: File name
+    // @param priority: Request priority
+    // @returns future which becomes ready once content is loaded
+    FileReadFuture ReadBinaryFileAsync(const std::string& objectName, eFileRequestPriority priority);
+
+    // Raise priority of request which is not serviced yet, should be done before waiting for its future
+    // so request does not wait behind less important ones
+    // @param objectName: File name
+    // @param priority: New request priority, lower value is ignored
+    void RaiseReadRequestPriority(const std::string& objectName, eFileRequestPriority priority);
     
     // Load or save json config document
     bool ReadConfig(const std::string& filePath, cxx::json_document& configDocument);
@@ -54,15 +107,77 @@ public:
     // @param objectName: Directory name
     bool IsDirectoryExists(const std::string& objectName);
 
-    // Find file within search places and get full path to it
+    // Find file within search places and get full path to it, files within pack has no full path
     // @param objectName: File name
     // @param fullPath: Out full path
     bool GetFullPathToFile(const std::string& objectName, std::string& fullPath) const;
     bool GetFullPathToDirectory(const std::string& objectName, std::string& fullPath) const;
 
+private:
+    // indexed file, name lookup ignores case
+    struct FileEntry
+    {
+    public:
+        std::string mFullPath; // loose file location, empty for pack entry
+        const unsigned char* mPackedData = nullptr; // pack entry content
+        unsigned int mPackedSize = 0;
+        unsigned int mUnpackedSize = 0;
+        bool mCompressed = false;
+    };
+
+    using FilesIndex = std::unordered_map<std::string, FileEntry, cxx::icase_hashfunc, cxx::icase_eq>;
+
+    // async read request
+    struct FileReadRequest
+    {
+    public:
+        std::string mObjectName;
+        eFileRequestPriority mPriority = eFileRequestPriority_Normal;
+        unsigned int mSequenceNumber = 0; // keeps requests order within same priority
+        std::promise<std::shared_ptr<const FileReadResult>> mPromise;
+        FileReadFuture mFuture;
+    };
+
 private:
     // Gather all gta maps within gamedata
     bool ScanGtaMaps();
+
+    // Scan search place files and add them to index, existing entries are kept
+    void IndexSearchPlace(const std::string& searchPlace);
+
+    // Find indexed file
+    const FileEntry* FindFileEntry(const std::string& objectName) const;
+
+    // Get pack entry content
+    bool UnpackFileEntry(const FileEntry& fileEntry, unsigned char* outputData) const;
+
+    // Find pending request to same file or create new one, requests mutex must be locked
+    FileReadRequest* QueueReadRequest(const std::string& objectName, eFileRequestPriority priority);
+
+    // Load content for most important pending request, requests mutex is unlocked while reading
+    // @returns false if there is no pending requests
+    bool ProcessReadRequest(std::unique_lock<std::mutex>& requestsLock);
+
+    // Io thread is processing requests until shutdown
+    void StartIoThread();
+    void StopIoThread();
+
+    // Block until all queued requests are serviced, files index must not change while they are in progress
+    void WaitAsyncRequests();
+
+private:
+    FilesIndex mFilesIndex; // relative path to file
+    bool mFilesIndexBuilt = false;
+    cxx::mapped_file mPackFile;
+
+    // async requests
+    std::thread mIoThread;
+    std::mutex mRequestsMutex;
+    std::condition_variable mRequestsCondition;
+    std::vector<FileReadRequest*> mPendingRequests;
+    FileReadRequest* mActiveRequest = nullptr;
+    unsigned int mRequestsCounter = 0;
+    bool mIoThreadQuit = false;
 };
 
 extern FileSystem gFiles;
\ No newline at end of file
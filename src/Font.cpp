@@ -35,10 +35,26 @@ bool Font::LoadFromFile()
     if (IsLoaded())
         return true;
 
-    std::ifstream inStream;
-    if (!gFiles.OpenBinaryFile(mFontName, inStream))
+    if (mFontDataRequest.valid())
+    {
+        // font could be preloaded with low priority, but now content is required right away
+        gFiles.RaiseReadRequestPriority(mFontName, eFileRequestPriority_High);
+    }
+    else
+    {
+        RequestFontData(eFileRequestPriority_High);
+    }
+    std::shared_ptr<const FileReadResult> fontContent = mFontDataRequest.get();
+    mFontDataRequest = FileReadFuture();
+
+    if (!fontContent->mSuccess)
         return false;
 
+    char* fontData = (char*) fontContent->mContent.data();
+    cxx::memory_istream fontDataBuffer(fontData, fontData + fontContent->mContent.size());
+
+    std::istream inStream(&fontDataBuffer);
+
     // read header
     unsigned char numChars = 0;
     READ_I8(inStream, numChars);
@@ -84,6 +100,14 @@ bool Font::LoadFromFile()
     return true;
 }
 
+void Font::RequestFontData(eFileRequestPriority priority)
+{
+    if (IsLoaded() || mFontDataRequest.valid())
+        return;
+
+    mFontDataRequest = gFiles.ReadBinaryFileAsync(mFontName, priority);
+}
+
 void Font::Unload()
 {
     mLineHeight = 0;
@@ -112,7 +136,7 @@ void Font::DumpCharacters(const std::string& outputPath)
     for (const RawCharacter& currChar: mFontData.mRawCharacters)
     {
         PixelsArray spriteBitmap;
-        if (!spriteBitmap.Create(eTextureFormat_RGB8, currChar.mCharWidth, mLineHeight, gMemoryManager.mFrameHeapAllocator))
+        if (!spriteBitmap.Create(eTextureFormat_RGB8, currChar.mCharWidth, mLineHeight, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
         {
             debug_assert(false);
             continue;
@@ -355,7 +379,7 @@ bool Font::CreateFontAtlas()
 
     // allocate temporary bitmap
     PixelsArray charactersBitmap;
-    if (!charactersBitmap.Create(eTextureFormat_R8UI, currentTextureSizeW, currentTextureSizeH, gMemoryManager.mFrameHeapAllocator))
+    if (!charactersBitmap.Create(eTextureFormat_R8UI, currentTextureSizeW, currentTextureSizeH, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
         return false;
 
     charactersBitmap.FillWithColor(0);
@@ -16,6 +16,9 @@ public:
     bool LoadFromFile();
     void Unload();
 
+    // Start loading font file in background, its content will be picked up by LoadFromFile
+    void RequestFontData(eFileRequestPriority priority);
+
     // Test whether font resource is loaded
     bool IsLoaded() const;
 
@@ -63,6 +66,7 @@ private:
     std::vector<TextureRegion> mCharacters;
     RawFontData mFontData;
     GpuTexture2D* mFontTexture = nullptr;
+    FileReadFuture mFontDataRequest;
 
     int mBaseCharCode = 0;
     int mLineHeight = 0;
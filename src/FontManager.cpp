@@ -19,6 +19,26 @@ void FontManager::Deinit()
 }
 
 Font* FontManager::GetFont(const std::string& fontName)
+{
+    Font* fontInstance = GetOrCreateFont(fontName);
+    if (!fontInstance->IsLoaded())
+    {
+        if (!fontInstance->LoadFromFile())
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot load font '%s'", fontName.c_str());
+        }
+    }
+
+    return fontInstance;
+}
+
+void FontManager::PreloadFont(const std::string& fontName)
+{
+    Font* fontInstance = GetOrCreateFont(fontName);
+    fontInstance->RequestFontData(eFileRequestPriority_Low);
+}
+
+Font* FontManager::GetOrCreateFont(const std::string& fontName)
 {
     Font* fontInstance = nullptr;
 
@@ -35,14 +55,6 @@ Font* FontManager::GetFont(const std::string& fontName)
     }
 
     debug_assert(fontInstance);
-    if (!fontInstance->IsLoaded())
-    {
-        if (!fontInstance->LoadFromFile())
-        {
-            gConsole.LogMessage(eLogMessage_Warning, "Cannot load font '%s'", fontName.c_str());
-        }
-    }
-
     return fontInstance;
 }
 
@@ -20,6 +20,13 @@ public:
     // @returns font instance which might be not loaded in case of error
     Font* GetFont(const std::string& fontName);
 
+    // Start loading font in background so that later GetFont does not wait for file
+    // @param fontName: Font name
+    void PreloadFont(const std::string& fontName);
+
+private:
+    Font* GetOrCreateFont(const std::string& fontName);
+
 private:
     std::map<std::string, Font*> mFontsCache;
 };
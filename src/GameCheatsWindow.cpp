@@ -11,9 +11,21 @@
 #include "AiCharacterController.h"
 #include "cvars.h"
 #include "ImGuiHelpers.h"
+#include "GameObjectsManager.h"
+#include "AudioManager.h"
+#include "MemoryTracker.h"
 
 GameCheatsWindow gGameCheatsWindow;
 
+template<typename TPool>
+static void PoolStatsUI(const char* poolName, const TPool& objectsPool)
+{
+    ImGui::Text("%s: %d (peak %d, chunks %d)", poolName,
+        objectsPool.get_live_count(),
+        objectsPool.get_peak_count(),
+        objectsPool.get_chunks_count());
+}
+
 GameCheatsWindow::GameCheatsWindow()
     : DebugWindow("Game Cheats")
     , mEnableMapCollisions(true)
@@ -202,6 +214,38 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
     {
         //ImGui::Checkbox("Enable map collisions", &mEnableMapCollisions);
         ImGui::Checkbox("Enable gravity", &mEnableGravity);
+        ImGui::HorzSpacing();
+        ImGui::Text("Step time: %.2f ms", gPhysics.mStepStats.mStepTime * 1000.0f);
+        ImGui::Text("Steps per frame: %d (peak %d)", gPhysics.mStepStats.mStepsCount, gPhysics.mStepStats.mStepsCountPeak);
+        ImGui::Text("Dropped steps: %d (%.2f s)", gPhysics.mStepStats.mDroppedStepsCount, gPhysics.mStepStats.mDroppedTime);
+        ImGui::Text("Stretched steps: %d", gPhysics.mStepStats.mStretchedStepsCount);
+        ImGui::HorzSpacing();
+        if (ImGui::SliderFloat("Physics framerate", &gCvarPhysicsFramerate.mValue, 10.0f, 240.0f, "%.0f"))
+        {
+            gCvarPhysicsFramerate.SetModified();
+        }
+        ImGui::SliderInt("Max steps per frame", &gCvarPhysicsMaxSteps.mValue, 1, 16);
+        ImGui::Checkbox("Adaptive step", &gCvarPhysicsAdaptiveStep.mValue);
+        if (gCvarPhysicsAdaptiveStep.mValue)
+        {
+            ImGui::SliderFloat("Min physics framerate", &gCvarPhysicsMinFramerate.mValue, 10.0f, 60.0f, "%.0f");
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Pools"))
+    {
+        PoolStatsUI("Pedestrians", gGameObjectsManager.mPedestriansPool);
+        PoolStatsUI("Vehicles", gGameObjectsManager.mCarsPool);
+        PoolStatsUI("Projectiles", gGameObjectsManager.mProjectilesPool);
+        PoolStatsUI("Decorations", gGameObjectsManager.mDecorationsPool);
+        PoolStatsUI("Obstacles", gGameObjectsManager.mObstaclesPool);
+        PoolStatsUI("Explosions", gGameObjectsManager.mExplosionsPool);
+        ImGui::HorzSpacing();
+        PoolStatsUI("Ped bodies", gPhysics.mPedsBodiesPool);
+        PoolStatsUI("Car bodies", gPhysics.mCarsBodiesPool);
+        PoolStatsUI("Projectile bodies", gPhysics.mProjectileBodiesPool);
+        ImGui::HorzSpacing();
+        PoolStatsUI("Ai controllers", gAiManager.mControllersPool);
     }
 
     if (ImGui::CollapsingHeader("Draw"))
@@ -219,6 +263,11 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
 
     if (ImGui::CollapsingHeader("Traffic"))
     {
+        ImGui::Text("Relevant regions: %d", (int) gTrafficManager.mTrafficRegions.size());
+        for (const auto& currRegion: gTrafficManager.mTrafficRegions)
+        {
+            ImGui::BulletText("views: %d, quota: %d, population: %d", currRegion.mViewsCount, currRegion.mQuota, currRegion.mPopulation);
+        }
         ImGui::HorzSpacing();
         ImGui::TextColored(ImVec4(1.0f,1.0f,0.0f,1.0f), "Pedestrians");
         ImGui::HorzSpacing();
@@ -227,6 +276,7 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
         ImGui::SliderInt("Generation distance max##ped", &gGameParams.mTrafficGenPedsMaxDistance, 1, 10);
         ImGui::SliderInt("Generation chance##ped", &gGameParams.mTrafficGenPedsChance, 0, 100);
         ImGui::SliderFloat("Generation cooldown##ped", &gGameParams.mTrafficGenPedsCooldownTime, 0.5f, 5.0f, "%.1f");
+        ImGui::SliderInt("Generation per turn##ped", &gGameParams.mTrafficGenPedsPerTurn, 1, 100);
         ImGui::Checkbox("Generation enabled##ped", &mEnableTrafficPedsGeneration);
         ImGui::HorzSpacing();
         ImGui::TextColored(ImVec4(1.0f,1.0f,0.0f,1.0f), "Cars");
@@ -236,9 +286,82 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
         ImGui::SliderInt("Generation distance max##car", &gGameParams.mTrafficGenCarsMaxDistance, 1, 10);
         ImGui::SliderInt("Generation chance##car", &gGameParams.mTrafficGenCarsChance, 0, 100);
         ImGui::SliderFloat("Generation cooldown##car", &gGameParams.mTrafficGenCarsCooldownTime, 0.5f, 5.0f, "%.1f");
+        ImGui::SliderInt("Generation per turn##car", &gGameParams.mTrafficGenCarsPerTurn, 1, 100);
+        ImGui::Text("Off-screen count: %d", (int) gTrafficManager.mAbstractCars.size());
+        ImGui::SliderInt("Off-screen max count##car", &gGameParams.mTrafficAbstractMaxCars, 0, 1000);
         ImGui::Checkbox("Generation enabled##car", &mEnableTrafficCarsGeneration);
     }
 
+    if (ImGui::CollapsingHeader("Ai"))
+    {
+        const AiSchedulerStats& schedulerStats = gAiManager.mSchedulerStats;
+        ImGui::Text("Controllers ticked: %d", schedulerStats.mTickedControllers);
+        ImGui::Text("Controllers skipped: %d", schedulerStats.mSkippedControllers);
+        ImGui::Text("Controllers over budget: %d", schedulerStats.mOverBudgetControllers);
+        ImGui::Text("Controllers update time: %.3f ms", schedulerStats.mUpdateTime);
+        ImGui::SliderInt("Update budget (us)", &gCvarAiUpdateBudget.mValue, 100, 20000);
+        ImGui::HorzSpacing();
+
+        const AiPathfinderStats& pathStats = gAiManager.mPathfinder.mStats;
+        ImGui::Text("Path requests pending: %d", pathStats.mPendingRequests);
+        ImGui::Text("Path requests completed: %d (failed %d)", pathStats.mCompletedRequests, pathStats.mFailedRequests);
+        ImGui::Text("Path requests rejected: %d", pathStats.mRejectedRequests);
+        ImGui::Text("Path nodes processed: %d", pathStats.mProcessedNodes);
+        ImGui::Text("Path cache hits: %d (misses %d)", pathStats.mCacheHits, pathStats.mCacheMisses);
+        ImGui::SliderInt("Path budget", &gCvarAiPathBudget.mValue, 64, 16384);
+    }
+
+    if (ImGui::CollapsingHeader("Audio"))
+    {
+        AudioVoicesStats voicesStats = gAudioManager.GetVoicesStats();
+        ImGui::Text("Real voices: %d", voicesStats.mRealVoices);
+        ImGui::Text("Virtual voices: %d", voicesStats.mVirtualVoices);
+        ImGui::Text("Stolen voices: %d", voicesStats.mStolenVoices);
+        ImGui::Text("Dropped voices: %d", voicesStats.mDroppedVoices);
+        ImGui::SliderFloat("Hearing distance", &gCvarAudioHearingDistance.mValue, 8.0f, 256.0f);
+        ImGui::HorzSpacing();
+
+        const AudioBankStats& bankStats = gAudioManager.mBankStats;
+        ImGui::Text("Sound buffers: %d (failed %d)", bankStats.mLoadedBuffers, bankStats.mFailedBuffers);
+        ImGui::Text("Sound data: %d bytes", bankStats.mReadBytes);
+        ImGui::Text("Sound read time: %.3f ms", bankStats.mReadTime);
+        ImGui::Text("Sound upload time: %.3f ms", bankStats.mUploadTime);
+    }
+
+    if (ImGui::CollapsingHeader("Memory"))
+    {
+        if (gMemoryTracker.IsEnabled())
+        {
+            ImGui::Text("Frame allocations: %lld (%lld bytes)", gMemoryTracker.mFrameAllocations, gMemoryTracker.mFrameAllocatedBytes);
+            for (int itag = 0; itag < eMemoryTag_COUNT; ++itag)
+            {
+                MemoryTagStats tagStats;
+                gMemoryTracker.GetTagStats((eMemoryTag) itag, tagStats);
+                ImGui::BulletText("%s: %lld bytes in %lld allocations", gMemoryTracker.GetTagName((eMemoryTag) itag),
+                    tagStats.mLiveBytes, tagStats.mLiveAllocations);
+            }
+            ImGui::HorzSpacing();
+        }
+
+        static const char* categoryNames[eFrameMemoryCategory_COUNT] = { "pixels", "mesh", "physics", "other" };
+
+        gMemoryManager.GetFrameArenasStats(mFrameArenasStats);
+        for (const FrameArenaStats& currStats: mFrameArenasStats)
+        {
+            ImGui::TextColored(ImVec4(1.0f,1.0f,0.0f,1.0f), "%s", currStats.mName);
+            ImGui::Text("Used: %d / %d bytes", currStats.mUsedLastFrame, currStats.mCapacity);
+            ImGui::Text("High water: %d bytes (overflows %d)", currStats.mHighWaterMark, currStats.mOverflows);
+            for (int icategory = 0; icategory < eFrameMemoryCategory_COUNT; ++icategory)
+            {
+                if (currStats.mCategoryHighWaterMark[icategory] > 0)
+                {
+                    ImGui::BulletText("%s: %d bytes", categoryNames[icategory], currStats.mCategoryHighWaterMark[icategory]);
+                }
+            }
+            ImGui::HorzSpacing();
+        }
+    }
+
     if (ImGui::CollapsingHeader("Graphics"))
     {
         if (ImGui::Checkbox("Enable vsync", &gCvarGraphicsVSync.mValue))
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DebugWindow.h"
+#include "MemoryManager.h"
 
 class GameCheatsWindow: public DebugWindow
 {
@@ -26,6 +27,9 @@ private:
     void DoUI(ImGuiIO& imguiContext) override;
 
     void CreateCarNearby(VehicleInfo* carStyle, Pedestrian* pedestrian);
+
+private:
+    std::vector<FrameArenaStats> mFrameArenasStats;
 };
 
 extern GameCheatsWindow gGameCheatsWindow;
\ No newline at end of file
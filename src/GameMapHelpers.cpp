@@ -7,38 +7,72 @@ bool GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, i
 {
     debug_assert(layerIndex > -1 && layerIndex < MAP_LAYERS_COUNT);
 
+    const unsigned int prevVerticesCount = meshData.mBlocksVertices.size();
+    const unsigned int prevIndicesCount = meshData.mBlocksIndices.size();
+
     // preallocate
-    meshData.mBlocksIndices.reserve(1 * 1024 * 1024);
-    meshData.mBlocksVertices.reserve(1 * 1024 * 1024);
+    const int facesCount = CountMapMeshFaces(cityScape, area, layerIndex, layerIndex + 1);
+    meshData.mBlocksVertices.resize(prevVerticesCount + facesCount * 4);
+    meshData.mBlocksIndices.resize(prevIndicesCount + facesCount * 6);
+
+    BuildMapMesh(cityScape, area, layerIndex, layerIndex + 1, 
+        meshData.mBlocksVertices.data() + prevVerticesCount, 
+        meshData.mBlocksIndices.data() + prevIndicesCount, prevVerticesCount);
+    return true;
+}
+
+bool GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, CityMeshData& meshData)
+{
+    const unsigned int prevVerticesCount = meshData.mBlocksVertices.size();
+    const unsigned int prevIndicesCount = meshData.mBlocksIndices.size();
+
+    // preallocate
+    const int facesCount = CountMapMeshFaces(cityScape, area);
+    meshData.mBlocksVertices.resize(prevVerticesCount + facesCount * 4);
+    meshData.mBlocksIndices.resize(prevIndicesCount + facesCount * 6);
+
+    BuildMapMesh(cityScape, area, 
+        meshData.mBlocksVertices.data() + prevVerticesCount, 
+        meshData.mBlocksIndices.data() + prevIndicesCount, prevVerticesCount);
+    return true;
+}
+
+void GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, CityVertex3D* outputVertices, DrawIndex* outputIndices, unsigned int baseVertexIndex)
+{
+    BuildMapMesh(cityScape, area, 0, MAP_LAYERS_COUNT, outputVertices, outputIndices, baseVertexIndex);
+}
 
-    // prepare
+int GameMapHelpers::CountMapMeshFaces(GameMapManager& cityScape, const Rect& area)
+{
+    return CountMapMeshFaces(cityScape, area, 0, MAP_LAYERS_COUNT);
+}
+
+int GameMapHelpers::CountMapMeshFaces(GameMapManager& cityScape, const Rect& area, int layerStart, int layerEnd)
+{
+    int facesCount = 0;
+    for (int tilez = layerStart; tilez < layerEnd; ++tilez)
     for (int tiley = 0; tiley < area.h; ++tiley)
     for (int tilex = 0; tilex < area.w; ++tilex)
     {
-        const MapBlockInfo* mapBlock = cityScape.GetBlockInfo(tilex + area.x, tiley + area.y, layerIndex);
+        const MapBlockInfo* mapBlock = cityScape.GetBlockInfo(tilex + area.x, tiley + area.y, tilez);
         if (mapBlock == nullptr)
             continue;
 
         for (int iface = 0; iface < eBlockFace_COUNT; ++iface)
         {
-            if (mapBlock->mFaces[iface] == 0)
-                continue;
-
-            eBlockFace faceid = (eBlockFace) iface;
-            PutBlockFace(cityScape, meshData, tilex + area.x, tiley + area.y, layerIndex, faceid, mapBlock);
+            if (mapBlock->mFaces[iface])
+            {
+                ++facesCount;
+            }
         }
     }
-    return true;
+    return facesCount;
 }
 
-bool GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, CityMeshData& meshData)
+void GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, int layerStart, int layerEnd, 
+    CityVertex3D* outputVertices, DrawIndex* outputIndices, unsigned int baseVertexIndex)
 {
-    // preallocate
-    meshData.mBlocksIndices.reserve(4 * 1024 * 1024);
-    meshData.mBlocksVertices.reserve(4 * 1024 * 1024);
-
-    // prepare
-    for (int tilez = 0; tilez < MAP_LAYERS_COUNT; ++tilez)
+    for (int tilez = layerStart; tilez < layerEnd; ++tilez)
     for (int tiley = 0; tiley < area.h; ++tiley)
     for (int tilex = 0; tilex < area.w; ++tilex)
     {
@@ -52,13 +86,17 @@ bool GameMapHelpers::BuildMapMesh(GameMapManager& cityScape, const Rect& area, C
                 continue;
 
             eBlockFace faceid = (eBlockFace) iface;
-            PutBlockFace(cityScape, meshData, tilex + area.x, tiley + area.y, tilez, faceid, mapBlock);
+            PutBlockFace(cityScape, outputVertices, outputIndices, baseVertexIndex, tilex + area.x, tiley + area.y, tilez, faceid, mapBlock);
+
+            outputVertices += 4;
+            outputIndices += 6;
+            baseVertexIndex += 4;
         }
     }
-    return true;
 }
 
-void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityMeshData& meshData, int x, int y, int z, eBlockFace face, const MapBlockInfo* blockInfo)
+void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityVertex3D* faceVertices, DrawIndex* faceIndices, unsigned int baseVertexIndex,
+    int x, int y, int z, eBlockFace face, const MapBlockInfo* blockInfo)
 {
     assert(blockInfo && blockInfo->mFaces[face]);
     eBlockType blockType = (face == eBlockFace_Lid) ? eBlockType_Lid : eBlockType_Side;
@@ -150,12 +188,10 @@ void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityMeshData& meshD
     }
 
     const int rotateLid = (face == eBlockFace_Lid) ? blockInfo->mLidRotation : 0;
-    const int baseVertexIndex = meshData.mBlocksVertices.size();
-    meshData.mBlocksVertices.resize(baseVertexIndex + 4);
-    meshData.mBlocksVertices[baseVertexIndex + ((rotateLid + 0) % 4)].mTexcoord = texCoords[0];
-    meshData.mBlocksVertices[baseVertexIndex + ((rotateLid + 1) % 4)].mTexcoord = texCoords[1];
-    meshData.mBlocksVertices[baseVertexIndex + ((rotateLid + 2) % 4)].mTexcoord = texCoords[2];
-    meshData.mBlocksVertices[baseVertexIndex + ((rotateLid + 3) % 4)].mTexcoord = texCoords[3];
+    faceVertices[(rotateLid + 0) % 4].mTexcoord = texCoords[0];
+    faceVertices[(rotateLid + 1) % 4].mTexcoord = texCoords[1];
+    faceVertices[(rotateLid + 2) % 4].mTexcoord = texCoords[2];
+    faceVertices[(rotateLid + 3) % 4].mTexcoord = texCoords[3];
 
     if (face != eBlockFace_Lid)
     {
@@ -164,8 +200,8 @@ void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityMeshData& meshD
 
         if (flipLeftRightFaces)
         {
-            std::swap(meshData.mBlocksVertices[baseVertexIndex + 0].mTexcoord, meshData.mBlocksVertices[baseVertexIndex + 1].mTexcoord);
-            std::swap(meshData.mBlocksVertices[baseVertexIndex + 2].mTexcoord, meshData.mBlocksVertices[baseVertexIndex + 3].mTexcoord);
+            std::swap(faceVertices[0].mTexcoord, faceVertices[1].mTexcoord);
+            std::swap(faceVertices[2].mTexcoord, faceVertices[3].mTexcoord);
         }
 
         bool flipTopBottomFaces = ((blockInfo->mIsFlat != blockInfo->mFlipTopBottomFaces) && (face == eBlockFace_S)) ||
@@ -173,54 +209,54 @@ void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityMeshData& meshD
 
         if (flipTopBottomFaces)
         {
-            std::swap(meshData.mBlocksVertices[baseVertexIndex + 0].mTexcoord, meshData.mBlocksVertices[baseVertexIndex + 1].mTexcoord);
-            std::swap(meshData.mBlocksVertices[baseVertexIndex + 2].mTexcoord, meshData.mBlocksVertices[baseVertexIndex + 3].mTexcoord);
+            std::swap(faceVertices[0].mTexcoord, faceVertices[1].mTexcoord);
+            std::swap(faceVertices[2].mTexcoord, faceVertices[3].mTexcoord);
         }
     }
 
     // color
     int remap = (face == eBlockFace_Lid) ? blockInfo->mRemap : 0;
-    meshData.mBlocksVertices[baseVertexIndex + 0].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
-    meshData.mBlocksVertices[baseVertexIndex + 1].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
-    meshData.mBlocksVertices[baseVertexIndex + 2].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
-    meshData.mBlocksVertices[baseVertexIndex + 3].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
+    faceVertices[0].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
+    faceVertices[1].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
+    faceVertices[2].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
+    faceVertices[3].SetColorData(remap, blockInfo->mIsFlat ? 1 : 0);
 
     // setup face vertices
     glm::vec3 cubeOffset { x * METERS_PER_MAP_UNIT, z * METERS_PER_MAP_UNIT, y * METERS_PER_MAP_UNIT };
     if (face == eBlockFace_Lid)
     {
-        meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[4] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[5] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[1] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[0] + cubeOffset;
+        faceVertices[0].mPosition = cubePoints[4] + cubeOffset;
+        faceVertices[1].mPosition = cubePoints[5] + cubeOffset;
+        faceVertices[2].mPosition = cubePoints[1] + cubeOffset;
+        faceVertices[3].mPosition = cubePoints[0] + cubeOffset;
     }
     if (face == eBlockFace_S)
     {
-        meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[0] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[1] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[2] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[3] + cubeOffset;
+        faceVertices[0].mPosition = cubePoints[0] + cubeOffset;
+        faceVertices[1].mPosition = cubePoints[1] + cubeOffset;
+        faceVertices[2].mPosition = cubePoints[2] + cubeOffset;
+        faceVertices[3].mPosition = cubePoints[3] + cubeOffset;
     }
     if (face == eBlockFace_N)
     {
-        meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[5] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[4] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[7] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[6] + cubeOffset;
+        faceVertices[0].mPosition = cubePoints[5] + cubeOffset;
+        faceVertices[1].mPosition = cubePoints[4] + cubeOffset;
+        faceVertices[2].mPosition = cubePoints[7] + cubeOffset;
+        faceVertices[3].mPosition = cubePoints[6] + cubeOffset;
     }
     if (face == eBlockFace_W)
     {
-        meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[4] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[0] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[3] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[7] + cubeOffset;
+        faceVertices[0].mPosition = cubePoints[4] + cubeOffset;
+        faceVertices[1].mPosition = cubePoints[0] + cubeOffset;
+        faceVertices[2].mPosition = cubePoints[3] + cubeOffset;
+        faceVertices[3].mPosition = cubePoints[7] + cubeOffset;
     }
     if (face == eBlockFace_E)
     {
-        meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[1] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[5] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[6] + cubeOffset;
-        meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[2] + cubeOffset;
+        faceVertices[0].mPosition = cubePoints[1] + cubeOffset;
+        faceVertices[1].mPosition = cubePoints[5] + cubeOffset;
+        faceVertices[2].mPosition = cubePoints[6] + cubeOffset;
+        faceVertices[3].mPosition = cubePoints[2] + cubeOffset;
     }
 
     if (blockInfo->mIsFlat)
@@ -228,30 +264,28 @@ void GameMapHelpers::PutBlockFace(GameMapManager& cityScape, CityMeshData& meshD
         // should draw at W position
         if (face == eBlockFace_E)
         {
-            meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[0] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[4] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[7] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[3] + cubeOffset;
+            faceVertices[0].mPosition = cubePoints[0] + cubeOffset;
+            faceVertices[1].mPosition = cubePoints[4] + cubeOffset;
+            faceVertices[2].mPosition = cubePoints[7] + cubeOffset;
+            faceVertices[3].mPosition = cubePoints[3] + cubeOffset;
         }
         // should draw at N position
         if (face == eBlockFace_S)
         {
-            meshData.mBlocksVertices[baseVertexIndex + 0].mPosition = cubePoints[4] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 1].mPosition = cubePoints[5] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 2].mPosition = cubePoints[6] + cubeOffset;
-            meshData.mBlocksVertices[baseVertexIndex + 3].mPosition = cubePoints[7] + cubeOffset;
+            faceVertices[0].mPosition = cubePoints[4] + cubeOffset;
+            faceVertices[1].mPosition = cubePoints[5] + cubeOffset;
+            faceVertices[2].mPosition = cubePoints[6] + cubeOffset;
+            faceVertices[3].mPosition = cubePoints[7] + cubeOffset;
         }
     }
 
     // add indices
-    int baseIndex = meshData.mBlocksIndices.size();
-    meshData.mBlocksIndices.resize(baseIndex + 6);
-    meshData.mBlocksIndices[baseIndex + 0] = baseVertexIndex + 3;
-    meshData.mBlocksIndices[baseIndex + 1] = baseVertexIndex + 1;
-    meshData.mBlocksIndices[baseIndex + 2] = baseVertexIndex + 0;
-    meshData.mBlocksIndices[baseIndex + 3] = baseVertexIndex + 3;
-    meshData.mBlocksIndices[baseIndex + 4] = baseVertexIndex + 2;
-    meshData.mBlocksIndices[baseIndex + 5] = baseVertexIndex + 1;
+    faceIndices[0] = baseVertexIndex + 3;
+    faceIndices[1] = baseVertexIndex + 1;
+    faceIndices[2] = baseVertexIndex + 0;
+    faceIndices[3] = baseVertexIndex + 3;
+    faceIndices[4] = baseVertexIndex + 2;
+    faceIndices[5] = baseVertexIndex + 1;
 }
 
 float GameMapHelpers::GetSlopeHeight(int slopeType, float coord_x, float coord_y)
@@ -33,6 +33,18 @@ public:
     static bool BuildMapMesh(GameMapManager& city, const Rect& area, int layerIndex, CityMeshData& meshData);
     static bool BuildMapMesh(GameMapManager& city, const Rect& area, CityMeshData& meshData);
 
+    // construct mesh for specified city area into preallocated buffers, all map layers are processed
+    // @param cityScape: City scape data
+    // @param area: Target map rect
+    // @param outputVertices, outputIndices: Output buffers, see CountMapMeshFaces for required size
+    // @param baseVertexIndex: Index of first output vertex within whole mesh vertex buffer
+    static void BuildMapMesh(GameMapManager& city, const Rect& area, CityVertex3D* outputVertices, DrawIndex* outputIndices, unsigned int baseVertexIndex);
+
+    // count block faces in specified city area, each face takes 4 vertices and 6 indices
+    // @param cityScape: City scape data
+    // @param area: Target map rect
+    static int CountMapMeshFaces(GameMapManager& city, const Rect& area);
+
     // compute height for specific block slope type
     // @param slopeType: Slope type
     // @param x, y: Position within block [0, 1]
@@ -41,5 +53,7 @@ public:
 
 private:
     // internals
-    static void PutBlockFace(GameMapManager& city, CityMeshData& meshData, int x, int y, int z, eBlockFace face, const MapBlockInfo* blockInfo);
+    static int CountMapMeshFaces(GameMapManager& city, const Rect& area, int layerStart, int layerEnd);
+    static void BuildMapMesh(GameMapManager& city, const Rect& area, int layerStart, int layerEnd, CityVertex3D* outputVertices, DrawIndex* outputIndices, unsigned int baseVertexIndex);
+    static void PutBlockFace(GameMapManager& city, CityVertex3D* faceVertices, DrawIndex* faceIndices, unsigned int baseVertexIndex, int x, int y, int z, eBlockFace face, const MapBlockInfo* blockInfo);
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "GameMapManager.h"
 #include "CarnageGame.h"
 #include "cvars.h"
+#include "MemoryTracker.h"
 
 GameMapManager gGameMap;
 
@@ -31,17 +32,25 @@ struct GTAFileHeaderCMP
 
 bool GameMapManager::LoadFromFile(const std::string& filename)
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_GameMap);
+
     Cleanup();
 
     gConsole.LogMessage(eLogMessage_Info, "Loading map data '%s'", filename.c_str());
 
-    std::ifstream file;
-    if (!gFiles.OpenBinaryFile(filename, file))
+    FileReadFuture mapContentRequest = gFiles.ReadBinaryFileAsync(filename, eFileRequestPriority_High);
+    std::shared_ptr<const FileReadResult> mapContent = mapContentRequest.get();
+    if (!mapContent->mSuccess)
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot open map data file");
         return false;
     }
 
+    char* mapData = (char*) mapContent->mContent.data();
+    cxx::memory_istream mapDataBuffer(mapData, mapData + mapContent->mContent.size());
+
+    std::istream file(&mapDataBuffer);
+
     GTAFileHeaderCMP header;
     if (!cxx::read_from_stream(file, header) || header.version_code != GTA_CMPFILE_VERSION_CODE)
     {
@@ -49,6 +58,10 @@ bool GameMapManager::LoadFromFile(const std::string& filename)
         return false;
     }
 
+    // style data is loaded in background while map data is processed
+    std::string styleName = GetStyleFileName(header.style_number);
+    FileReadFuture styleContentRequest = gFiles.ReadBinaryFileAsync(styleName, eFileRequestPriority_High);
+
     if (!ReadCompressedMapData(file, header.column_size, header.block_size))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot read compressed map data");
@@ -80,10 +93,8 @@ bool GameMapManager::LoadFromFile(const std::string& filename)
     }
 
     // load corresponding style data
-    std::string styleName = GetStyleFileName(header.style_number);
-
     gConsole.LogMessage(eLogMessage_Info, "Loading style data '%s'", styleName.c_str());
-    if (!mStyleData.LoadFromFile(styleName))
+    if (!mStyleData.LoadFromFile(styleName, styleContentRequest))
     {
         Cleanup();
         return false;
@@ -338,93 +349,100 @@ float GameMapManager::GetHeightAtPosition(const glm::vec3& position, bool exclud
     return Convert::MapUnitsToMeters(currentHeight);
 }
 
-bool GameMapManager::TraceSegment2D(const glm::vec2& origin, const glm::vec2& destination, float height, glm::vec2& outPoint)
+bool GameMapManager::TraceSegment2D(const glm::vec2& origin, const glm::vec2& destination, float height, glm::vec2& outPoint) const
 {
-    glm::ivec2 mapcoord_start = origin;
-    glm::ivec2 mapcoord_end = destination;
-
     int mapcoord_z = (int) height;
+    if (mapcoord_z < 0 || mapcoord_z >= MAP_LAYERS_COUNT)
+        return false;
+
+    glm::ivec2 mapcoord_curr ((int) floorf(origin.x), (int) floorf(origin.y));
 
-    glm::vec2 direction = glm::normalize(destination - origin);
+    auto is_outside_map = [](const glm::ivec2& mapcoord)
+    {
+        return mapcoord.x < 0 || mapcoord.y < 0 || mapcoord.x >= MAP_DIMENSIONS || mapcoord.y >= MAP_DIMENSIONS;
+    };
 
-    // find all cells intersecting with line
+    if (is_outside_map(mapcoord_curr))
+        return false;
 
-    float posX = origin.x;
-    float posY = origin.y;
+    // origin is inside solid block
+    if (mMapTiles[mapcoord_z][mapcoord_curr.y][mapcoord_curr.x].mGroundType == eGroundType_Building)
+    {
+        outPoint = origin;
+        return true;
+    }
 
-    glm::ivec2 mapcoord_curr = mapcoord_start;
+    glm::vec2 segment = destination - origin;
+    float segmentLength = glm::length(segment);
+    if (segmentLength < 0.0001f)
+        return false;
 
-    float sideDistX;
-    float sideDistY;
+    glm::vec2 direction = segment / segmentLength;
 
     //length of ray from one x or y-side to next x or y-side
-    float deltaDistX = std::abs(1.0f / direction.x);
-    float deltaDistY = std::abs(1.0f / direction.y);
+    float deltaDistX = (direction.x == 0.0f) ? std::numeric_limits<float>::max() : std::abs(1.0f / direction.x);
+    float deltaDistY = (direction.y == 0.0f) ? std::numeric_limits<float>::max() : std::abs(1.0f / direction.y);
 
     //what direction to step in x or y-direction (either +1 or -1)
     int stepX;
     int stepY;
 
-    int side; //was a NS or a EW wall hit?
+    //length of ray from origin to next x or y-side
+    float sideDistX;
+    float sideDistY;
 
     //calculate step and initial sideDist
     if (direction.x < 0.0f)
     {
         stepX = -1;
-        sideDistX = (posX - mapcoord_curr.x) * deltaDistX;
+        sideDistX = (origin.x - mapcoord_curr.x) * deltaDistX;
     }
     else
     {
         stepX = 1;
-        sideDistX = (mapcoord_curr.x + 1.0f - posX) * deltaDistX;
+        sideDistX = (mapcoord_curr.x + 1.0f - origin.x) * deltaDistX;
     }
 
     if (direction.y < 0.0f)
     {
         stepY = -1;
-        sideDistY = (posY - mapcoord_curr.y) * deltaDistY;
+        sideDistY = (origin.y - mapcoord_curr.y) * deltaDistY;
     }
     else
     {
         stepY = 1;
-        sideDistY = (mapcoord_curr.y + 1.0f - posY) * deltaDistY;
+        sideDistY = (mapcoord_curr.y + 1.0f - origin.y) * deltaDistY;
     }
 
-    //perform DDA
-    const int MaxSteps = 16;
-    for (int istep = 0; ; ++istep)
+    //perform DDA until segment end is reached
+    for (;;)
     {
-        if (istep == MaxSteps)
-            return false;
+        float distance;
 
         //jump to next map square, OR in x-direction, OR in y-direction
         if (sideDistX < sideDistY)
         {
+            distance = sideDistX;
             sideDistX += deltaDistX;
             mapcoord_curr.x += stepX;
-            side = 0;
         }
         else
         {
+            distance = sideDistY;
             sideDistY += deltaDistY;
             mapcoord_curr.y += stepY;
-            side = 1;
         }
 
+        if (distance > segmentLength || is_outside_map(mapcoord_curr))
+            break;
+
         // detect hit
-        const MapBlockInfo* blockData = GetBlockInfo(mapcoord_curr.x, mapcoord_curr.y, mapcoord_z);
-        if (blockData->mGroundType == eGroundType_Building)
+        const MapBlockInfo& blockData = mMapTiles[mapcoord_z][mapcoord_curr.y][mapcoord_curr.x];
+        if (blockData.mGroundType == eGroundType_Building)
         {
-            float perpWallDist;
-            if (side == 0) perpWallDist = (mapcoord_curr.x - posX + (1 - stepX) / 2) / direction.x;
-            else           perpWallDist = (mapcoord_curr.y - posY + (1 - stepY) / 2) / direction.y;
-
-            outPoint = (origin + direction * perpWallDist);
+            outPoint = (origin + direction * distance);
             return true;
         }
-
-        if (mapcoord_curr == mapcoord_end)
-            break;
     }
 
     return false;
@@ -466,7 +484,7 @@ bool GameMapManager::ReadRoutes(std::istream& file, int dataSize)
     return true;
 }
 
-bool GameMapManager::ReadServiceBaseLocations(std::ifstream& file)
+bool GameMapManager::ReadServiceBaseLocations(std::istream& file)
 {
     struct LocationData
     {
@@ -536,7 +554,7 @@ bool GameMapManager::ReadServiceBaseLocations(std::ifstream& file)
     return true;
 }
 
-bool GameMapManager::ReadNavData(std::ifstream& file, int dataSize)
+bool GameMapManager::ReadNavData(std::istream& file, int dataSize)
 {
     struct nav_data_struct
     {
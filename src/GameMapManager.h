@@ -48,12 +48,13 @@ public:
     float GetWaterLevelAtPosition2(const glm::vec2& position) const;
 
     // get intersection with solid blocks on specific map layer, ignores slopes
-    // @param origin: Start position
-    // @param destination: End position
+    // there is no limit on traversed blocks count, so cost is proportional to segment length
+    // @param origin: Start position, map units
+    // @param destination: End position, map units
     // @param height: Z coord which is map layer
-    // @param outPoint: Intersection point
+    // @param outPoint: Intersection point, map units
     // @returns true if intersection detected or false otherwise
-    bool TraceSegment2D(const glm::vec2& origin, const glm::vec2& destination, float height, glm::vec2& outPoint);
+    bool TraceSegment2D(const glm::vec2& origin, const glm::vec2& destination, float height, glm::vec2& outPoint) const;
 
 private:
     // Reading map data internals
@@ -61,8 +62,8 @@ private:
     bool ReadCompressedMapData(std::istream& file, int columnLength, int blockLength);
     bool ReadStartupObjects(std::istream& file, int dataSize);
     bool ReadRoutes(std::istream& file, int dataSize);
-    bool ReadServiceBaseLocations(std::ifstream& file);
-    bool ReadNavData(std::ifstream& file, int dataSize);
+    bool ReadServiceBaseLocations(std::istream& file);
+    bool ReadNavData(std::istream& file, int dataSize);
     void FixShiftedBits();
 
     std::string GetStyleFileName(int styleNumber) const;
@@ -100,4 +100,8 @@ private:
     // marked object will be destroyed next game frame
     bool mMarkedForDeletion = false;
     unsigned int mLastRenderFrame = 0; // render frames counter
+
+    // objects manager lists positions
+    int mAllObjectsIndex = -1;
+    int mClassObjectsIndex = -1;
 };
\ No newline at end of file
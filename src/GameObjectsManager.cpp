@@ -6,6 +6,39 @@
 #include "GameMapManager.h"
 #include "Projectile.h"
 #include "RenderingManager.h"
+#include "TrafficManager.h"
+#include "MemoryTracker.h"
+
+// object identifier is composed of lookup table slot index and slot generation,
+// so identifiers of destroyed objects never refer to new objects,
+// slot gets retired once its generation is exhausted
+const unsigned int ObjectIDSlotBits = 20;
+const unsigned int ObjectIDSlotMask = (1U << ObjectIDSlotBits) - 1;
+const unsigned int ObjectIDMaxGeneration = (1U << (32 - ObjectIDSlotBits)) - 1;
+
+static_assert(sizeof(GameObjectID) == 4, "Unexpected gameobject id size");
+
+// update objects of same class in a row, all gameobject classes are final so calls are not virtual
+// it is safe to add new objects during loop since they are added to the end of the list
+// @param deleteObjectsList: Output objects which are marked for deletion
+template<typename TObjectClass>
+inline void UpdateObjectsList(const std::vector<TObjectClass*>& objectsList, std::vector<GameObject*>& deleteObjectsList)
+{
+    static_assert(std::is_final<TObjectClass>::value, "Gameobject class expected to be final");
+
+    for (size_t i = 0, NumElements = objectsList.size(); i < NumElements; ++i)
+    {
+        TObjectClass* currentObject = objectsList[i];
+        if (currentObject->IsMarkedForDeletion())
+        {
+            deleteObjectsList.push_back(currentObject);
+            continue;
+        }
+        currentObject->UpdateFrame();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
 
 GameObjectsManager gGameObjectsManager;
 
@@ -20,12 +53,21 @@ GameObjectsManager::~GameObjectsManager()
 
     debug_assert(mPedestriansList.empty());
     debug_assert(mVehiclesList.empty());
+    debug_assert(mObstaclesList.empty());
+    debug_assert(mProjectilesList.empty());
+    debug_assert(mExplosionsList.empty());
+    debug_assert(mDecorationsList.empty());
     debug_assert(mAllObjects.empty());
 }
 
 void GameObjectsManager::EnterWorld()
 {
-    mIDsCounter = 0;
+    MEMORY_TAG_SCOPE(eMemoryTag_GameObjects);
+
+    debug_assert(mAllObjects.empty());
+
+    mObjectSlots.clear();
+    mFreeObjectSlots.clear();
 
     if (!CreateStartupObjects())
     {
@@ -40,24 +82,80 @@ void GameObjectsManager::ClearWorld()
 
 void GameObjectsManager::UpdateFrame()
 {
-    bool hasDeadObjects = false;
+    MEMORY_TAG_SCOPE(eMemoryTag_GameObjects);
 
-    // if is safe to add new objects during loop by adding them to the end of the list
+    debug_assert(mDeleteObjectsList.empty());
 
-    for (size_t i = 0, NumElements = mAllObjects.size(); i < NumElements; ++i)
+    // objects are grouped by class to keep code and data of same kind together
+    UpdatePedestrians();
+    UpdateObjectsList(mVehiclesList, mDeleteObjectsList);
+    UpdateObjectsList(mObstaclesList, mDeleteObjectsList);
+    UpdateObjectsList(mProjectilesList, mDeleteObjectsList);
+    UpdateObjectsList(mExplosionsList, mDeleteObjectsList);
+    UpdateObjectsList(mDecorationsList, mDeleteObjectsList);
+
+    if (!mDeleteObjectsList.empty())
     {
-        GameObject* currentObject = mAllObjects[i];
-        if (currentObject->IsMarkedForDeletion())
+        DestroyMarkedForDeletionObjects();
+    }
+}
+
+void GameObjectsManager::UpdatePedestrians()
+{
+    for (std::vector<Pedestrian*>& currGroup: mPedestriansByState)
+    {
+        currGroup.clear();
+    }
+    mBurningPedestrians.clear();
+
+    // pass 1: animations and weapons, group pedestrians by their current state
+    for (size_t i = 0, NumElements = mPedestriansList.size(); i < NumElements; ++i)
+    {
+        Pedestrian* pedestrian = mPedestriansList[i];
+        if (pedestrian->IsMarkedForDeletion())
         {
-            hasDeadObjects = true;
+            mDeleteObjectsList.push_back(pedestrian);
             continue;
         }
-        currentObject->UpdateFrame();
+
+        bool updateAnimation = !pedestrian->CanSkipAnimation() || gTrafficManager.IsRelevantObject(pedestrian, 0.0f);
+        pedestrian->UpdateFrameBegin(updateAnimation);
+
+        mPedestriansByState[pedestrian->GetCurrentStateID()].push_back(pedestrian);
+        if (pedestrian->IsBurn())
+        {
+            mBurningPedestrians.push_back(pedestrian);
+        }
     }
 
-    if (hasDeadObjects)
+    // pass 2: railways damage, only pedestrians on foot may stand on tracks
+    for (ePedestrianState currState: { ePedestrianState_StandingStill, ePedestrianState_Walks, ePedestrianState_Runs, 
+        ePedestrianState_Falling, ePedestrianState_EnteringCar, ePedestrianState_ExitingCar, ePedestrianState_SlideOnCar, 
+        ePedestrianState_Stunned })
     {
-        DestroyMarkedForDeletionObjects();
+        for (Pedestrian* pedestrian: mPedestriansByState[currState])
+        {
+            pedestrian->UpdateDamageFromRailways();
+        }
+    }
+
+    // pass 3: state logic, pedestrian may have already switched to another state but it will still be processed properly
+    for (int istate = 0; istate < ePedestrianState_COUNT; ++istate)
+    {
+        ePedestrianState currState = (ePedestrianState) istate;
+        if (!PedestrianStatesManager::HasFrameHandler(currState))
+            continue;
+
+        for (Pedestrian* pedestrian: mPedestriansByState[currState])
+        {
+            pedestrian->mStatesManager.ProcessFrame();
+        }
+    }
+
+    // pass 4: burn effects
+    for (Pedestrian* pedestrian: mBurningPedestrians)
+    {
+        pedestrian->UpdateBurnEffect();
     }
 }
 
@@ -75,8 +173,7 @@ Pedestrian* GameObjectsManager::CreatePedestrian(const glm::vec3& position, cxx:
     {
         instance->mRemapIndex = remap;
     }
-    mAllObjects.push_back(instance);
-    mPedestriansList.push_back(instance);
+    AddToObjectsLists(instance, mPedestriansList);
 
     // init
     instance->Spawn(position, heading);
@@ -92,8 +189,7 @@ Vehicle* GameObjectsManager::CreateVehicle(const glm::vec3& position, cxx::angle
     Vehicle* instance = mCarsPool.create(carID);
     debug_assert(instance);
 
-    mAllObjects.push_back(instance);
-    mVehiclesList.push_back(instance);
+    AddToObjectsLists(instance, mVehiclesList);
 
     // init
     instance->mCarInfo = carStyle;
@@ -126,7 +222,7 @@ Projectile* GameObjectsManager::CreateProjectile(const glm::vec3& position, cxx:
     Projectile* instance = mProjectilesPool.create(weaponInfo, shooter);
     debug_assert(instance);
 
-    mAllObjects.push_back(instance);
+    AddToObjectsLists(instance, mProjectilesList);
     // init
     instance->Spawn(position, heading);
     return instance;
@@ -144,7 +240,7 @@ Obstacle* GameObjectsManager::CreateObstacle(const glm::vec3& position, cxx::ang
 
         instance = mObstaclesPool.create(objectID, desc);
         debug_assert(instance);
-        mAllObjects.push_back(instance);
+        AddToObjectsLists(instance, mObstaclesList);
         // init
         instance->Spawn(position, heading);
     }
@@ -155,7 +251,7 @@ Explosion* GameObjectsManager::CreateExplosion(GameObject* explodingObject, Game
 {
     Explosion* instance = mExplosionsPool.create(explodingObject, causer, explosionType);
     debug_assert(instance);
-    mAllObjects.push_back(instance);
+    AddToObjectsLists(instance, mExplosionsList);
     // init
     static const cxx::angle_t zeroAngle;
     instance->Spawn(position, zeroAngle);
@@ -173,7 +269,7 @@ Decoration* GameObjectsManager::CreateDecoration(const glm::vec3& position, cxx:
 
     instance = mDecorationsPool.create(objectID, desc);
     debug_assert(instance);
-    mAllObjects.push_back(instance);
+    AddToObjectsLists(instance, mDecorationsList);
     // init
     instance->Spawn(position, heading);
     instance->SetLifeDuration(desc->mLifeDuration);
@@ -218,77 +314,55 @@ Decoration* GameObjectsManager::CreateBigSmoke(const glm::vec3& position)
 
 Obstacle* GameObjectsManager::GetObstacleByID(GameObjectID objectID) const
 {
-    for (GameObject* currentObject: mAllObjects)
-    {
-        if (currentObject->mObjectID != objectID)
-            continue;
-
-        if (currentObject->IsMarkedForDeletion() || !currentObject->IsObstacleClass())
-            return nullptr;
+    GameObject* gameObject = GetGameObjectByID(objectID);
+    if (gameObject && gameObject->IsObstacleClass())
+        return static_cast<Obstacle*>(gameObject);
 
-        return static_cast<Obstacle*>(currentObject);
-    }
     return nullptr;
 }
 
 Vehicle* GameObjectsManager::GetVehicleByID(GameObjectID objectID) const
 {
-    for (GameObject* currentObject: mAllObjects)
-    {
-        if (currentObject->mObjectID != objectID)
-            continue;
-
-        if (currentObject->IsMarkedForDeletion() || !currentObject->IsVehicleClass())
-            return nullptr;
+    GameObject* gameObject = GetGameObjectByID(objectID);
+    if (gameObject && gameObject->IsVehicleClass())
+        return static_cast<Vehicle*>(gameObject);
 
-        return static_cast<Vehicle*>(currentObject);
-    }
     return nullptr;
 }
 
 Decoration* GameObjectsManager::GetDecorationByID(GameObjectID objectID) const
 {
-    for (GameObject* currentObject: mAllObjects)
-    {
-        if (currentObject->mObjectID != objectID)
-            continue;
+    GameObject* gameObject = GetGameObjectByID(objectID);
+    if (gameObject && gameObject->IsDecorationClass())
+        return static_cast<Decoration*>(gameObject);
 
-        if (currentObject->IsMarkedForDeletion() || !currentObject->IsDecorationClass())
-            return nullptr;
-
-        return static_cast<Decoration*>(currentObject);
-    }
     return nullptr;
 }
 
 Pedestrian* GameObjectsManager::GetPedestrianByID(GameObjectID objectID) const
 {
-    for (GameObject* currentObject: mAllObjects)
-    {
-        if (currentObject->mObjectID != objectID)
-            continue;
+    GameObject* gameObject = GetGameObjectByID(objectID);
+    if (gameObject && gameObject->IsPedestrianClass())
+        return static_cast<Pedestrian*>(gameObject);
 
-        if (currentObject->IsMarkedForDeletion() || !currentObject->IsPedestrianClass())
-            return nullptr;
-
-        return static_cast<Pedestrian*>(currentObject);
-    }
     return nullptr;
 }
 
 GameObject* GameObjectsManager::GetGameObjectByID(GameObjectID objectID) const
 {
-    for (GameObject* currentObject: mAllObjects)
-    {
-        if (currentObject->mObjectID != objectID)
-            continue;
+    if (objectID == GAMEOBJECT_ID_NULL)
+        return nullptr;
 
-        if (currentObject->IsMarkedForDeletion())
-            return nullptr;
+    unsigned int slotIndex = (objectID & ObjectIDSlotMask);
+    if (slotIndex >= mObjectSlots.size())
+        return nullptr;
 
-        return currentObject;
-    }
-    return nullptr;
+    // generation of slot might not match
+    GameObject* gameObject = mObjectSlots[slotIndex].mObject;
+    if (gameObject == nullptr || gameObject->mObjectID != objectID || gameObject->IsMarkedForDeletion())
+        return nullptr;
+
+    return gameObject;
 }
 
 void GameObjectsManager::DestroyGameObject(GameObject* object)
@@ -299,31 +373,28 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         return;
     }
 
-    cxx::erase_elements(mAllObjects, object);
-
     switch (object->mClassID)
     {
         case eGameObjectClass_Pedestrian:
         {
             Pedestrian* pedestrian = static_cast<Pedestrian*>(object);
+            RemoveFromObjectsLists(pedestrian, mPedestriansList);
             mPedestriansPool.destroy(pedestrian);
-
-            cxx::erase_elements(mPedestriansList, object);
         }
         break;
 
         case eGameObjectClass_Car:
         {
             Vehicle* vehicle = static_cast<Vehicle*>(object);
+            RemoveFromObjectsLists(vehicle, mVehiclesList);
             mCarsPool.destroy(vehicle);
-
-            cxx::erase_elements(mVehiclesList, object);
         }
         break;
 
         case eGameObjectClass_Projectile:
         {
             Projectile* projectile = static_cast<Projectile*>(object);
+            RemoveFromObjectsLists(projectile, mProjectilesList);
             mProjectilesPool.destroy(projectile);
         }
         break;
@@ -331,6 +402,7 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         case eGameObjectClass_Decoration:
         {
             Decoration* decoration = static_cast<Decoration*>(object);
+            RemoveFromObjectsLists(decoration, mDecorationsList);
             mDecorationsPool.destroy(decoration);
         }
         break;
@@ -338,6 +410,7 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         case eGameObjectClass_Obstacle:
         {
             Obstacle* obstacle = static_cast<Obstacle*>(object);
+            RemoveFromObjectsLists(obstacle, mObstaclesList);
             mObstaclesPool.destroy(obstacle);
         }
         break;
@@ -345,6 +418,7 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         case eGameObjectClass_Explosion:
         {
             Explosion* explosion = static_cast<Explosion*>(object);
+            RemoveFromObjectsLists(explosion, mExplosionsList);
             mExplosionsPool.destroy(explosion);
         }
         break;
@@ -359,6 +433,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
 
 void GameObjectsManager::DestroyAllObjects()
 {
+    mDeleteObjectsList.clear();
+
     while (!mAllObjects.empty())
     {
         DestroyGameObject(mAllObjects.back());
@@ -366,33 +442,110 @@ void GameObjectsManager::DestroyAllObjects()
 
     debug_assert(mVehiclesList.empty());
     debug_assert(mPedestriansList.empty());
+    debug_assert(mObstaclesList.empty());
+    debug_assert(mProjectilesList.empty());
+    debug_assert(mExplosionsList.empty());
+    debug_assert(mDecorationsList.empty());
 }
 
 void GameObjectsManager::DestroyMarkedForDeletionObjects()
 {
-    std::vector<GameObject*> objectsList;
-    for (GameObject* currGameObject: mAllObjects)
+    for (GameObject* currGameObject: mDeleteObjectsList)
     {
-        if (currGameObject->IsMarkedForDeletion())
+        debug_assert(currGameObject->IsMarkedForDeletion());
+        DestroyGameObject(currGameObject);
+    }
+    mDeleteObjectsList.clear();
+}
+
+GameObjectID GameObjectsManager::GenerateUniqueID()
+{
+    unsigned int slotIndex = 0;
+    if (mFreeObjectSlots.empty())
+    {
+        slotIndex = mObjectSlots.size();
+        if (slotIndex > ObjectIDSlotMask) // overflow
         {
-            objectsList.push_back(currGameObject);
+            debug_assert(false);
+            return GAMEOBJECT_ID_NULL;
         }
+        mObjectSlots.emplace_back();
     }
-
-    for (GameObject* currGameObject: objectsList)
+    else
     {
-        DestroyGameObject(currGameObject);
+        slotIndex = mFreeObjectSlots.front();
+        mFreeObjectSlots.pop_front();
     }
+
+    const ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+
+    GameObjectID newID = (objectSlot.mGeneration << ObjectIDSlotBits) | slotIndex;
+    debug_assert(newID != GAMEOBJECT_ID_NULL);
+    return newID;
 }
 
-GameObjectID GameObjectsManager::GenerateUniqueID()
+void GameObjectsManager::ReleaseUniqueID(GameObjectID objectID)
+{
+    if (objectID == GAMEOBJECT_ID_NULL)
+        return;
+
+    unsigned int slotIndex = (objectID & ObjectIDSlotMask);
+    debug_assert(slotIndex < mObjectSlots.size());
+
+    ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+    objectSlot.mObject = nullptr;
+
+    // retire slot instead of wrapping generation, otherwise stale identifiers would match new objects again
+    if (objectSlot.mGeneration == ObjectIDMaxGeneration)
+        return;
+
+    ++objectSlot.mGeneration;
+
+    // queue slot to the end so reuse gets spread across all free slots
+    mFreeObjectSlots.push_back(slotIndex);
+}
+
+template<typename TObjectClass>
+void GameObjectsManager::AddToObjectsLists(TObjectClass* object, std::vector<TObjectClass*>& classObjectsList)
 {
-    GameObjectID newID = ++mIDsCounter;
-    if (newID == GAMEOBJECT_ID_NULL) // overflow
+    debug_assert(object);
+
+    object->mAllObjectsIndex = (int) mAllObjects.size();
+    mAllObjects.push_back(object);
+
+    object->mClassObjectsIndex = (int) classObjectsList.size();
+    classObjectsList.push_back(object);
+
+    if (object->mObjectID != GAMEOBJECT_ID_NULL)
     {
-        debug_assert(false);
+        ObjectSlot& objectSlot = mObjectSlots[object->mObjectID & ObjectIDSlotMask];
+        debug_assert(objectSlot.mObject == nullptr);
+        objectSlot.mObject = object;
     }
-    return newID;
+}
+
+template<typename TObjectClass>
+void GameObjectsManager::RemoveFromObjectsLists(TObjectClass* object, std::vector<TObjectClass*>& classObjectsList)
+{
+    debug_assert(object);
+    debug_assert(mAllObjects[object->mAllObjectsIndex] == object);
+    debug_assert(classObjectsList[object->mClassObjectsIndex] == object);
+
+    // move last element into freed position
+    GameObject* lastObject = mAllObjects.back();
+    lastObject->mAllObjectsIndex = object->mAllObjectsIndex;
+    mAllObjects[object->mAllObjectsIndex] = lastObject;
+    mAllObjects.pop_back();
+
+    TObjectClass* lastClassObject = classObjectsList.back();
+    lastClassObject->mClassObjectsIndex = object->mClassObjectsIndex;
+    classObjectsList[object->mClassObjectsIndex] = lastClassObject;
+    classObjectsList.pop_back();
+
+    object->mAllObjectsIndex = -1;
+    object->mClassObjectsIndex = -1;
+
+    ReleaseUniqueID(object->mObjectID);
 }
 
 bool GameObjectsManager::CreateStartupObjects()
@@ -10,11 +10,19 @@
 // define game objects manager class
 class GameObjectsManager final: public cxx::noncopyable
 {
+    friend class GameCheatsWindow;
+
 public:
     // readonly
     std::vector<GameObject*> mAllObjects;
+
+    // per class objects lists, order is not preserved on deletion
     std::vector<Pedestrian*> mPedestriansList;
     std::vector<Vehicle*> mVehiclesList;
+    std::vector<Obstacle*> mObstaclesList;
+    std::vector<Projectile*> mProjectilesList;
+    std::vector<Explosion*> mExplosionsList;
+    std::vector<Decoration*> mDecorationsList;
 
 public:
     ~GameObjectsManager();
@@ -69,12 +77,42 @@ public:
 
 private:
     bool CreateStartupObjects();
+
+    // Update pedestrians in phases, state logic is processed in groups of pedestrians with same state
+    void UpdatePedestrians();
     void DestroyAllObjects();
     void DestroyMarkedForDeletionObjects();
+
+    // Reserve or release object identifier slot within lookup table
     GameObjectID GenerateUniqueID();
+    void ReleaseUniqueID(GameObjectID objectID);
+
+    // Register object in objects lists and lookup table or remove it from there
+    // Removal is done by swapping object with last list element, so it takes constant time
+    // @param object: Object instance
+    // @param classObjectsList: Per class objects list
+    template<typename TObjectClass>
+    void AddToObjectsLists(TObjectClass* object, std::vector<TObjectClass*>& classObjectsList);
+    template<typename TObjectClass>
+    void RemoveFromObjectsLists(TObjectClass* object, std::vector<TObjectClass*>& classObjectsList);
 
 private:
-    GameObjectID mIDsCounter = 0;
+    // object identifier lookup table entry
+    struct ObjectSlot
+    {
+        GameObject* mObject = nullptr;
+        unsigned int mGeneration = 1; // gets incremented each time slot is released
+    };
+
+    std::vector<ObjectSlot> mObjectSlots;
+    std::deque<unsigned int> mFreeObjectSlots; // fifo, least recently released slot gets reused first
+
+    // objects which gets destroyed at the end of frame
+    std::vector<GameObject*> mDeleteObjectsList;
+
+    // pedestrians update buffers
+    std::vector<Pedestrian*> mPedestriansByState[ePedestrianState_COUNT];
+    std::vector<Pedestrian*> mBurningPedestrians;
 
     // objects pools
     cxx::object_pool<Pedestrian> mPedestriansPool;
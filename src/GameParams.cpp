@@ -35,11 +35,14 @@ void GameParams::SetToDefaults()
     mTrafficGenPedsChance = 50;
     mTrafficGenPedsMaxDistance = 2;
     mTrafficGenPedsCooldownTime = 1.5f;
+    mTrafficGenPedsPerTurn = 20;
     // traffic - cars
     mTrafficGenMaxCars = 12;
     mTrafficGenCarsChance = 65;
     mTrafficGenCarsMaxDistance = 4;
     mTrafficGenCarsCooldownTime = 3.0f;
+    mTrafficGenCarsPerTurn = 12;
+    mTrafficAbstractMaxCars = 200;
     // explosion
     mExplosionRadius = Convert::MapUnitsToMeters(1.0f);
     // vehicles
@@ -52,6 +55,8 @@ void GameParams::SetToDefaults()
     // ai
     mAiReactOnGunshotsDistance = Convert::MapUnitsToMeters(4.0f);
     mAiReactOnExplosionsDistance = Convert::MapUnitsToMeters(5.0f);
+    mAiCarDriveSpeed = Convert::MapUnitsToMeters(3.0f);
+    mAiCarTurnSpeed = Convert::MapUnitsToMeters(1.5f);
     // hud
     mHudBigFontMessageShowDuration = 3.0f;
     mHudCarNameShowDuration = 3.0f;
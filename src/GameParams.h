@@ -37,12 +37,15 @@ public:
     int mTrafficGenPedsChance; // chance to generate new traffic pedestrian on current turn
     int mTrafficGenPedsMaxDistance; // maximum distance from player camera, blocks
     float mTrafficGenPedsCooldownTime; // seconds between traffic generation
+    int mTrafficGenPedsPerTurn; // max number of traffic pedestrians generated on current turn for all players
 
     // traffic - cars
     int mTrafficGenMaxCars; // max number of traffic cars around the player
     int mTrafficGenCarsChance; // chance to generate new traffic car on current turn
     int mTrafficGenCarsMaxDistance; // maximum distance from player camera, blocks
     float mTrafficGenCarsCooldownTime; // seconds between traffic generation
+    int mTrafficGenCarsPerTurn; // max number of traffic cars generated on current turn for all players
+    int mTrafficAbstractMaxCars; // max number of off-screen traffic cars simulated along road lanes without physics
 
     // explosion
     float mExplosionRadius; // how far explosion can do damage, meters
@@ -59,6 +62,8 @@ public:
     // ai
     float mAiReactOnGunshotsDistance; // how far pedestrians can hear gunshots
     float mAiReactOnExplosionsDistance; // how far pedestrians can hear explosions
+    float mAiCarDriveSpeed; // max cruise speed of ai drivers, meters per second
+    float mAiCarTurnSpeed; // max speed of ai drivers while turning, meters per second
 
     // hud
     float mHudBigFontMessageShowDuration; // how long show 'wasted' on screen, seconds
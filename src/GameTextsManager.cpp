@@ -163,7 +163,7 @@ const std::string& GameTextsManager::GetText(const std::string& textID) const
 
 bool GameTextsManager::LoadTexts(const std::string& fileName)
 {
-    std::ifstream fileStream;
+    FileInputStream fileStream;
     if (!gFiles.OpenBinaryFile(fileName, fileStream))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot open texts file '%s'", fileName.c_str());
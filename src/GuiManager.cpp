@@ -8,6 +8,7 @@
 #include "CarnageGame.h"
 #include "ImGuiManager.h"
 #include "FontManager.h"
+#include "MemoryTracker.h"
 
 GuiManager gGuiManager;
 
@@ -34,6 +35,8 @@ void GuiManager::Deinit()
 
 void GuiManager::RenderFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Gui);
+
     mSpriteBatch.BeginBatch(SpriteBatch::DepthAxis_Z, eSpritesSortMode_None);
 
     Rect prevScreenRect = gGraphicsDevice.mViewportRect;
@@ -434,6 +434,15 @@ void HUDScoresPanel::UpdatePanelSize(const Point& maxSize)
 
 //////////////////////////////////////////////////////////////////////////
 
+void HUD::PreloadFonts()
+{
+    gFontManager.PreloadFont("SUB1.FON");
+    gFontManager.PreloadFont("BIG2.FON");
+    gFontManager.PreloadFont("SUB2.FON");
+    gFontManager.PreloadFont("SCORE2.FON");
+    gFontManager.PreloadFont("MISSMUL2.FON");
+}
+
 void HUD::SetupHUD(HumanPlayer* humanPlayer)
 {
     mHumanPlayer = humanPlayer;
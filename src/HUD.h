@@ -176,6 +176,9 @@ public:
 class HUD final: public cxx::noncopyable
 {
 public:
+    // Start loading hud fonts in background before hud setup
+    static void PreloadFonts();
+
     // Initialze HUD
     void SetupHUD(HumanPlayer* humanPlayer);
     
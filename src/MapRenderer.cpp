@@ -12,6 +12,12 @@
 #include "Vehicle.h"
 #include "RenderView.h"
 #include "TrafficManager.h"
+#include "MemoryManager.h"
+#include "MemoryTracker.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+const int MaxMapMeshBuildWorkers = 3;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -216,54 +222,120 @@ void MapRenderer::DrawCityMesh(RenderView* renderview)
 
 void MapRenderer::BuildMapMesh()
 {
-    CityMeshData blocksMesh;
-    for (int batchy = 0; batchy < BlocksBatchesPerSide; ++batchy)
+    auto GetChunkMapArea = [](int chunkIndex)
     {
-        for (int batchx = 0; batchx < BlocksBatchesPerSide; ++batchx)
-        {
-            Rect mapArea { 
-                batchx * BlocksBatchDims - ExtraBlocksPerSide, 
-                batchy * BlocksBatchDims - ExtraBlocksPerSide,
-                BlocksBatchDims,
-                BlocksBatchDims };
-
-            unsigned int prevVerticesCount = blocksMesh.mBlocksVertices.size();
-            unsigned int prevIndicesCount = blocksMesh.mBlocksIndices.size();
-
-            MapBlocksChunk& currChunk = mMapBlocksChunks[batchy * BlocksBatchesPerSide + batchx];
-            currChunk.mBounds.mMin = glm::vec3 { mapArea.x * METERS_PER_MAP_UNIT, 0.0f, mapArea.y * METERS_PER_MAP_UNIT };
-            currChunk.mBounds.mMax = glm::vec3 { 
-                (mapArea.x + mapArea.w) * METERS_PER_MAP_UNIT, MAP_LAYERS_COUNT * METERS_PER_MAP_UNIT, 
-                (mapArea.y + mapArea.h) * METERS_PER_MAP_UNIT};
-
-            currChunk.mVerticesStart = prevVerticesCount;
-            currChunk.mIndicesStart = prevIndicesCount;
-            
-            // append new geometry
-            GameMapHelpers::BuildMapMesh(gGameMap, mapArea, blocksMesh);
-            
-            currChunk.mVerticesCount = blocksMesh.mBlocksVertices.size() - prevVerticesCount;
-            currChunk.mIndicesCount = blocksMesh.mBlocksIndices.size() - prevIndicesCount;
-        }
+        int batchx = chunkIndex % BlocksBatchesPerSide;
+        int batchy = chunkIndex / BlocksBatchesPerSide;
+        return Rect { 
+            batchx * BlocksBatchDims - ExtraBlocksPerSide, 
+            batchy * BlocksBatchDims - ExtraBlocksPerSide,
+            BlocksBatchDims,
+            BlocksBatchDims };
+    };
+
+    // layout chunks geometry within buffers
+    unsigned int totalVerticesCount = 0;
+    unsigned int totalIndicesCount = 0;
+    for (int ichunk = 0; ichunk < BlocksBatchCount; ++ichunk)
+    {
+        Rect mapArea = GetChunkMapArea(ichunk);
+
+        MapBlocksChunk& currChunk = mMapBlocksChunks[ichunk];
+        currChunk.mBounds.mMin = glm::vec3 { mapArea.x * METERS_PER_MAP_UNIT, 0.0f, mapArea.y * METERS_PER_MAP_UNIT };
+        currChunk.mBounds.mMax = glm::vec3 { 
+            (mapArea.x + mapArea.w) * METERS_PER_MAP_UNIT, MAP_LAYERS_COUNT * METERS_PER_MAP_UNIT, 
+            (mapArea.y + mapArea.h) * METERS_PER_MAP_UNIT};
+
+        const int facesCount = GameMapHelpers::CountMapMeshFaces(gGameMap, mapArea);
+        currChunk.mVerticesStart = totalVerticesCount;
+        currChunk.mVerticesCount = facesCount * 4;
+        currChunk.mIndicesStart = totalIndicesCount;
+        currChunk.mIndicesCount = facesCount * 6;
+
+        totalVerticesCount += currChunk.mVerticesCount;
+        totalIndicesCount += currChunk.mIndicesCount;
     }
 
-    // upload map geometry to video memory
-    int totalVertexDataBytes = blocksMesh.mBlocksVertices.size() * Sizeof_CityVertex3D;
-    int totalIndexDataBytes = blocksMesh.mBlocksIndices.size() * Sizeof_DrawIndex;
+    int totalVertexDataBytes = totalVerticesCount * Sizeof_CityVertex3D;
+    int totalIndexDataBytes = totalIndicesCount * Sizeof_DrawIndex;
 
-    // upload vertex data
     mCityMeshBufferV->Setup(eBufferUsage_Static, totalVertexDataBytes, nullptr);
-    if (void* pdata = mCityMeshBufferV->Lock(BufferAccess_Write))
+    mCityMeshBufferI->Setup(eBufferUsage_Static, totalIndexDataBytes, nullptr);
+
+    unsigned char* verticesData = (unsigned char*) mCityMeshBufferV->Lock(BufferAccess_Write);
+    unsigned char* indicesData = (unsigned char*) mCityMeshBufferI->Lock(BufferAccess_Write);
+    if (verticesData && indicesData)
     {
-        memcpy(pdata, blocksMesh.mBlocksVertices.data(), totalVertexDataBytes);
-        mCityMeshBufferV->Unlock();
+        std::atomic<int> nextChunkIndex {0};
+
+        // chunks are independent, worker threads build them along with game thread
+        auto BuildChunks = [this, &nextChunkIndex, &GetChunkMapArea, verticesData, indicesData](bool isWorkerThread)
+        {
+            MEMORY_TAG_SCOPE(eMemoryTag_Render);
+
+            for (int ichunk = nextChunkIndex.fetch_add(1); ichunk < BlocksBatchCount; ichunk = nextChunkIndex.fetch_add(1))
+            {
+                const MapBlocksChunk& currChunk = mMapBlocksChunks[ichunk];
+                if (currChunk.mVerticesCount == 0)
+                    continue;
+
+                // each chunk is a separate frame for worker thread
+                if (isWorkerThread)
+                {
+                    gMemoryManager.BeginThreadFrame();
+                }
+
+                // geometry is generated in cached scratch memory and then copied to mapped buffers at once
+                unsigned int vertexDataBytes = currChunk.mVerticesCount * Sizeof_CityVertex3D;
+                unsigned int indexDataBytes = currChunk.mIndicesCount * Sizeof_DrawIndex;
+
+                cxx::memory_allocator* scratchAllocator = gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Mesh);
+                unsigned char* scratchData = nullptr;
+                if (scratchAllocator)
+                {
+                    scratchData = (unsigned char*) scratchAllocator->allocate(vertexDataBytes + indexDataBytes);
+                }
+                if (scratchData == nullptr)
+                {
+                    scratchAllocator = gMemoryManager.mHeapAllocator;
+                    scratchData = (unsigned char*) scratchAllocator->allocate(vertexDataBytes + indexDataBytes);
+                    if (scratchData == nullptr)
+                        continue;
+                }
+
+                CityVertex3D* chunkVertices = (CityVertex3D*) scratchData;
+                DrawIndex* chunkIndices = (DrawIndex*) (scratchData + vertexDataBytes);
+                GameMapHelpers::BuildMapMesh(gGameMap, GetChunkMapArea(ichunk), chunkVertices, chunkIndices, currChunk.mVerticesStart);
+
+                memcpy(verticesData + currChunk.mVerticesStart * Sizeof_CityVertex3D, chunkVertices, vertexDataBytes);
+                memcpy(indicesData + currChunk.mIndicesStart * Sizeof_DrawIndex, chunkIndices, indexDataBytes);
+
+                scratchAllocator->deallocate(scratchData);
+            }
+        };
+
+        std::vector<std::thread> workerThreads;
+#ifndef __EMSCRIPTEN__
+        const int workersCount = glm::clamp((int) std::thread::hardware_concurrency() - 1, 1, MaxMapMeshBuildWorkers);
+        for (int iworker = 0; iworker < workersCount; ++iworker)
+        {
+            workerThreads.emplace_back(BuildChunks, true);
+        }
+#endif // __EMSCRIPTEN__
+        BuildChunks(false);
+
+        for (std::thread& currThread: workerThreads)
+        {
+            currThread.join();
+        }
     }
 
-    // upload index data
-    mCityMeshBufferI->Setup(eBufferUsage_Static, totalIndexDataBytes, nullptr);
-    if (void* pdata = mCityMeshBufferI->Lock(BufferAccess_Write))
+    if (verticesData)
+    {
+        mCityMeshBufferV->Unlock();
+    }
+    if (indicesData)
     {
-        memcpy(pdata, blocksMesh.mBlocksIndices.data(), totalIndexDataBytes);
         mCityMeshBufferI->Unlock();
     }
 }
\ No newline at end of file
@@ -1,10 +1,183 @@
 #include "stdafx.h"
 #include "MemoryManager.h"
 #include "cvars.h"
+#include "MemoryTracker.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+#ifdef ENABLE_MEMORY_TRACKER
+
+// heap allocator which reports allocations to memory tracker
+class TrackedHeapAllocator final: public cxx::memory_allocator
+{
+public:
+    bool init_allocator(unsigned int bufferSizeTotal) override
+    {
+        return true;
+    }
+    void* allocate(unsigned int dataLength) override
+    {
+        void* dataPointer = MemoryTrackerAllocate(dataLength, MEMORY_TRACKER_CALL_SITE());
+        if (dataPointer == nullptr && mOutOfMemoryProc)
+        {
+            mOutOfMemoryProc(dataLength);
+        }
+        return dataPointer;
+    }
+    void* reallocate(void* dataPointer, unsigned int dataLength) override
+    {
+        void* newPointer = MemoryTrackerReallocate(dataPointer, dataLength, MEMORY_TRACKER_CALL_SITE());
+        if (newPointer == nullptr && mOutOfMemoryProc)
+        {
+            mOutOfMemoryProc(dataLength);
+        }
+        return newPointer;
+    }
+    void deallocate(void* dataPointer) override
+    {
+        MemoryTrackerFree(dataPointer);
+    }
+};
+
+#endif // ENABLE_MEMORY_TRACKER
 
 //////////////////////////////////////////////////////////////////////////
 
 const int SysMemoryFrameHeapSize = 12 * 1024 * 1024;
+const int SysMemoryDoubleBufferedHeapSize = 4 * 1024 * 1024;
+const int SysMemoryThreadFrameHeapSize = 4 * 1024 * 1024;
+
+//////////////////////////////////////////////////////////////////////////
+
+FrameArena::FrameArena(const char* arenaName)
+{
+    mStats.mName = arenaName;
+    mLinearAllocator.mOutOfMemoryProc = nullptr; // overflows are reported by category allocators
+    for (int icategory = 0; icategory < eFrameMemoryCategory_COUNT; ++icategory)
+    {
+        mCategoryAllocators[icategory].mArena = this;
+        mCategoryAllocators[icategory].mCategory = (eFrameMemoryCategory) icategory;
+        mCategoryAllocators[icategory].mOutOfMemoryProc = [](unsigned int allocateBytes)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot allocate %d bytes on frame heap", allocateBytes);
+        };
+    }
+}
+
+bool FrameArena::Initialize(unsigned int capacity)
+{
+    if (!mLinearAllocator.init_allocator(capacity))
+        return false;
+
+    mStats.mCapacity = capacity;
+    return true;
+}
+
+cxx::memory_allocator* FrameArena::GetAllocator(eFrameMemoryCategory category)
+{
+    debug_assert(category < eFrameMemoryCategory_COUNT);
+    return &mCategoryAllocators[category];
+}
+
+void FrameArena::Reset()
+{
+    unsigned int usedBytes = mLinearAllocator.get_used_size();
+    mHighWaterMark = std::max(mHighWaterMark, usedBytes);
+
+    mStats.mUsedLastFrame = usedBytes;
+    mStats.mHighWaterMark = mHighWaterMark;
+    mStats.mOverflows = mOverflows;
+    for (int icategory = 0; icategory < eFrameMemoryCategory_COUNT; ++icategory)
+    {
+        mCategoryHighWaterMark[icategory] = std::max(mCategoryHighWaterMark[icategory], mCategoryUsed[icategory]);
+        mStats.mCategoryHighWaterMark[icategory] = mCategoryHighWaterMark[icategory];
+        mCategoryUsed[icategory] = 0;
+    }
+    mLinearAllocator.reset();
+}
+
+bool FrameArena::CategoryAllocator::init_allocator(unsigned int bufferSizeTotal)
+{
+    return true;
+}
+
+void* FrameArena::CategoryAllocator::allocate(unsigned int dataLength)
+{
+    void* dataPointer = mArena->mLinearAllocator.allocate(dataLength);
+    if (dataPointer == nullptr)
+    {
+        ++mArena->mOverflows;
+        if (mOutOfMemoryProc)
+        {
+            mOutOfMemoryProc(dataLength);
+        }
+        return nullptr;
+    }
+    mArena->mCategoryUsed[mCategory] += dataLength;
+    return dataPointer;
+}
+
+void* FrameArena::CategoryAllocator::reallocate(void* dataPointer, unsigned int dataLength)
+{
+    if (dataPointer == nullptr)
+        return allocate(dataLength);
+
+    unsigned int prevLength = mArena->mLinearAllocator.get_allocation_length(dataPointer);
+    void* newPointer = mArena->mLinearAllocator.reallocate(dataPointer, dataLength);
+    if (newPointer == nullptr)
+    {
+        ++mArena->mOverflows;
+        if (mOutOfMemoryProc)
+        {
+            mOutOfMemoryProc(dataLength);
+        }
+        return nullptr;
+    }
+    // previous block is accounted already, count only difference
+    unsigned int& categoryUsed = mArena->mCategoryUsed[mCategory];
+    if (dataLength > prevLength)
+    {
+        categoryUsed += (dataLength - prevLength);
+    }
+    else
+    {
+        categoryUsed -= std::min(categoryUsed, prevLength - dataLength);
+    }
+    return newPointer;
+}
+
+void FrameArena::CategoryAllocator::deallocate(void* dataPointer)
+{
+    if (dataPointer == nullptr)
+        return;
+
+    // only last allocation is actually released
+    unsigned int usedBytes = mArena->mLinearAllocator.get_used_size();
+    mArena->mLinearAllocator.deallocate(dataPointer);
+
+    unsigned int releasedBytes = usedBytes - mArena->mLinearAllocator.get_used_size();
+    unsigned int& categoryUsed = mArena->mCategoryUsed[mCategory];
+    categoryUsed -= std::min(categoryUsed, releasedBytes);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// returns worker thread frame arena to memory manager on thread exit
+struct ThreadFrameArenaHolder
+{
+public:
+    ~ThreadFrameArenaHolder()
+    {
+        if (mFrameArena)
+        {
+            gMemoryManager.ReleaseThreadFrameArena(mFrameArena);
+        }
+    }
+public:
+    FrameArena* mFrameArena = nullptr;
+};
+
+static thread_local ThreadFrameArenaHolder gThreadFrameArena;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -14,24 +187,23 @@ bool MemoryManager::Initialize()
 {
     gConsole.LogMessage(eLogMessage_Info, "Init MemoryManager");
 
+    mMainThreadID = std::this_thread::get_id();
+
     if (gCvarMemEnableFrameHeapAllocator.mValue)
     {
         gConsole.LogMessage(eLogMessage_Info, "Frame heap memory size: %d", SysMemoryFrameHeapSize);
 
-        mFrameHeapAllocator = new cxx::linear_memory_allocator;
-        if (!mFrameHeapAllocator->init_allocator(SysMemoryFrameHeapSize))
+        mMainFrameArena = new FrameArena("Main frame");
+        mDoubleBufferedArenas[0] = new FrameArena("Double buffered 0");
+        mDoubleBufferedArenas[1] = new FrameArena("Double buffered 1");
+        if (!mMainFrameArena->Initialize(SysMemoryFrameHeapSize) ||
+            !mDoubleBufferedArenas[0]->Initialize(SysMemoryDoubleBufferedHeapSize) ||
+            !mDoubleBufferedArenas[1]->Initialize(SysMemoryDoubleBufferedHeapSize))
         {
             gConsole.LogMessage(eLogMessage_Warning, "Fail to allocate frame heap memory buffer");
-            SafeDelete(mFrameHeapAllocator);
-        }
-        else
-        {
-            // setup out of memory handler
-            mFrameHeapAllocator->mOutOfMemoryProc = [](unsigned int allocateBytes)
-            {
-                gConsole.LogMessage(eLogMessage_Warning, "Cannot allocate %d bytes on frame heap", allocateBytes);
-                debug_assert(false);
-            };
+            SafeDelete(mMainFrameArena);
+            SafeDelete(mDoubleBufferedArenas[0]);
+            SafeDelete(mDoubleBufferedArenas[1]);
         }
     }
     else
@@ -39,7 +211,11 @@ bool MemoryManager::Initialize()
         gConsole.LogMessage(eLogMessage_Info, "Frame heap memory disabled");
     }
 
+#ifdef ENABLE_MEMORY_TRACKER
+    mHeapAllocator = new TrackedHeapAllocator;
+#else
     mHeapAllocator = new cxx::heap_memory_allocator;
+#endif
     mHeapAllocator->init_allocator(0);
 
     mHeapAllocator->mOutOfMemoryProc = [](unsigned int allocateBytes)
@@ -53,14 +229,136 @@ bool MemoryManager::Initialize()
 
 void MemoryManager::Deinit()
 {
-    SafeDelete(mFrameHeapAllocator);
+    std::lock_guard<std::mutex> arenasLock (mArenasMutex);
+
+    SafeDelete(mMainFrameArena);
+    SafeDelete(mDoubleBufferedArenas[0]);
+    SafeDelete(mDoubleBufferedArenas[1]);
+
+    // worker threads are expected to be stopped at this point
+    for (FrameArena* currArena: mThreadFrameArenas)
+    {
+        delete currArena;
+    }
+    mThreadFrameArenas.clear();
+    mFreeThreadFrameArenas.clear();
+    gThreadFrameArena.mFrameArena = nullptr;
+
     SafeDelete(mHeapAllocator);
 }
 
 void MemoryManager::FlushFrameHeapMemory()
 {
-    if (mFrameHeapAllocator)
+    debug_assert(std::this_thread::get_id() == mMainThreadID);
+
+    if (mMainFrameArena)
+    {
+        ResetFrameArena(mMainFrameArena);
+    }
+
+    // previous frame data remains valid in other buffer
+    if (mDoubleBufferedArenas[0])
+    {
+        mCurrentDoubleBufferedArena = (mCurrentDoubleBufferedArena + 1) % 2;
+        ResetFrameArena(mDoubleBufferedArenas[mCurrentDoubleBufferedArena]);
+    }
+}
+
+void MemoryManager::BeginThreadFrame()
+{
+    // game thread frames are driven by FlushFrameHeapMemory
+    debug_assert(std::this_thread::get_id() != mMainThreadID);
+
+    if (mMainFrameArena == nullptr)
+        return;
+
+    if (gThreadFrameArena.mFrameArena == nullptr)
+    {
+        gThreadFrameArena.mFrameArena = CreateThreadFrameArena();
+        return;
+    }
+    ResetFrameArena(gThreadFrameArena.mFrameArena);
+}
+
+cxx::memory_allocator* MemoryManager::GetFrameAllocator(eFrameMemoryCategory category)
+{
+    if (mMainFrameArena == nullptr)
+        return nullptr;
+
+    if (std::this_thread::get_id() == mMainThreadID)
+        return mMainFrameArena->GetAllocator(category);
+
+    // BeginThreadFrame was not called on this thread
+    FrameArena* frameArena = gThreadFrameArena.mFrameArena;
+    if (frameArena == nullptr)
+        return nullptr;
+
+    return frameArena->GetAllocator(category);
+}
+
+cxx::memory_allocator* MemoryManager::GetDoubleBufferedAllocator(eFrameMemoryCategory category)
+{
+    debug_assert(std::this_thread::get_id() == mMainThreadID);
+
+    FrameArena* frameArena = mDoubleBufferedArenas[mCurrentDoubleBufferedArena];
+    if (frameArena == nullptr)
+        return nullptr;
+
+    return frameArena->GetAllocator(category);
+}
+
+void MemoryManager::GetFrameArenasStats(std::vector<FrameArenaStats>& outputStats) const
+{
+    outputStats.clear();
+
+    std::lock_guard<std::mutex> arenasLock (mArenasMutex);
+    for (const FrameArena* currArena: { mMainFrameArena, mDoubleBufferedArenas[0], mDoubleBufferedArenas[1] })
     {
-        mFrameHeapAllocator->reset();
+        if (currArena)
+        {
+            outputStats.push_back(currArena->mStats);
+        }
     }
+    for (const FrameArena* currArena: mThreadFrameArenas)
+    {
+        outputStats.push_back(currArena->mStats);
+    }
+}
+
+FrameArena* MemoryManager::CreateThreadFrameArena()
+{
+    std::lock_guard<std::mutex> arenasLock (mArenasMutex);
+    if (!mFreeThreadFrameArenas.empty())
+    {
+        FrameArena* frameArena = mFreeThreadFrameArenas.back();
+        mFreeThreadFrameArenas.pop_back();
+        return frameArena;
+    }
+
+    FrameArena* frameArena = new FrameArena("Worker thread");
+    if (!frameArena->Initialize(SysMemoryThreadFrameHeapSize))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Fail to allocate thread frame heap memory buffer");
+        delete frameArena;
+        return nullptr;
+    }
+    mThreadFrameArenas.push_back(frameArena);
+    return frameArena;
+}
+
+void MemoryManager::ReleaseThreadFrameArena(FrameArena* frameArena)
+{
+    std::lock_guard<std::mutex> arenasLock (mArenasMutex);
+    if (cxx::contains(mThreadFrameArenas, frameArena))
+    {
+        // publish statistics of last thread frame
+        frameArena->Reset();
+        mFreeThreadFrameArenas.push_back(frameArena);
+    }
+}
+
+void MemoryManager::ResetFrameArena(FrameArena* frameArena)
+{
+    std::lock_guard<std::mutex> arenasLock (mArenasMutex);
+    frameArena->Reset();
 }
\ No newline at end of file
@@ -2,16 +2,76 @@
 
 #include "mem_allocators.h"
 
-// defines system memory manager class
-class MemoryManager final: public cxx::noncopyable
+// frame memory usage categories
+enum eFrameMemoryCategory
+{
+    eFrameMemoryCategory_Pixels,
+    eFrameMemoryCategory_Mesh,
+    eFrameMemoryCategory_PhysicsQueries,
+    eFrameMemoryCategory_Other,
+    eFrameMemoryCategory_COUNT
+};
+
+// frame memory arena usage statistics info
+struct FrameArenaStats
 {
 public:
-    // allocates and deallocates frame heap memory
+    const char* mName = "";
+    unsigned int mCapacity = 0; // bytes
+    unsigned int mUsedLastFrame = 0; // bytes
+    unsigned int mHighWaterMark = 0; // bytes
+    unsigned int mCategoryHighWaterMark[eFrameMemoryCategory_COUNT] = {}; // bytes
+    int mOverflows = 0; // total
+};
+
+// Linear memory arena which gets reset once per frame by its owner thread
+// Allocations are attributed to usage categories to collect high water marks
+class FrameArena final: public cxx::noncopyable
+{
+    friend class MemoryManager;
+
+public:
+    // readonly
+    FrameArenaStats mStats; // published on reset, access with memory manager stats lock
+
+public:
+    FrameArena(const char* arenaName);
+
+    bool Initialize(unsigned int capacity);
+
+    // Get memory allocator which attributes allocations to specified category
+    cxx::memory_allocator* GetAllocator(eFrameMemoryCategory category);
+
+    // Invalidate all allocated memory and update statistics, published stats should be locked
+    void Reset();
 
-    // it's intended for objects that only should exist for a short period of time
-    // all allocated memory most likely will be invalidated at start of next frame
-    cxx::memory_allocator* mFrameHeapAllocator = nullptr;
+private:
+    // allocator adapter for single category
+    class CategoryAllocator final: public cxx::memory_allocator
+    {
+    public:
+        bool init_allocator(unsigned int bufferSizeTotal) override;
+        void* allocate(unsigned int dataLength) override;
+        void* reallocate(void* dataPointer, unsigned int dataLength) override;
+        void deallocate(void* dataPointer) override;
+    public:
+        FrameArena* mArena = nullptr;
+        eFrameMemoryCategory mCategory = eFrameMemoryCategory_Other;
+    };
 
+private:
+    cxx::linear_memory_allocator mLinearAllocator;
+    CategoryAllocator mCategoryAllocators[eFrameMemoryCategory_COUNT];
+    unsigned int mCategoryUsed[eFrameMemoryCategory_COUNT] = {};
+    unsigned int mHighWaterMark = 0;
+    unsigned int mCategoryHighWaterMark[eFrameMemoryCategory_COUNT] = {};
+    int mOverflows = 0;
+};
+
+// defines system memory manager class
+class MemoryManager final: public cxx::noncopyable
+{
+public:
     cxx::memory_allocator* mHeapAllocator = nullptr; // standard heap memory allocator
 
 public:
@@ -21,8 +81,43 @@ public:
 
     void Deinit();
 
-    // will reset previously allocated frame heap memory
+    // will reset previously allocated frame heap memory of game thread and swap double buffered arenas
     void FlushFrameHeapMemory();
+
+    // Start new frame on current worker thread, must be called by thread itself before using its frame allocator;
+    // thread arena gets acquired on first call and reset on each next call, it is released when thread exits
+    void BeginThreadFrame();
+
+    // Get frame memory allocator of current thread, it's intended for objects that only should exist for a short period of time;
+    // on game thread memory is invalidated at start of next frame, on worker thread at next BeginThreadFrame call
+    // @returns nullptr if frame memory is disabled
+    cxx::memory_allocator* GetFrameAllocator(eFrameMemoryCategory category);
+
+    // Get frame memory allocator which data survives until the end of next frame, game thread only
+    // @returns nullptr if frame memory is disabled
+    cxx::memory_allocator* GetDoubleBufferedAllocator(eFrameMemoryCategory category);
+
+    // Get copy of all arenas statistics
+    void GetFrameArenasStats(std::vector<FrameArenaStats>& outputStats) const;
+
+private:
+    FrameArena* CreateThreadFrameArena();
+    void ReleaseThreadFrameArena(FrameArena* frameArena);
+
+    void ResetFrameArena(FrameArena* frameArena);
+
+private:
+    friend struct ThreadFrameArenaHolder;
+
+    FrameArena* mMainFrameArena = nullptr;
+    FrameArena* mDoubleBufferedArenas[2] = {};
+    int mCurrentDoubleBufferedArena = 0;
+
+    // worker threads arenas, each one is reset explicitly by its owner thread
+    std::vector<FrameArena*> mThreadFrameArenas;
+    std::vector<FrameArena*> mFreeThreadFrameArenas;
+    std::thread::id mMainThreadID;
+    mutable std::mutex mArenasMutex; // protects arenas lists and published stats
 };
 
 extern MemoryManager gMemoryManager;
\ No newline at end of file
@@ -0,0 +1,735 @@
+#include "stdafx.h"
+#include "MemoryTracker.h"
+#include "ConsoleVar.h"
+
+#if defined(ENABLE_MEMORY_TRACKER) && (OS_NAME == OS_LINUX)
+    #include <dlfcn.h>
+    #include <execinfo.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+static void MemSnapshotCommandProc(const std::string& commandParams)
+{
+    gMemoryTracker.TakeSnapshot(commandParams.empty() ? "last" : commandParams);
+}
+
+static void MemDiffCommandProc(const std::string& commandParams)
+{
+    std::string snapshotNameA;
+    std::string snapshotNameB;
+
+    std::istringstream paramsStream(commandParams);
+    if (!(paramsStream >> snapshotNameA >> snapshotNameB))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Usage: mem_diff <snapshotA> <snapshotB>");
+        return;
+    }
+    gMemoryTracker.DiffSnapshots(snapshotNameA, snapshotNameB);
+}
+
+CvarCommand gCvarMemSnapshot("mem_snapshot", MemSnapshotCommandProc, "Take named memory snapshot and print it", CvarFlags_None);
+CvarCommand gCvarMemDiff("mem_diff", MemDiffCommandProc, "Print difference between two named memory snapshots", CvarFlags_None);
+
+//////////////////////////////////////////////////////////////////////////
+
+static const char* MemoryTagNames[eMemoryTag_COUNT] =
+{
+    "default",
+    "render",
+    "gui",
+    "audio",
+    "physics",
+    "gamemap",
+    "gameobjects",
+    "particles",
+    "traffic",
+    "ai",
+};
+
+const int MemoryTrackerTopCallSites = 16;
+
+#ifdef ENABLE_MEMORY_TRACKER
+
+// tracker state must not require dynamic initialization, allocations may happen before main and after exit
+namespace
+{
+    const int MaxCallSites = 4096; // power of two
+    const int MaxUsedCallSites = MaxCallSites * 3 / 4; // limit probing length
+    const int OtherCallSitesIndex = MaxCallSites; // collects allocations from unknown call sites or when table is full
+    const unsigned int AllocationSignature = 0x4D454D54;
+    const unsigned int AlignedAllocationSignature = 0x4D454D41; // original block pointer is stored before header
+
+    struct alignas(16) AllocationHeader
+    {
+        size_t mDataLength;
+        unsigned int mSignature;
+        unsigned short mMemoryTag;
+        unsigned short mCallSiteIndex;
+    };
+
+    struct CallSiteEntry
+    {
+        const void* mAddress;
+        long long mLiveBytes;
+        long long mLiveAllocations;
+        long long mTotalBytes;
+        long long mTotalAllocations;
+    };
+
+    struct TagEntry
+    {
+        long long mLiveBytes;
+        long long mLiveAllocations;
+        long long mTotalBytes;
+        long long mTotalAllocations;
+    };
+
+    std::atomic_flag gTrackerLock = ATOMIC_FLAG_INIT;
+    CallSiteEntry gCallSites[MaxCallSites + 1];
+    int gUsedCallSites = 0;
+    TagEntry gTags[eMemoryTag_COUNT];
+
+    thread_local eMemoryTag gCurrentMemoryTag = eMemoryTag_Default;
+
+#if OS_NAME == OS_LINUX
+    const int MaxCallStackFrames = 16;
+    const int CallStackSkipFrames = 2; // capture function itself and allocation function
+    const int MaxCachedFrames = 8192; // power of two
+
+    struct FrameEntry
+    {
+        const void* mAddress;
+        bool mLibraryFrame;
+    };
+
+    FrameEntry gCachedFrames[MaxCachedFrames];
+    int gUsedCachedFrames = 0;
+    const void* gExecutableBase = nullptr;
+
+    thread_local bool gCapturingCallSite = false;
+#endif
+
+    // spin lock is used because std::mutex may be already destroyed when static objects get released
+    class TrackerLockScope final
+    {
+    public:
+        TrackerLockScope()
+        {
+            while (gTrackerLock.test_and_set(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+        ~TrackerLockScope()
+        {
+            gTrackerLock.clear(std::memory_order_release);
+        }
+    };
+
+    // must be called with tracker locked
+    int GetCallSiteIndex(const void* address)
+    {
+        if (address == nullptr)
+            return OtherCallSitesIndex;
+
+        unsigned int hash = (unsigned int) (((uintptr_t) address >> 2) * 2654435761u);
+        for (int iprobe = 0; iprobe < MaxCallSites; ++iprobe)
+        {
+            int callSiteIndex = (int) ((hash + iprobe) & (MaxCallSites - 1));
+
+            CallSiteEntry& callSite = gCallSites[callSiteIndex];
+            if (callSite.mAddress == address)
+                return callSiteIndex;
+
+            if (callSite.mAddress == nullptr)
+            {
+                if (gUsedCallSites >= MaxUsedCallSites)
+                    break;
+
+                callSite.mAddress = address;
+                ++gUsedCallSites;
+                return callSiteIndex;
+            }
+        }
+        return OtherCallSitesIndex;
+    }
+
+#if OS_NAME == OS_LINUX
+    // test whether mangled symbol belongs to std, __gnu_cxx or cxx namespaces or it is operator new
+    bool IsLibrarySymbol(const char* symbolName)
+    {
+        if (::strncmp(symbolName, "_ZN", 3) == 0)
+        {
+            symbolName += (symbolName[3] == 'K') ? 4 : 3; // const member function
+            // std abbreviations: St - std::, Sa - std::allocator, Sb - std::basic_string, Ss - std::string, etc
+            if (symbolName[0] == 'S' && ::strchr("tabsiod", symbolName[1]))
+                return true;
+
+            return ::strncmp(symbolName, "9__gnu_cxx", 10) == 0 || ::strncmp(symbolName, "3cxx", 4) == 0;
+        }
+        return ::strncmp(symbolName, "_ZSt", 4) == 0 || ::strncmp(symbolName, "_Znw", 4) == 0 || ::strncmp(symbolName, "_Zna", 4) == 0;
+    }
+
+    // symbol names of executable are only available when linked with -rdynamic,
+    // must be called with tracker locked
+    bool IsLibraryFrame(const void* address)
+    {
+        unsigned int hash = (unsigned int) (((uintptr_t) address >> 2) * 2654435761u);
+        for (int iprobe = 0; iprobe < MaxCachedFrames; ++iprobe)
+        {
+            FrameEntry& frameEntry = gCachedFrames[(hash + iprobe) & (MaxCachedFrames - 1)];
+            if (frameEntry.mAddress == address)
+                return frameEntry.mLibraryFrame;
+
+            if (frameEntry.mAddress == nullptr)
+            {
+                if (gUsedCachedFrames >= MaxCachedFrames / 2)
+                    break;
+
+                if (gExecutableBase == nullptr)
+                {
+                    Dl_info executableInfo;
+                    if (::dladdr((const void*) &MemoryTrackerCaptureCallSite, &executableInfo))
+                    {
+                        gExecutableBase = executableInfo.dli_fbase;
+                    }
+                }
+
+                // shared libraries frames are skipped as well
+                Dl_info symbolInfo;
+                bool isLibraryFrame = !::dladdr(address, &symbolInfo) || (symbolInfo.dli_fbase != gExecutableBase) ||
+                    (symbolInfo.dli_sname && IsLibrarySymbol(symbolInfo.dli_sname));
+
+                frameEntry.mAddress = address;
+                frameEntry.mLibraryFrame = isLibraryFrame;
+                ++gUsedCachedFrames;
+                return isLibraryFrame;
+            }
+        }
+        return false;
+    }
+#endif
+
+    void RegisterAllocation(AllocationHeader* header, const void* callSite)
+    {
+        TrackerLockScope lockScope;
+
+        header->mCallSiteIndex = (unsigned short) GetCallSiteIndex(callSite);
+
+        long long dataLength = (long long) header->mDataLength;
+
+        TagEntry& tagEntry = gTags[header->mMemoryTag];
+        tagEntry.mLiveBytes += dataLength;
+        tagEntry.mTotalBytes += dataLength;
+        ++tagEntry.mLiveAllocations;
+        ++tagEntry.mTotalAllocations;
+
+        CallSiteEntry& callSiteEntry = gCallSites[header->mCallSiteIndex];
+        callSiteEntry.mLiveBytes += dataLength;
+        callSiteEntry.mTotalBytes += dataLength;
+        ++callSiteEntry.mLiveAllocations;
+        ++callSiteEntry.mTotalAllocations;
+    }
+
+    void UnregisterAllocation(AllocationHeader* header)
+    {
+        TrackerLockScope lockScope;
+
+        long long dataLength = (long long) header->mDataLength;
+
+        TagEntry& tagEntry = gTags[header->mMemoryTag];
+        tagEntry.mLiveBytes -= dataLength;
+        --tagEntry.mLiveAllocations;
+
+        CallSiteEntry& callSiteEntry = gCallSites[header->mCallSiteIndex];
+        callSiteEntry.mLiveBytes -= dataLength;
+        --callSiteEntry.mLiveAllocations;
+    }
+
+} // namespace
+
+#if OS_NAME == OS_LINUX
+__attribute__((noinline)) const void* MemoryTrackerCaptureCallSite()
+{
+    // backtrace may allocate memory on first use
+    if (gCapturingCallSite)
+        return nullptr;
+
+    void* frames[MaxCallStackFrames];
+    gCapturingCallSite = true;
+    int framesCount = ::backtrace(frames, MaxCallStackFrames);
+    gCapturingCallSite = false;
+
+    if (framesCount <= CallStackSkipFrames)
+        return nullptr;
+
+    TrackerLockScope lockScope;
+    for (int iframe = CallStackSkipFrames; iframe < framesCount; ++iframe)
+    {
+        if (!IsLibraryFrame(frames[iframe]))
+            return frames[iframe];
+    }
+    return frames[CallStackSkipFrames];
+}
+#endif
+
+void* MemoryTrackerAllocate(size_t dataLength, const void* callSite)
+{
+    AllocationHeader* header = (AllocationHeader*) malloc(sizeof(AllocationHeader) + dataLength);
+    if (header == nullptr)
+        return nullptr;
+
+    header->mDataLength = dataLength;
+    header->mSignature = AllocationSignature;
+    header->mMemoryTag = (unsigned short) gCurrentMemoryTag;
+    RegisterAllocation(header, callSite);
+    return header + 1;
+}
+
+void* MemoryTrackerReallocate(void* dataPointer, size_t dataLength, const void* callSite)
+{
+    if (dataPointer == nullptr)
+        return MemoryTrackerAllocate(dataLength, callSite);
+
+    AllocationHeader* header = ((AllocationHeader*) dataPointer) - 1;
+    debug_assert(header->mSignature == AllocationSignature); // aligned allocations cannot be reallocated
+
+    UnregisterAllocation(header);
+    AllocationHeader* newHeader = (AllocationHeader*) realloc(header, sizeof(AllocationHeader) + dataLength);
+    if (newHeader == nullptr)
+    {
+        // original memory block is still valid
+        RegisterAllocation(header, callSite);
+        return nullptr;
+    }
+    newHeader->mDataLength = dataLength;
+    RegisterAllocation(newHeader, callSite);
+    return newHeader + 1;
+}
+
+void MemoryTrackerFree(void* dataPointer)
+{
+    if (dataPointer == nullptr)
+        return;
+
+    AllocationHeader* header = ((AllocationHeader*) dataPointer) - 1;
+    debug_assert(header->mSignature == AllocationSignature || header->mSignature == AlignedAllocationSignature);
+
+    UnregisterAllocation(header);
+    if (header->mSignature == AlignedAllocationSignature)
+    {
+        void* blockPointer = ((void**) header)[-1];
+        header->mSignature = 0;
+        free(blockPointer);
+        return;
+    }
+    header->mSignature = 0;
+    free(header);
+}
+
+static void* MemoryTrackerAllocateAligned(size_t dataLength, size_t alignment, const void* callSite)
+{
+    if (alignment <= alignof(AllocationHeader))
+        return MemoryTrackerAllocate(dataLength, callSite);
+
+    char* blockPointer = (char*) malloc(sizeof(void*) + sizeof(AllocationHeader) + alignment + dataLength);
+    if (blockPointer == nullptr)
+        return nullptr;
+
+    uintptr_t dataAddress = (uintptr_t) (blockPointer + sizeof(void*) + sizeof(AllocationHeader));
+    dataAddress = (dataAddress + alignment - 1) & ~((uintptr_t) alignment - 1);
+
+    AllocationHeader* header = ((AllocationHeader*) dataAddress) - 1;
+    ((void**) header)[-1] = blockPointer;
+    header->mDataLength = dataLength;
+    header->mSignature = AlignedAllocationSignature;
+    header->mMemoryTag = (unsigned short) gCurrentMemoryTag;
+    RegisterAllocation(header, callSite);
+    return (void*) dataAddress;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// global allocation functions replacement
+
+void* operator new(size_t dataLength)
+{
+    void* dataPointer = MemoryTrackerAllocate(dataLength, MEMORY_TRACKER_CALL_SITE());
+    if (dataPointer == nullptr)
+        throw std::bad_alloc();
+
+    return dataPointer;
+}
+
+void* operator new[](size_t dataLength)
+{
+    void* dataPointer = MemoryTrackerAllocate(dataLength, MEMORY_TRACKER_CALL_SITE());
+    if (dataPointer == nullptr)
+        throw std::bad_alloc();
+
+    return dataPointer;
+}
+
+void* operator new(size_t dataLength, const std::nothrow_t&) noexcept
+{
+    return MemoryTrackerAllocate(dataLength, MEMORY_TRACKER_CALL_SITE());
+}
+
+void* operator new[](size_t dataLength, const std::nothrow_t&) noexcept
+{
+    return MemoryTrackerAllocate(dataLength, MEMORY_TRACKER_CALL_SITE());
+}
+
+void operator delete(void* dataPointer) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete(void* dataPointer, size_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer, size_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete(void* dataPointer, const std::nothrow_t&) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer, const std::nothrow_t&) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+#ifdef __cpp_aligned_new
+
+void* operator new(size_t dataLength, std::align_val_t alignment)
+{
+    void* dataPointer = MemoryTrackerAllocateAligned(dataLength, (size_t) alignment, MEMORY_TRACKER_CALL_SITE());
+    if (dataPointer == nullptr)
+        throw std::bad_alloc();
+
+    return dataPointer;
+}
+
+void* operator new[](size_t dataLength, std::align_val_t alignment)
+{
+    void* dataPointer = MemoryTrackerAllocateAligned(dataLength, (size_t) alignment, MEMORY_TRACKER_CALL_SITE());
+    if (dataPointer == nullptr)
+        throw std::bad_alloc();
+
+    return dataPointer;
+}
+
+void* operator new(size_t dataLength, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return MemoryTrackerAllocateAligned(dataLength, (size_t) alignment, MEMORY_TRACKER_CALL_SITE());
+}
+
+void* operator new[](size_t dataLength, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return MemoryTrackerAllocateAligned(dataLength, (size_t) alignment, MEMORY_TRACKER_CALL_SITE());
+}
+
+void operator delete(void* dataPointer, std::align_val_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer, std::align_val_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete(void* dataPointer, size_t, std::align_val_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer, size_t, std::align_val_t) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete(void* dataPointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+void operator delete[](void* dataPointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    MemoryTrackerFree(dataPointer);
+}
+
+#endif // __cpp_aligned_new
+
+//////////////////////////////////////////////////////////////////////////
+
+MemoryTagScope::MemoryTagScope(eMemoryTag memoryTag)
+    : mPrevTag(gCurrentMemoryTag)
+{
+    gCurrentMemoryTag = memoryTag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    gCurrentMemoryTag = mPrevTag;
+}
+
+#endif // ENABLE_MEMORY_TRACKER
+
+//////////////////////////////////////////////////////////////////////////
+
+MemoryTracker gMemoryTracker;
+
+bool MemoryTracker::IsEnabled() const
+{
+#ifdef ENABLE_MEMORY_TRACKER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::UpdateFrame()
+{
+    ++mFrameIndex;
+
+#ifdef ENABLE_MEMORY_TRACKER
+    long long totalAllocations = 0;
+    long long totalBytes = 0;
+    {
+        TrackerLockScope lockScope;
+        for (const TagEntry& currTag: gTags)
+        {
+            totalAllocations += currTag.mTotalAllocations;
+            totalBytes += currTag.mTotalBytes;
+        }
+    }
+    mFrameAllocations = totalAllocations - mPrevTotalAllocations;
+    mFrameAllocatedBytes = totalBytes - mPrevTotalBytes;
+    mPrevTotalAllocations = totalAllocations;
+    mPrevTotalBytes = totalBytes;
+#endif
+}
+
+void MemoryTracker::TakeSnapshot(const std::string& snapshotName)
+{
+    if (!IsEnabled())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Memory tracker is disabled, build with ENABLE_MEMORY_TRACKER");
+        return;
+    }
+
+    MemorySnapshot& snapshot = mSnapshots[snapshotName];
+    CollectSnapshot(snapshot);
+
+    gConsole.LogMessage(eLogMessage_Info, "Memory snapshot '%s' at frame %u", snapshotName.c_str(), snapshot.mFrameIndex);
+    DumpSnapshot(snapshot);
+}
+
+bool MemoryTracker::DiffSnapshots(const std::string& snapshotNameA, const std::string& snapshotNameB) const
+{
+    auto snapshotA = mSnapshots.find(snapshotNameA);
+    auto snapshotB = mSnapshots.find(snapshotNameB);
+    if (snapshotA == mSnapshots.end() || snapshotB == mSnapshots.end())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Memory snapshot '%s' is not found",
+            (snapshotA == mSnapshots.end()) ? snapshotNameA.c_str() : snapshotNameB.c_str());
+        return false;
+    }
+
+    const MemorySnapshot& firstSnapshot = snapshotA->second;
+    const MemorySnapshot& secondSnapshot = snapshotB->second;
+
+    long long framesCount = std::max(1LL, (long long) secondSnapshot.mFrameIndex - (long long) firstSnapshot.mFrameIndex);
+    gConsole.LogMessage(eLogMessage_Info, "Memory diff '%s' -> '%s', %lld frames", snapshotNameA.c_str(), snapshotNameB.c_str(), framesCount);
+
+    for (int itag = 0; itag < eMemoryTag_COUNT; ++itag)
+    {
+        const MemoryTagStats& tagA = firstSnapshot.mTags[itag];
+        const MemoryTagStats& tagB = secondSnapshot.mTags[itag];
+
+        long long allocations = tagB.mTotalAllocations - tagA.mTotalAllocations;
+        if (allocations == 0 && tagB.mLiveBytes == tagA.mLiveBytes)
+            continue;
+
+        gConsole.LogMessage(eLogMessage_Info, "  %-12s live %+lld bytes, %lld allocations (%.1f per frame)", MemoryTagNames[itag],
+            tagB.mLiveBytes - tagA.mLiveBytes, allocations, (double) allocations / framesCount);
+    }
+
+    // call sites lists are sorted by address, so difference is computed in single pass
+    std::vector<MemoryCallSiteStats> callSitesDiff;
+    auto callSiteA = firstSnapshot.mCallSites.begin();
+    for (const MemoryCallSiteStats& callSiteB: secondSnapshot.mCallSites)
+    {
+        while (callSiteA != firstSnapshot.mCallSites.end() && callSiteA->mAddress < callSiteB.mAddress)
+        {
+            ++callSiteA;
+        }
+
+        MemoryCallSiteStats currDiff = callSiteB;
+        if (callSiteA != firstSnapshot.mCallSites.end() && callSiteA->mAddress == callSiteB.mAddress)
+        {
+            currDiff.mLiveBytes -= callSiteA->mLiveBytes;
+            currDiff.mLiveAllocations -= callSiteA->mLiveAllocations;
+            currDiff.mTotalBytes -= callSiteA->mTotalBytes;
+            currDiff.mTotalAllocations -= callSiteA->mTotalAllocations;
+        }
+        if (currDiff.mTotalAllocations > 0)
+        {
+            callSitesDiff.push_back(currDiff);
+        }
+    }
+
+    std::sort(callSitesDiff.begin(), callSitesDiff.end(), [](const MemoryCallSiteStats& lhs, const MemoryCallSiteStats& rhs)
+        {
+            return lhs.mTotalAllocations > rhs.mTotalAllocations;
+        });
+
+    gConsole.LogMessage(eLogMessage_Info, "Top allocating call sites:");
+
+    std::string callSiteName;
+    for (int icallsite = 0, Count = std::min((int) callSitesDiff.size(), MemoryTrackerTopCallSites); icallsite < Count; ++icallsite)
+    {
+        const MemoryCallSiteStats& currCallSite = callSitesDiff[icallsite];
+        GetCallSiteName(currCallSite.mAddress, callSiteName);
+        gConsole.LogMessage(eLogMessage_Info, "  %s: %lld allocations (%.1f per frame), %lld bytes, live %+lld bytes", callSiteName.c_str(),
+            currCallSite.mTotalAllocations, (double) currCallSite.mTotalAllocations / framesCount, currCallSite.mTotalBytes, currCallSite.mLiveBytes);
+    }
+    return true;
+}
+
+void MemoryTracker::GetTagStats(eMemoryTag memoryTag, MemoryTagStats& outputStats) const
+{
+    debug_assert(memoryTag < eMemoryTag_COUNT);
+
+    outputStats = MemoryTagStats();
+#ifdef ENABLE_MEMORY_TRACKER
+    TrackerLockScope lockScope;
+    outputStats.mLiveBytes = gTags[memoryTag].mLiveBytes;
+    outputStats.mLiveAllocations = gTags[memoryTag].mLiveAllocations;
+    outputStats.mTotalBytes = gTags[memoryTag].mTotalBytes;
+    outputStats.mTotalAllocations = gTags[memoryTag].mTotalAllocations;
+#endif
+}
+
+const char* MemoryTracker::GetTagName(eMemoryTag memoryTag) const
+{
+    debug_assert(memoryTag < eMemoryTag_COUNT);
+    return MemoryTagNames[memoryTag];
+}
+
+void MemoryTracker::CollectSnapshot(MemorySnapshot& outputSnapshot) const
+{
+    outputSnapshot.mFrameIndex = mFrameIndex;
+    outputSnapshot.mCallSites.clear();
+
+#ifdef ENABLE_MEMORY_TRACKER
+    // reserve in advance, no allocations are allowed while tracker is locked
+    outputSnapshot.mCallSites.reserve(MaxCallSites + 1);
+    {
+        TrackerLockScope lockScope;
+        for (int itag = 0; itag < eMemoryTag_COUNT; ++itag)
+        {
+            MemoryTagStats& tagStats = outputSnapshot.mTags[itag];
+            tagStats.mLiveBytes = gTags[itag].mLiveBytes;
+            tagStats.mLiveAllocations = gTags[itag].mLiveAllocations;
+            tagStats.mTotalBytes = gTags[itag].mTotalBytes;
+            tagStats.mTotalAllocations = gTags[itag].mTotalAllocations;
+        }
+        for (const CallSiteEntry& currEntry: gCallSites)
+        {
+            if (currEntry.mTotalAllocations == 0)
+                continue;
+
+            MemoryCallSiteStats callSiteStats;
+            callSiteStats.mAddress = currEntry.mAddress;
+            callSiteStats.mLiveBytes = currEntry.mLiveBytes;
+            callSiteStats.mLiveAllocations = currEntry.mLiveAllocations;
+            callSiteStats.mTotalBytes = currEntry.mTotalBytes;
+            callSiteStats.mTotalAllocations = currEntry.mTotalAllocations;
+            outputSnapshot.mCallSites.push_back(callSiteStats);
+        }
+    }
+#endif
+
+    std::sort(outputSnapshot.mCallSites.begin(), outputSnapshot.mCallSites.end(), [](const MemoryCallSiteStats& lhs, const MemoryCallSiteStats& rhs)
+        {
+            return lhs.mAddress < rhs.mAddress;
+        });
+}
+
+void MemoryTracker::DumpSnapshot(const MemorySnapshot& snapshot) const
+{
+    long long totalLiveBytes = 0;
+    long long totalLiveAllocations = 0;
+    for (int itag = 0; itag < eMemoryTag_COUNT; ++itag)
+    {
+        const MemoryTagStats& tagStats = snapshot.mTags[itag];
+        totalLiveBytes += tagStats.mLiveBytes;
+        totalLiveAllocations += tagStats.mLiveAllocations;
+
+        gConsole.LogMessage(eLogMessage_Info, "  %-12s live %lld bytes in %lld allocations, total %lld allocations", MemoryTagNames[itag],
+            tagStats.mLiveBytes, tagStats.mLiveAllocations, tagStats.mTotalAllocations);
+    }
+    gConsole.LogMessage(eLogMessage_Info, "Live: %lld bytes in %lld allocations", totalLiveBytes, totalLiveAllocations);
+    gConsole.LogMessage(eLogMessage_Info, "Last frame: %lld bytes in %lld allocations", mFrameAllocatedBytes, mFrameAllocations);
+
+    std::vector<MemoryCallSiteStats> callSites = snapshot.mCallSites;
+    std::sort(callSites.begin(), callSites.end(), [](const MemoryCallSiteStats& lhs, const MemoryCallSiteStats& rhs)
+        {
+            return lhs.mLiveBytes > rhs.mLiveBytes;
+        });
+
+    gConsole.LogMessage(eLogMessage_Info, "Top call sites by live bytes:");
+
+    std::string callSiteName;
+    for (int icallsite = 0, Count = std::min((int) callSites.size(), MemoryTrackerTopCallSites); icallsite < Count; ++icallsite)
+    {
+        const MemoryCallSiteStats& currCallSite = callSites[icallsite];
+        GetCallSiteName(currCallSite.mAddress, callSiteName);
+        gConsole.LogMessage(eLogMessage_Info, "  %s: live %lld bytes in %lld allocations, total %lld allocations", callSiteName.c_str(),
+            currCallSite.mLiveBytes, currCallSite.mLiveAllocations, currCallSite.mTotalAllocations);
+    }
+}
+
+void MemoryTracker::GetCallSiteName(const void* address, std::string& outputName) const
+{
+    if (address == nullptr)
+    {
+        outputName = "<other>";
+        return;
+    }
+
+    char nameBuffer[512];
+    snprintf(nameBuffer, sizeof(nameBuffer), "%p", address);
+
+#if defined(ENABLE_MEMORY_TRACKER) && (OS_NAME == OS_LINUX)
+    // module offset can be resolved to source line with addr2line
+    Dl_info symbolInfo;
+    if (::dladdr(address, &symbolInfo) && symbolInfo.dli_fname)
+    {
+        if (symbolInfo.dli_sname)
+        {
+            snprintf(nameBuffer, sizeof(nameBuffer), "%s+0x%zx", symbolInfo.dli_sname,
+                (size_t) ((const char*) address - (const char*) symbolInfo.dli_saddr));
+        }
+        else
+        {
+            snprintf(nameBuffer, sizeof(nameBuffer), "%s+0x%zx", cxx::get_file_name(symbolInfo.dli_fname).c_str(),
+                (size_t) ((const char*) address - (const char*) symbolInfo.dli_fbase));
+        }
+    }
+#endif
+    outputName = nameBuffer;
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+// Allocations tracking is opt-in, enabled with ENABLE_MEMORY_TRACKER build option,
+// global new and delete operators are replaced to collect statistics
+
+// memory usage subsystems
+enum eMemoryTag
+{
+    eMemoryTag_Default,
+    eMemoryTag_Render,
+    eMemoryTag_Gui,
+    eMemoryTag_Audio,
+    eMemoryTag_Physics,
+    eMemoryTag_GameMap,
+    eMemoryTag_GameObjects,
+    eMemoryTag_Particles,
+    eMemoryTag_Traffic,
+    eMemoryTag_Ai,
+    eMemoryTag_COUNT
+};
+
+// subsystem memory statistics
+struct MemoryTagStats
+{
+public:
+    long long mLiveBytes = 0;
+    long long mLiveAllocations = 0;
+    long long mTotalBytes = 0; // allocated since start
+    long long mTotalAllocations = 0; // allocated since start
+};
+
+// call site memory statistics
+struct MemoryCallSiteStats
+{
+public:
+    const void* mAddress = nullptr; // return address of allocation function caller
+    long long mLiveBytes = 0;
+    long long mLiveAllocations = 0;
+    long long mTotalBytes = 0;
+    long long mTotalAllocations = 0;
+};
+
+// memory statistics at specific moment
+struct MemorySnapshot
+{
+public:
+    unsigned int mFrameIndex = 0;
+    MemoryTagStats mTags[eMemoryTag_COUNT];
+    std::vector<MemoryCallSiteStats> mCallSites; // sorted by address
+};
+
+// defines memory allocations tracker
+class MemoryTracker final: public cxx::noncopyable
+{
+public:
+    // readonly
+    long long mFrameAllocations = 0; // allocations made during last frame
+    long long mFrameAllocatedBytes = 0;
+    unsigned int mFrameIndex = 0;
+
+public:
+    // Test whether allocations tracking is compiled in
+    bool IsEnabled() const;
+
+    // Update per frame allocations rate
+    void UpdateFrame();
+
+    // Collect current memory statistics, store it under specified name and print to console
+    // @param snapshotName: Snapshot name, existing snapshot will be replaced
+    void TakeSnapshot(const std::string& snapshotName);
+
+    // Print difference between two previously taken snapshots to console
+    // @returns false if snapshot does not exist
+    bool DiffSnapshots(const std::string& snapshotNameA, const std::string& snapshotNameB) const;
+
+    // Get current statistics of subsystem
+    void GetTagStats(eMemoryTag memoryTag, MemoryTagStats& outputStats) const;
+
+    // Get subsystem display name
+    const char* GetTagName(eMemoryTag memoryTag) const;
+
+private:
+    void CollectSnapshot(MemorySnapshot& outputSnapshot) const;
+    void DumpSnapshot(const MemorySnapshot& snapshot) const;
+    void GetCallSiteName(const void* address, std::string& outputName) const;
+
+private:
+    std::map<std::string, MemorySnapshot> mSnapshots;
+    long long mPrevTotalAllocations = 0;
+    long long mPrevTotalBytes = 0;
+};
+
+extern MemoryTracker gMemoryTracker;
+
+//////////////////////////////////////////////////////////////////////////
+
+// Attributes allocations made by current thread within scope to specified subsystem
+class MemoryTagScope final: public cxx::noncopyable
+{
+public:
+#ifdef ENABLE_MEMORY_TRACKER
+    MemoryTagScope(eMemoryTag memoryTag);
+    ~MemoryTagScope();
+private:
+    eMemoryTag mPrevTag;
+#else
+    MemoryTagScope(eMemoryTag memoryTag)
+    {
+    }
+#endif
+};
+
+#define MEMORY_TAG_SCOPE(memoryTag) MemoryTagScope memoryTagScope (memoryTag)
+
+// Allocation functions used by tracked heap allocator, they are available when tracking is enabled
+#ifdef ENABLE_MEMORY_TRACKER
+    #if OS_NAME == OS_WINDOWS
+        #include <intrin.h>
+        #pragma intrinsic(_ReturnAddress)
+        #define MEMORY_TRACKER_CALL_SITE() _ReturnAddress()
+    #elif OS_NAME == OS_LINUX
+        // walks callstack and skips standard library and allocators frames
+        #define MEMORY_TRACKER_CALL_SITE() MemoryTrackerCaptureCallSite()
+const void* MemoryTrackerCaptureCallSite();
+    #else
+        #define MEMORY_TRACKER_CALL_SITE() nullptr
+    #endif
+
+void* MemoryTrackerAllocate(size_t dataLength, const void* callSite);
+void* MemoryTrackerReallocate(void* dataPointer, size_t dataLength, const void* callSite);
+void MemoryTrackerFree(void* dataPointer);
+#endif
\ No newline at end of file
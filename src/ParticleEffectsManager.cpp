@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "ParticleEffectsManager.h"
 #include "RenderingManager.h"
+#include "MemoryTracker.h"
 
 ParticleEffectsManager gParticleManager;
 
@@ -10,6 +11,8 @@ ParticleEffectsManager::ParticleEffectsManager()
 
 void ParticleEffectsManager::EnterWorld()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Particles);
+
     CreateSparksParticleEffect();
 }
 
@@ -20,6 +23,8 @@ void ParticleEffectsManager::ClearWorld()
 
 void ParticleEffectsManager::UpdateFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Particles);
+
     for (ParticleEffect* currEffect: mParticleEffects)
     {
         currEffect->UpdateFrame();
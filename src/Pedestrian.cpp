@@ -103,21 +103,34 @@ void Pedestrian::Spawn(const glm::vec3& position, cxx::angle_t heading)
 
 void Pedestrian::UpdateFrame()
 {
-    float deltaTime = gTimeManager.mGameFrameDelta;
-    mCurrentAnimState.UpdateFrame(deltaTime);
+    // pedestrians normally gets updated in batches by GameObjectsManager, see GameObjectsManager::UpdatePedestrians
+    UpdateFrameBegin(true);
+    UpdateDamageFromRailways();
+
+    // update current state logic
+    mStatesManager.ProcessFrame();
 
-    // update weapons state
-    for (Weapon& currWeapon: mWeapons)
+    UpdateBurnEffect();
+}
+
+void Pedestrian::UpdateFrameBegin(bool updateAnimation)
+{
+    float deltaTime = gTimeManager.mGameFrameDelta;
+    if (updateAnimation)
     {
-        currWeapon.UpdateFrame();
+        mCurrentAnimState.UpdateFrame(deltaTime);
     }
 
+    // update current weapon state, reloading of other weapons is time based so they will catch up once selected
+    GetWeapon().UpdateFrame();
+
     // change weapon
     if (mCurrentWeapon != mChangeWeapon)
     {
         if (GetWeapon().IsOutOfAmmunition() || GetWeapon().IsReadyToFire())
         {
             mCurrentWeapon = mChangeWeapon;
+            GetWeapon().UpdateFrame();
             // notify current state
             PedestrianStateEvent evData { ePedestrianStateEvent_WeaponChange };
             mStatesManager.ProcessEvent(evData);
@@ -125,13 +138,19 @@ void Pedestrian::UpdateFrame()
     }
 
     mCurrentStateTime += deltaTime;
+}
 
-    UpdateDamageFromRailways();
-
-    // update current state logic
-    mStatesManager.ProcessFrame();
+bool Pedestrian::CanSkipAnimation() const
+{
+    if (IsHumanPlayerCharacter())
+        return false;
 
-    UpdateBurnEffect();
+    // animation does not affect any logic in these states except visuals
+    ePedestrianState currState = GetCurrentStateID();
+    return (currState == ePedestrianState_StandingStill) || 
+        (currState == ePedestrianState_Walks) || 
+        (currState == ePedestrianState_Runs) ||
+        (currState == ePedestrianState_DrivingCar);
 }
 
 void Pedestrian::PreDrawFrame()
@@ -413,6 +432,7 @@ void Pedestrian::SetCarEntered(Vehicle* targetCar, eCarSeat targetSeat)
 
     mCurrentCar = targetCar;
     mCurrentSeat = targetSeat;
+    mStandingOnRailwaysTimer = 0.0f;
     mPhysicsBody->ClearForces();
     mCurrentCar->RegisterPassenger(this, mCurrentSeat);
 }
@@ -635,7 +655,7 @@ bool Pedestrian::OnAnimFrameAction(SpriteAnimation* animation, int frameIndex, e
         if ((stateID == ePedestrianState_Runs) || (stateID == ePedestrianState_Walks))
         {
             int footstepsSfx = (stateID == ePedestrianState_Runs) ? SfxLevel_FootStep2 : SfxLevel_FootStep1;
-            gAudioManager.PlaySfxLevel(footstepsSfx, GetPosition(), false);
+            gAudioManager.PlaySfxLevel(footstepsSfx, GetPosition(), false, eSfxPriority_Low);
         }
     }
 
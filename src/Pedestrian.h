@@ -152,6 +152,13 @@ private:
     void UpdateBurnEffect();
     void UpdateDamageFromRailways();
 
+    // update animation, weapons and state timer, state logic is processed separately
+    // @param updateAnimation: Animation could be skipped while pedestrian is not visible
+    void UpdateFrameBegin(bool updateAnimation);
+
+    // whether animation progress affects only visuals in current state
+    bool CanSkipAnimation() const;
+
     void SetDrawOrder(eSpriteDrawOrder drawOrder);
 
     // Detects identifier of current pedestrian state
@@ -11,7 +11,7 @@ void PedestrianInfo::RemoveFears(ePedestrianFearFlags fearFlags)
     mFearFlags = (mFearFlags & ~fearFlags);
 }
 
-bool PedestrianInfo::SetupFromConfg(cxx::json_document_node configNode)
+bool PedestrianInfo::SetupFromConfg(cxx::json_reader_node configNode)
 {
     Clear();
 
@@ -21,10 +21,9 @@ bool PedestrianInfo::SetupFromConfg(cxx::json_document_node configNode)
         return false;
     }
 
-    if (cxx::json_node_string remapTypeNode = configNode["remap_type"])
+    if (const char* remapTypeString = configNode["remap_type"].get_value_cstr())
     {
-        std::string remapTypeString = remapTypeNode.get_value();
-        if (remapTypeString == "random_civilian")
+        if (strcmp(remapTypeString, "random_civilian") == 0)
         {
             mRemapType = ePedestrianRemapType_RandomCivilian;
         }
@@ -32,45 +31,51 @@ bool PedestrianInfo::SetupFromConfg(cxx::json_document_node configNode)
     cxx::json_get_attribute(configNode, "remap_index", mRemapIndex);
 
     // read fears
-    if (cxx::json_node_array fearsNode = configNode["fears"])
+    cxx::json_reader_node fearsNode = configNode["fears"];
+    if (fearsNode.is_array())
     {
-        for (cxx::json_node_string currFear = fearsNode.first_child();
+        for (cxx::json_reader_node currFear = fearsNode.first_child();
             currFear; currFear = currFear.next_sibling())
         {
-            std::string fearName = currFear.get_value();
+            const char* fearName = currFear.get_value_cstr();
+            if (fearName == nullptr)
+            {
+                debug_assert(false);
+                continue;
+            }
 
-            if (fearName == "players")
+            if (strcmp(fearName, "players") == 0)
             {
                 AddFears(ePedestrianFearFlags_Players);
                 continue;
             }
 
-            if (fearName == "police")
+            if (strcmp(fearName, "police") == 0)
             {
                 AddFears(ePedestrianFearFlags_Police);
                 continue;
             }
 
-            if (fearName == "gunShots")
+            if (strcmp(fearName, "gunShots") == 0)
             {
                 AddFears(ePedestrianFearFlags_GunShots);
                 continue;
             }
 
-            if (fearName == "explosions")
+            if (strcmp(fearName, "explosions") == 0)
             {
                 AddFears(ePedestrianFearFlags_Explosions);
                 continue;
             }
 
-            if (fearName == "deadPeds")
+            if (strcmp(fearName, "deadPeds") == 0)
             {
                 AddFears(ePedestrianFearFlags_DeadPeds);
                 continue;
             }
 
             debug_assert(false);
-            gConsole.LogMessage(eLogMessage_Warning, "Unknown pedestrian fear flag '%s'", fearName.c_str());
+            gConsole.LogMessage(eLogMessage_Warning, "Unknown pedestrian fear flag '%s'", fearName);
         }
     }
 
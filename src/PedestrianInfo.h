@@ -42,7 +42,7 @@ public:
     PedestrianInfo() = default;
 
     // Load pedestrian info from json node
-    bool SetupFromConfg(cxx::json_document_node configNode);
+    bool SetupFromConfg(cxx::json_reader_node configNode);
 
     // Reset pedestrian info to default state
     void Clear();
@@ -9,11 +9,18 @@
 #include "BroadcastEventsManager.h"
 #include "AudioManager.h"
 
+// states table is shared between all pedestrians
+PedestrianStatesManager::StateFuncs PedestrianStatesManager::sFuncsTable[ePedestrianState_COUNT];
+bool PedestrianStatesManager::sFuncsTableInitialized = false;
+
 PedestrianStatesManager::PedestrianStatesManager(Pedestrian* pedestrian)
     : mPedestrian(pedestrian)
 {
     debug_assert(mPedestrian);
-    InitFuncsTable();
+    if (!sFuncsTableInitialized)
+    {
+        InitFuncsTable();
+    }
 }
 
 void PedestrianStatesManager::ChangeState(ePedestrianState nextState, const PedestrianStateEvent& evData)
@@ -24,88 +31,96 @@ void PedestrianStatesManager::ChangeState(ePedestrianState nextState, const Pede
     mPedestrian->mCurrentStateTime = 0;
     debug_assert(nextState > ePedestrianState_Unspecified && nextState < ePedestrianState_COUNT);
     // process exit current state
-    (this->*mFuncsTable[mCurrentStateID].pfStateExit)();
+    (this->*sFuncsTable[mCurrentStateID].pfStateExit)();
     mCurrentStateID = nextState;
     // process enter next state
-    (this->*mFuncsTable[mCurrentStateID].pfStateEnter)(evData);
+    (this->*sFuncsTable[mCurrentStateID].pfStateEnter)(evData);
 }
 
 bool PedestrianStatesManager::ProcessEvent(const PedestrianStateEvent& evData)
 {
-    return (this->*mFuncsTable[mCurrentStateID].pfStateEvent)(evData);
+    return (this->*sFuncsTable[mCurrentStateID].pfStateEvent)(evData);
 }
 
 void PedestrianStatesManager::ProcessFrame()
 {
-    (this->*mFuncsTable[mCurrentStateID].pfStateFrame)();
+    (this->*sFuncsTable[mCurrentStateID].pfStateFrame)();
 }
 
 void PedestrianStatesManager::InitFuncsTable()
 {
-    mFuncsTable[ePedestrianState_Unspecified] = {&PedestrianStatesManager::StateDummy_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Unspecified] = {&PedestrianStatesManager::StateDummy_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateDummy_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_StandingStill] = {&PedestrianStatesManager::StateIdle_ProcessEnter, 
+    sFuncsTable[ePedestrianState_StandingStill] = {&PedestrianStatesManager::StateIdle_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateIdle_ProcessFrame, 
         &PedestrianStatesManager::StateIdle_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Walks] = {&PedestrianStatesManager::StateIdle_ProcessEnter,
+    sFuncsTable[ePedestrianState_Walks] = {&PedestrianStatesManager::StateIdle_ProcessEnter,
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateIdle_ProcessFrame, 
         &PedestrianStatesManager::StateIdle_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Runs] = {&PedestrianStatesManager::StateIdle_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Runs] = {&PedestrianStatesManager::StateIdle_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit,
         &PedestrianStatesManager::StateIdle_ProcessFrame, 
         &PedestrianStatesManager::StateIdle_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Falling] = {&PedestrianStatesManager::StateFalling_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Falling] = {&PedestrianStatesManager::StateFalling_ProcessEnter, 
         &PedestrianStatesManager::StateFalling_ProcessExit, 
         &PedestrianStatesManager::StateDummy_ProcessFrame, 
         &PedestrianStatesManager::StateFalling_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_EnteringCar] = {&PedestrianStatesManager::StateEnterCar_ProcessEnter, 
+    sFuncsTable[ePedestrianState_EnteringCar] = {&PedestrianStatesManager::StateEnterCar_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateEnterCar_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_ExitingCar] =  {&PedestrianStatesManager::StateExitCar_ProcessEnter, 
+    sFuncsTable[ePedestrianState_ExitingCar] =  {&PedestrianStatesManager::StateExitCar_ProcessEnter, 
         &PedestrianStatesManager::StateExitCar_ProcessExit, 
         &PedestrianStatesManager::StateExitCar_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_DrivingCar] = {&PedestrianStatesManager::StateDriveCar_ProcessEnter, 
+    sFuncsTable[ePedestrianState_DrivingCar] = {&PedestrianStatesManager::StateDriveCar_ProcessEnter, 
         &PedestrianStatesManager::StateDriveCar_ProcessExit, 
         &PedestrianStatesManager::StateDummy_ProcessFrame, 
         &PedestrianStatesManager::StateDriveCar_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_SlideOnCar] = {&PedestrianStatesManager::StateSlideCar_ProcessEnter, 
+    sFuncsTable[ePedestrianState_SlideOnCar] = {&PedestrianStatesManager::StateSlideCar_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateSlideCar_ProcessFrame, 
         &PedestrianStatesManager::StateSlideCar_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Dead] = {&PedestrianStatesManager::StateDead_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Dead] = {&PedestrianStatesManager::StateDead_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateDummy_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Stunned] = {&PedestrianStatesManager::StateStunned_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Stunned] = {&PedestrianStatesManager::StateStunned_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateStunned_ProcessFrame, 
         &PedestrianStatesManager::StateStunned_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Drowning] = {&PedestrianStatesManager::StateDrowning_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Drowning] = {&PedestrianStatesManager::StateDrowning_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateDrowning_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
 
-    mFuncsTable[ePedestrianState_Electrocuted] = {&PedestrianStatesManager::StateElectrocuted_ProcessEnter, 
+    sFuncsTable[ePedestrianState_Electrocuted] = {&PedestrianStatesManager::StateElectrocuted_ProcessEnter, 
         &PedestrianStatesManager::StateDummy_ProcessExit, 
         &PedestrianStatesManager::StateElectrocuted_ProcessFrame, 
         &PedestrianStatesManager::StateDummy_ProcessEvent};
+
+    sFuncsTableInitialized = true;
+}
+
+bool PedestrianStatesManager::HasFrameHandler(ePedestrianState stateID)
+{
+    debug_assert(sFuncsTableInitialized);
+    return sFuncsTable[stateID].pfStateFrame != &PedestrianStatesManager::StateDummy_ProcessFrame;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -60,8 +60,11 @@ public:
 
     bool CanStartSlideOnCarState() const;
 
+    // test whether state has per frame logic, pedestrians in other states can be skipped on update
+    static bool HasFrameHandler(ePedestrianState stateID);
+
 private:
-    void InitFuncsTable();
+    static void InitFuncsTable();
     
     // state helpers
     void ProcessRotateActions();
@@ -140,6 +143,6 @@ private:
 
     Pedestrian* mPedestrian;
     ePedestrianState mCurrentStateID = ePedestrianState_Unspecified;
-    StateFuncs mFuncsTable[ePedestrianState_COUNT];
+    static StateFuncs sFuncsTable[ePedestrianState_COUNT];
+    static bool sFuncsTableInitialized;
 };
-
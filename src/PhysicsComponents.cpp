@@ -724,63 +724,58 @@ b2Vec2 CarPhysicsBody::b2GetTireLocalLateral(eCarTire tireID) const
 
 //////////////////////////////////////////////////////////////////////////
 
-ProjectilePhysicsBody::ProjectilePhysicsBody(b2World* physicsWorld, Projectile* object)
-    : PhysicsBody(physicsWorld)
-    , mReferenceProjectile(object)
+ProjectilePhysicsBody::ProjectilePhysicsBody(Projectile* object)
+    : mReferenceProjectile(object)
+    , mPreviousPosition()
+    , mSmoothPosition()
+    , mPreviousRotation()
+    , mSmoothRotation()
+    , mPosition()
+    , mSignVector(1.0f, 0.0f)
+    , mRotationAngle()
 {
     debug_assert(object);
-
-    // create body
-    b2BodyDef bodyDef;
-    bodyDef.type = b2_dynamicBody;
-    bodyDef.fixedRotation = true;
-    bodyDef.bullet = true;
-    bodyDef.userData = this;
-
-    mPhysicsBody = mPhysicsWorld->CreateBody(&bodyDef);
-    debug_assert(mPhysicsBody);
-    
     debug_assert(object->mWeaponInfo);
+}
 
-    b2CircleShape shapeDef;
-    if (object->mWeaponInfo)
-    {
-        shapeDef.m_radius = object->mWeaponInfo->mProjectileSize;
-    }
-    else
-    {
-        debug_assert(false);
-        shapeDef.m_radius = 0.1f;
-    }
+void ProjectilePhysicsBody::SetPosition(const glm::vec3& position, cxx::angle_t rotationAngle)
+{
+    mHeight = position.y;
+    mPreviousPosition = position;
+    mSmoothPosition = position;
+    mPreviousRotation = rotationAngle;
+    mSmoothRotation = rotationAngle;
 
-    b2FixtureDef fixtureDef;
-    fixtureDef.shape = &shapeDef;
-    fixtureDef.filter.categoryBits = PHYSICS_OBJCAT_PROJECTILE;
-    fixtureDef.filter.maskBits = PHYSICS_OBJCAT_PED | PHYSICS_OBJCAT_CAR | PHYSICS_OBJCAT_OBSTACLE | PHYSICS_OBJCAT_MAP_SOLID_BLOCK;
+    mPosition.x = position.x;
+    mPosition.y = position.z;
+    mRotationAngle = rotationAngle;
 
-    b2Fixture* b2fixture = mPhysicsBody->CreateFixture(&fixtureDef);
-    debug_assert(b2fixture);
+    float angleRadians = rotationAngle.to_radians();
+    mSignVector.x = cos(angleRadians);
+    mSignVector.y = sin(angleRadians);
+
+    mTraveledDistance = 0.0f;
+    mPassThroughObject.reset();
 }
 
-void ProjectilePhysicsBody::SimulationStep()
+glm::vec3 ProjectilePhysicsBody::GetPosition() const
 {
-    if (mReferenceProjectile->mWeaponInfo == nullptr)
-    {
-        debug_assert(false);
-        return;
-    }
+    return { mPosition.x, mHeight, mPosition.y };
+}
 
-    // setup physics
-    glm::vec2 velocity = GetSignVector();
-    SetLinearVelocity(velocity * mReferenceProjectile->mWeaponInfo->mProjectileSpeed);
+glm::vec2 ProjectilePhysicsBody::GetPosition2() const
+{
+    return mPosition;
+}
 
-    glm::vec2 currPosition = GetPosition2();
-    glm::vec2 startPosition(mReferenceProjectile->mSpawnPosition.x, mReferenceProjectile->mSpawnPosition.z);
+cxx::angle_t ProjectilePhysicsBody::GetRotationAngle() const
+{
+    return mRotationAngle;
+}
 
-    if (glm::distance(startPosition, currPosition) >= mReferenceProjectile->mWeaponInfo->mBaseHitRange)
-    {
-        mReferenceProjectile->MarkForDeletion();
-    }
+glm::vec2 ProjectilePhysicsBody::GetSignVector() const
+{
+    return mSignVector;
 }
 
 bool ProjectilePhysicsBody::ShouldContactWith(unsigned int objCatBits) const
@@ -818,5 +813,6 @@ bool ProjectilePhysicsBody::ProcessContactWithMap(const glm::vec3& contactPoint)
 void ProjectilePhysicsBody::ClearCurrentContact()
 {
     mContactDetected = false;
+    mPassThroughObject = mContactObject;
     mContactObject.reset();
 }
@@ -9,7 +9,6 @@ class PhysicsBody: public cxx::noncopyable
 
     friend class PedPhysicsBody;
     friend class CarPhysicsBody;
-    friend class ProjectilePhysicsBody;
 
 public:    
     // readonly
@@ -211,27 +210,55 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 
-class ProjectilePhysicsBody: public PhysicsBody
+// projectile physics component
+// note that projectile is not a box2d body, instead it sweeps its path against map blocks and
+// physics objects on each simulation step, so fast moving projectiles are never tunneling
+class ProjectilePhysicsBody: public cxx::noncopyable
 {
     friend class PhysicsManager;
 
 public:
     // readonly
     Projectile* mReferenceProjectile = nullptr;
+
+    float mHeight = 0.0f; // world y coord
+
+    // for rendering
+    glm::vec3 mPreviousPosition;
+    glm::vec3 mSmoothPosition; 
+    cxx::angle_t mPreviousRotation;
+    cxx::angle_t mSmoothRotation;
     
     // collision contact info
     glm::vec3 mContactPoint;
     GameObjectHandle mContactObject;
+    GameObjectHandle mPassThroughObject; // last ignored contact object
     bool mContactDetected = false;
 
 public:
-    ProjectilePhysicsBody(b2World* physicsWorld, Projectile* object);
-    // override PhysicsComponent
-    void SimulationStep() override;
-    bool ShouldContactWith(unsigned int objCatBits) const override;
+    ProjectilePhysicsBody(Projectile* object);
+
+    // test whether object should contact with other objects depending on its current state
+    // @param objCatBits: object categories bits see PHYSICS_OBJCAT_* bits
+    bool ShouldContactWith(unsigned int objCatBits) const;
+
+    // Set or get object's world position and rotation angle
+    // @param position: Coordinate, meters
+    // @param rotationAngle: Angle
+    void SetPosition(const glm::vec3& position, cxx::angle_t rotationAngle);
+    glm::vec3 GetPosition() const;
+    glm::vec2 GetPosition2() const;
+    cxx::angle_t GetRotationAngle() const;
+    glm::vec2 GetSignVector() const;
 
     bool ProcessContactWithObject(const glm::vec3& contactPoint, GameObject* gameObject);
     bool ProcessContactWithMap(const glm::vec3& contactPoint);
 
     void ClearCurrentContact();
+
+private:
+    glm::vec2 mPosition;
+    glm::vec2 mSignVector;
+    cxx::angle_t mRotationAngle;
+    float mTraveledDistance = 0.0f;
 };
@@ -68,14 +68,24 @@ public:
 };
 
 // physical components query result
-struct PhysicsQueryResult
+// elements storage is allocated on frame heap and grows on demand, so result should not outlive current frame
+struct PhysicsQueryResult final: public cxx::noncopyable
 {
 public:
     PhysicsQueryResult() = default;
+    ~PhysicsQueryResult();
     inline void Clear() { mElementsCount = 0; }
     inline bool IsNull() const { return mElementsCount == 0; }
-    inline bool IsFull() const { return mElementsCount == MaxPhysicsQueryElements; }
+
+    // append new cleared element
+    // @returns nullptr on out of memory
+    PhysicsQueryElement* AddElement();
+
 public:
     int mElementsCount = 0;
-    PhysicsQueryElement mElements[MaxPhysicsQueryElements];
+    PhysicsQueryElement* mElements = nullptr;
+
+private:
+    cxx::memory_allocator* mAllocator = nullptr;
+    int mElementsCapacity = 0;
 };
\ No newline at end of file
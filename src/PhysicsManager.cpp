@@ -4,10 +4,63 @@
 #include "GameCheatsWindow.h"
 #include "CarnageGame.h"
 #include "Pedestrian.h"
+#include "Projectile.h"
 #include "TimeManager.h"
 #include "Box2D_Helpers.h"
 #include "cvars.h"
 #include "ParticleEffectsManager.h"
+#include "MemoryTracker.h"
+#include "MemoryManager.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+PhysicsQueryResult::~PhysicsQueryResult()
+{
+    if (mElements)
+    {
+        mAllocator->deallocate(mElements);
+    }
+}
+
+PhysicsQueryElement* PhysicsQueryResult::AddElement()
+{
+    if (mElementsCount == mElementsCapacity)
+    {
+        if (mAllocator == nullptr)
+        {
+            mAllocator = gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_PhysicsQueries);
+            if (mAllocator == nullptr)
+            {
+                mAllocator = gMemoryManager.mHeapAllocator;
+            }
+        }
+
+        int newCapacity = (mElementsCapacity > 0) ? (mElementsCapacity * 2) : MaxPhysicsQueryElements;
+        unsigned int newLength = newCapacity * sizeof(PhysicsQueryElement);
+
+        void* newElements = mAllocator->reallocate(mElements, newLength);
+        if (newElements == nullptr && mAllocator != gMemoryManager.mHeapAllocator)
+        {
+            // frame heap is exhausted, move to standard heap, old block gets released with frame
+            mAllocator = gMemoryManager.mHeapAllocator;
+            newElements = mAllocator->allocate(newLength);
+            if (newElements && mElements)
+            {
+                memcpy(newElements, mElements, mElementsCount * sizeof(PhysicsQueryElement));
+            }
+        }
+
+        if (newElements == nullptr)
+            return nullptr;
+
+        mElements = (PhysicsQueryElement*) newElements;
+        mElementsCapacity = newCapacity;
+    }
+
+    PhysicsQueryElement* element = &mElements[mElementsCount++];
+    element->Clear();
+    return element;
+}
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -55,22 +108,46 @@ inline TUserDataClass* CastFixtureBody(b2Fixture* fixture)
 
 //////////////////////////////////////////////////////////////////////////
 
+void PhysicsStepStats::FrameBegin()
+{
+    mStepsCount = 0;
+}
+
+void PhysicsStepStats::FrameEnd()
+{
+    mStepsCountPeak = std::max(mStepsCountPeak, mStepsCount);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 PhysicsManager gPhysics;
 
 PhysicsManager::PhysicsManager()
     : mMapCollisionShape()
     , mPhysicsWorld()
+    , mSimulationTimeAccumulator()
+    , mSimulationStepTime()
+    , mNominalStepTime()
     , mGravity()
 {
 }
 
 void PhysicsManager::EnterWorld()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Physics);
+
     b2Vec2 gravity {0.0f, 0.0f}; // default gravity shoild be disabled
     mPhysicsWorld = new b2World(gravity);
     mPhysicsWorld->SetContactListener(this);
 
-    mSimulationStepTime = 1.0f / std::max(gCvarPhysicsFramerate.mValue, 1.0f);
+    mSimulationTimeAccumulator = 0.0f;
+    mNominalStepTime = 1.0f / std::max(gCvarPhysicsFramerate.mValue, 1.0f);
+    mSimulationStepTime = mNominalStepTime;
+    gCvarPhysicsFramerate.ClearModified();
+
+    mStepStats = PhysicsStepStats();
+    mStepStats.mStepTime = mSimulationStepTime;
+
     mGravity = Convert::MapUnitsToMeters(0.5f);
 
     CreateMapCollisionShape();
@@ -88,14 +165,61 @@ void PhysicsManager::ClearWorld()
 
 void PhysicsManager::UpdateFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Physics);
+
+    mStepStats.FrameBegin();
+
+    if (gCvarPhysicsFramerate.IsModified())
+    {
+        mNominalStepTime = 1.0f / std::max(gCvarPhysicsFramerate.mValue, 1.0f);
+        gCvarPhysicsFramerate.ClearModified();
+    }
+
     mSimulationTimeAccumulator += gTimeManager.mGameFrameDelta;
+    UpdateSimulationStepTime();
 
+    const int maxSteps = std::max(gCvarPhysicsMaxSteps.mValue, 1);
     while (mSimulationTimeAccumulator >= mSimulationStepTime)
     {
+        // drop time debt, otherwise slow frame causes even more steps on next frame
+        if (mStepStats.mStepsCount == maxSteps)
+        {
+            int droppedSteps = (int) (mSimulationTimeAccumulator / mSimulationStepTime);
+            float droppedTime = droppedSteps * mSimulationStepTime;
+
+            mStepStats.mDroppedStepsCount += droppedSteps;
+            mStepStats.mDroppedTime += droppedTime;
+            mSimulationTimeAccumulator -= droppedTime;
+            break;
+        }
         ProcessSimulationStep();
         mSimulationTimeAccumulator -= mSimulationStepTime;
+
+        ++mStepStats.mStepsCount;
+        if (mSimulationStepTime > mNominalStepTime)
+        {
+            ++mStepStats.mStretchedStepsCount;
+        }
     }
     ProcessInterpolation();
+
+    mStepStats.mStepTime = mSimulationStepTime;
+    mStepStats.FrameEnd();
+}
+
+void PhysicsManager::UpdateSimulationStepTime()
+{
+    mSimulationStepTime = mNominalStepTime;
+
+    if (!gCvarPhysicsAdaptiveStep.mValue)
+        return;
+
+    // stretch step so accumulated time fits within max steps per frame,
+    // this trades simulation accuracy for bounded frame time
+    const int maxSteps = std::max(gCvarPhysicsMaxSteps.mValue, 1);
+    const float maxStepTime = std::max(1.0f / std::max(gCvarPhysicsMinFramerate.mValue, 1.0f), mNominalStepTime);
+
+    mSimulationStepTime = glm::clamp(mSimulationTimeAccumulator / maxSteps, mNominalStepTime, maxStepTime);
 }
 
 void PhysicsManager::ProcessSimulationStep()
@@ -114,7 +238,7 @@ void PhysicsManager::ProcessSimulationStep()
         currComponent->mPreviousPosition = currComponent->mSmoothPosition = currComponent->GetPosition();
         currComponent->mPreviousRotation = currComponent->mSmoothRotation = currComponent->GetRotationAngle();
     }
-    for (PhysicsBody* currComponent: mProjectileBodiesList)
+    for (ProjectilePhysicsBody* currComponent: mProjectileBodiesList)
     {
         currComponent->mPreviousPosition = currComponent->mSmoothPosition = currComponent->GetPosition();
         currComponent->mPreviousRotation = currComponent->mSmoothRotation = currComponent->GetRotationAngle();
@@ -131,9 +255,10 @@ void PhysicsManager::ProcessSimulationStep()
     {
         mPedsBodiesList[i]->SimulationStep();
     }
+    // projectiles are traced against new objects positions
     for (size_t i = 0, NumElements = mProjectileBodiesList.size(); i < NumElements; ++i)
     {
-        mProjectileBodiesList[i]->SimulationStep();
+        ProcessProjectileStep(mProjectileBodiesList[i]);
     }
 
     ProcessGravityStep();
@@ -155,7 +280,7 @@ void PhysicsManager::ProcessInterpolation()
         currComponent->mSmoothRotation = cxx::lerp_angles(currComponent->mPreviousRotation, currComponent->GetRotationAngle(), mixFactor);
     }
 
-    for (PhysicsBody* currComponent: mProjectileBodiesList)
+    for (ProjectilePhysicsBody* currComponent: mProjectileBodiesList)
     {
         currComponent->mSmoothPosition = glm::lerp(currComponent->mPreviousPosition, currComponent->GetPosition(), mixFactor);
         currComponent->mSmoothRotation = cxx::lerp_angles(currComponent->mPreviousRotation, currComponent->GetRotationAngle(), mixFactor);
@@ -189,7 +314,7 @@ ProjectilePhysicsBody* PhysicsManager::CreatePhysicsObject(Projectile* object, c
 {
     debug_assert(object);
 
-    ProjectilePhysicsBody* physicsObject = mProjectileBodiesPool.create(mPhysicsWorld, object);
+    ProjectilePhysicsBody* physicsObject = mProjectileBodiesPool.create(object);
     physicsObject->SetPosition(position, rotationAngle);
 
     mProjectileBodiesList.push_back(physicsObject);
@@ -327,43 +452,8 @@ void PhysicsManager::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
         b2Fixture* fixtureMapSolidBlock = FilterFixture(fixtureA, fixtureB, PHYSICS_OBJCAT_MAP_SOLID_BLOCK);
         b2Fixture* fixturePed = FilterFixture(fixtureA, fixtureB, PHYSICS_OBJCAT_PED);
         b2Fixture* fixtureCar = FilterFixture(fixtureA, fixtureB, PHYSICS_OBJCAT_CAR);
-        b2Fixture* fixtureProjectile = FilterFixture(fixtureA, fixtureB, PHYSICS_OBJCAT_PROJECTILE);
 
-        if (fixtureProjectile)
-        {
-            hasCollision = false; // projectiles doesnt collide
-
-            ProjectilePhysicsBody* projectile = CastFixtureBody<ProjectilePhysicsBody>(fixtureProjectile);
-
-            // projectile vs map solid block
-            if (fixtureMapSolidBlock)
-            {
-                b2FixtureData_map fxdata = fixtureMapSolidBlock->GetUserData();
-                if (projectile->ShouldContactWith(PHYSICS_OBJCAT_MAP_SOLID_BLOCK))
-                {
-                    ProcessProjectileVsMap(contact, projectile, fxdata.mX, fxdata.mZ);
-                }
-            }
-            // projectile vs car
-            else if (fixtureCar)
-            {
-                CarPhysicsBody* car = CastFixtureBody<CarPhysicsBody>(fixtureCar);
-                if (projectile->ShouldContactWith(PHYSICS_OBJCAT_CAR))
-                {
-                    ProcessProjectileVsCar(contact, projectile, car);
-                }
-            }
-            // projectile vs ped
-            else if (fixturePed)
-            {
-                PedPhysicsBody* ped = CastFixtureBody<PedPhysicsBody>(fixturePed);
-                if (projectile->ShouldContactWith(PHYSICS_OBJCAT_PED))
-                {
-                    ProcessProjectileVsPed(contact, projectile, ped);
-                }
-            }
-        }
-        else if (fixturePed)
+        if (fixturePed)
         {
             PedPhysicsBody* ped = CastFixtureBody<PedPhysicsBody>(fixturePed);
 
@@ -686,20 +776,23 @@ void PhysicsManager::QueryObjectsWithinBox(const glm::vec2& aaboxCenter, const g
         }
         bool ReportFixture(b2Fixture* fixture) override
         {
-            if (mOutput.IsFull())
-                return false;
-
             const b2Filter& filterData = fixture->GetFilterData();
             if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
             {
-                PhysicsQueryElement& currElement = mOutput.mElements[mOutput.mElementsCount++];
-                currElement.mCarComponent = CastFixtureBody<CarPhysicsBody>(fixture);
+                PhysicsQueryElement* currElement = mOutput.AddElement();
+                if (currElement == nullptr)
+                    return false;
+
+                currElement->mCarComponent = CastFixtureBody<CarPhysicsBody>(fixture);
             }
 
             if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
             {
-                PhysicsQueryElement& currElement = mOutput.mElements[mOutput.mElementsCount++];
-                currElement.mPedComponent = CastFixtureBody<PedPhysicsBody>(fixture);
+                PhysicsQueryElement* currElement = mOutput.AddElement();
+                if (currElement == nullptr)
+                    return false;
+
+                currElement->mPedComponent = CastFixtureBody<PedPhysicsBody>(fixture);
             }
             return true;
         }
@@ -807,79 +900,211 @@ void PhysicsManager::HandleCollisionWithMap(b2Contact* contact, CarPhysicsBody*
     // todo: make damage
 }
 
-bool PhysicsManager::ProcessProjectileVsMap(b2Contact* contact, ProjectilePhysicsBody* projectile, int mapx, int mapy) const
+void PhysicsManager::ProcessProjectileStep(ProjectilePhysicsBody* projectile)
 {
-    // check same height
-    int layer = (int) (Convert::MetersToMapUnits(projectile->mHeight) + 0.5f);
+    Projectile* referenceProjectile = projectile->mReferenceProjectile;
 
-    const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(mapx, mapy, layer);
-    if (mapBlock->mGroundType != eGroundType_Building)
-        return false;
+    WeaponInfo* weaponInfo = referenceProjectile->mWeaponInfo;
+    if (weaponInfo == nullptr)
+    {
+        debug_assert(false);
+        return;
+    }
 
-    // get collision point
-    b2WorldManifold wmanifold;
-    contact->GetWorldManifold(&wmanifold);
+    // stay at contact point until contact gets processed
+    if (!projectile->ShouldContactWith(PHYSICS_OBJCAT_MAP_SOLID_BLOCK | PHYSICS_OBJCAT_CAR | PHYSICS_OBJCAT_PED))
+        return;
+
+    float castDistance = std::min(weaponInfo->mProjectileSpeed * mSimulationStepTime, 
+        weaponInfo->mBaseHitRange - projectile->mTraveledDistance);
+
+    glm::vec2 castStart = projectile->mPosition;
+    glm::vec2 castEnd = castStart + projectile->mSignVector * std::max(castDistance, 0.0f);
 
-    int pointsCount = contact->GetManifold()->pointCount;
-    if (pointsCount > 0)
+    // trace map blocks on same height
+    int mapLayer = (int) (Convert::MetersToMapUnits(projectile->mHeight) + 0.5f);
+
+    glm::vec2 mapHitPoint;
+    bool hasMapContact = gGameMap.TraceSegment2D(Convert::MetersToMapUnits(castStart), Convert::MetersToMapUnits(castEnd), 
+        (float) mapLayer, mapHitPoint);
+    if (hasMapContact)
     {
-        glm::vec3 contactPoint( 
-            wmanifold.points[0].x, projectile->mHeight, 
-            wmanifold.points[0].y );
+        castEnd = Convert::MapUnitsToMeters(mapHitPoint);
+    }
 
-        return projectile->ProcessContactWithMap(contactPoint);
+    // trace objects up to map contact point
+    glm::vec2 objectHitPoint;
+    GameObject* hitObject = nullptr;
+    if (castEnd != castStart)
+    {
+        hitObject = TraceProjectileVsObjects(projectile, castStart, castEnd, objectHitPoint);
     }
-    return false;
-}
 
-bool PhysicsManager::ProcessProjectileVsCar(b2Contact* contact, ProjectilePhysicsBody* projectile, CarPhysicsBody* car) const
-{
-    // check car bounds height
-    // todo: get car height!
-    bool hasContact = ((projectile->mHeight >= car->mHeight) && 
-        (projectile->mHeight <= (car->mHeight + 2.0f)));
+    bool hasObjectContact = false;
+    if (hitObject)
+    {
+        glm::vec3 contactPoint (objectHitPoint.x, projectile->mHeight, objectHitPoint.y);
+        if (projectile->ProcessContactWithObject(contactPoint, hitObject))
+        {
+            castEnd = objectHitPoint;
+            hasObjectContact = true;
+        }
+    }
 
-    if (!hasContact)
-        return false;
+    // projectile passed through object or didn't hit any, but still must stop at wall
+    if (hasMapContact && !hasObjectContact)
+    {
+        glm::vec3 contactPoint (castEnd.x, projectile->mHeight, castEnd.y);
+        projectile->ProcessContactWithMap(contactPoint);
+    }
 
-    // get collision point
-    b2WorldManifold wmanifold;
-    contact->GetWorldManifold(&wmanifold);
+    projectile->mTraveledDistance += glm::distance(castStart, castEnd);
+    projectile->mPosition = castEnd;
 
-    int pointsCount = contact->GetManifold()->pointCount;
-    if (pointsCount > 0)
+    if (!projectile->mContactDetected && (projectile->mTraveledDistance >= weaponInfo->mBaseHitRange))
     {
-        glm::vec3 contactPoint( 
-            wmanifold.points[0].x, projectile->mHeight, 
-            wmanifold.points[0].y );
-
-        return projectile->ProcessContactWithObject(contactPoint, car->mReferenceCar);
+        referenceProjectile->MarkForDeletion();
     }
-    return false;
 }
 
-bool PhysicsManager::ProcessProjectileVsPed(b2Contact* contact, ProjectilePhysicsBody* projectile, PedPhysicsBody* ped) const
+GameObject* PhysicsManager::TraceProjectileVsObjects(ProjectilePhysicsBody* projectile, const glm::vec2& pointA, const glm::vec2& pointB, glm::vec2& outHitPoint) const
 {
-    // check ped bounds height
-    // todo: get car height!
-    bool hasContact = ((projectile->mHeight >= ped->mHeight) && 
-        (projectile->mHeight <= (ped->mHeight + 2.0f)));
+    // projectile is swept as circle, zero width ray would miss objects passing close to its path
+    // and also objects which contain path start point
+    struct _query_callback: public b2QueryCallback
+    {
+    public:
+        _query_callback(ProjectilePhysicsBody* projectile, const glm::vec2& pointA, const glm::vec2& pointB, float radius)
+            : mProjectile(projectile)
+        {
+            mProjectileShape.m_radius = radius;
+            mProjectileProxy.Set(&mProjectileShape, 0);
+
+            mProjectileSweep.localCenter.SetZero();
+            mProjectileSweep.c0 = box2d::vec2(pointA);
+            mProjectileSweep.c = box2d::vec2(pointB);
+            mProjectileSweep.a0 = 0.0f;
+            mProjectileSweep.a = 0.0f;
+            mProjectileSweep.alpha0 = 0.0f;
+        }
+        bool ReportFixture(b2Fixture* fixture) override
+        {
+            GameObject* gameObject = nullptr;
+            float objectHeight = 0.0f;
 
-    if (!hasContact)
-        return false;
+            const b2Filter& filterData = fixture->GetFilterData();
+            if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
+            {
+                CarPhysicsBody* car = CastFixtureBody<CarPhysicsBody>(fixture);
+                gameObject = car->mReferenceCar;
+                objectHeight = car->mHeight;
+            }
+            else if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
+            {
+                PedPhysicsBody* ped = CastFixtureBody<PedPhysicsBody>(fixture);
+                gameObject = ped->mReferencePed;
+                objectHeight = ped->mHeight;
+            }
 
-    // get collision point
-    b2WorldManifold wmanifold;
-    contact->GetWorldManifold(&wmanifold);
+            if (gameObject == nullptr)
+                return true; // filter out
 
-    int pointsCount = contact->GetManifold()->pointCount;
-    if (pointsCount > 0)
-    {
-        glm::vec3 contactPoint( 
-            wmanifold.points[0].x, projectile->mHeight, 
-            wmanifold.points[0].y );
+            // check object bounds height
+            // todo: get object height!
+            if ((mProjectile->mHeight < objectHeight) || (mProjectile->mHeight > (objectHeight + 2.0f)))
+                return true;
+
+            // ignore shooter ped and objects which projectile passes through
+            if ((mProjectile->mReferenceProjectile->mShooter == gameObject) || (mProjectile->mPassThroughObject == gameObject))
+                return true;
+
+            b2Body* body = fixture->GetBody();
+            const b2Transform& bodyTransform = body->GetTransform();
+            const b2Shape* shape = fixture->GetShape();
+
+            b2Transform startTransform;
+            startTransform.Set(mProjectileSweep.c0, 0.0f);
 
-        return projectile->ProcessContactWithObject(contactPoint, ped->mReferencePed);
+            for (int ichild = 0, childCount = shape->GetChildCount(); ichild < childCount; ++ichild)
+            {
+                // projectile already overlaps object at path start
+                if (b2TestOverlap(shape, ichild, &mProjectileShape, 0, bodyTransform, startTransform))
+                {
+                    SetHit(gameObject, 0.0f, mProjectileSweep.c0);
+                    continue;
+                }
+
+                // object is static during simulation step
+                b2TOIInput toiInput;
+                toiInput.proxyA.Set(shape, ichild);
+                toiInput.proxyB = mProjectileProxy;
+                toiInput.sweepA.localCenter.SetZero();
+                toiInput.sweepA.c0 = bodyTransform.p;
+                toiInput.sweepA.c = bodyTransform.p;
+                toiInput.sweepA.a0 = body->GetAngle();
+                toiInput.sweepA.a = toiInput.sweepA.a0;
+                toiInput.sweepA.alpha0 = 0.0f;
+                toiInput.sweepB = mProjectileSweep;
+                toiInput.tMax = 1.0f;
+
+                b2TOIOutput toiOutput;
+                b2TimeOfImpact(&toiOutput, &toiInput);
+                if (toiOutput.state != b2TOIOutput::e_touching || toiOutput.t >= mHitFraction)
+                    continue;
+
+                // find contact point on object surface
+                b2DistanceInput distanceInput;
+                distanceInput.proxyA = toiInput.proxyA;
+                distanceInput.proxyB = mProjectileProxy;
+                distanceInput.transformA = bodyTransform;
+                distanceInput.transformB.Set(mProjectileSweep.c0 + toiOutput.t * (mProjectileSweep.c - mProjectileSweep.c0), 0.0f);
+                distanceInput.useRadii = true;
+
+                b2SimplexCache simplexCache;
+                simplexCache.count = 0;
+                b2DistanceOutput distanceOutput;
+                b2Distance(&distanceOutput, &simplexCache, &distanceInput);
+
+                SetHit(gameObject, toiOutput.t, distanceOutput.pointA);
+            }
+            return true;
+        }
+        void SetHit(GameObject* gameObject, float fraction, const b2Vec2& point)
+        {
+            if (fraction >= mHitFraction && mHitObject)
+                return;
+
+            mHitObject = gameObject;
+            mHitFraction = fraction;
+            mHitPoint.x = point.x;
+            mHitPoint.y = point.y;
+        }
+    public:
+        ProjectilePhysicsBody* mProjectile;
+        b2CircleShape mProjectileShape;
+        b2DistanceProxy mProjectileProxy;
+        b2Sweep mProjectileSweep;
+        GameObject* mHitObject = nullptr;
+        float mHitFraction = 1.0f;
+        glm::vec2 mHitPoint;
+    };
+
+    WeaponInfo* weaponInfo = projectile->mReferenceProjectile->mWeaponInfo;
+    float projectileRadius = weaponInfo ? weaponInfo->mProjectileSize : 0.0f;
+
+    _query_callback query_callback {projectile, pointA, pointB, projectileRadius};
+
+    // query objects within swept bounds
+    b2AABB aabb;
+    aabb.lowerBound.x = std::min(pointA.x, pointB.x) - projectileRadius;
+    aabb.lowerBound.y = std::min(pointA.y, pointB.y) - projectileRadius;
+    aabb.upperBound.x = std::max(pointA.x, pointB.x) + projectileRadius;
+    aabb.upperBound.y = std::max(pointA.y, pointB.y) + projectileRadius;
+    mPhysicsWorld->QueryAABB(&query_callback, aabb);
+
+    if (query_callback.mHitObject)
+    {
+        outHitPoint = query_callback.mHitPoint;
     }
-    return false;
+    return query_callback.mHitObject;
 }
\ No newline at end of file
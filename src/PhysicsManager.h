@@ -6,9 +6,32 @@
 
 // note that the physics only works with meter units (Mt) rather then map units
 
+// physics simulation steps statistics info
+struct PhysicsStepStats
+{
+public:
+    PhysicsStepStats() = default;
+    void FrameBegin();
+    void FrameEnd();
+
+public:
+    int mStepsCount = 0; // per frame
+    int mStepsCountPeak = 0; // max steps done within single frame
+    int mDroppedStepsCount = 0; // total steps skipped due to max steps per frame limit
+    int mStretchedStepsCount = 0; // total steps done with adaptive step time
+    float mDroppedTime = 0.0f; // total time skipped due to max steps per frame limit, seconds
+    float mStepTime = 0.0f; // current simulation step duration, seconds
+};
+
 // this class manages physics and collision detections for map and objects
 class PhysicsManager final: private b2ContactListener
 {
+    friend class GameCheatsWindow;
+
+public:
+    // readonly
+    PhysicsStepStats mStepStats;
+
 public:
     PhysicsManager();
 
@@ -60,6 +83,17 @@ private:
     void ProcessSimulationStep();
     void ProcessInterpolation();
 
+    // choose simulation step duration for current frame depending on accumulated time
+    void UpdateSimulationStepTime();
+
+    // sweep projectile path against map blocks and objects
+    void ProcessProjectileStep(ProjectilePhysicsBody* projectile);
+
+    // find nearest car or pedestrian which intersects with projectile path, projectile is swept as circle of its size
+    // @param pointA, pointB: Projectile path segment, meters
+    // @param outHitPoint: Intersection point, meters
+    GameObject* TraceProjectileVsObjects(ProjectilePhysicsBody* projectile, const glm::vec2& pointA, const glm::vec2& pointB, glm::vec2& outHitPoint) const;
+
     // override b2ContactFilter
 	void BeginContact(b2Contact* contact) override;
 	void EndContact(b2Contact* contact) override;
@@ -73,10 +107,6 @@ private:
     bool HasCollisionCarVsMap(b2Contact* contact, b2Fixture* fixtureCar, int mapx, int mapy) const;
     bool HasCollisionPedVsCar(b2Contact* contact, PedPhysicsBody* ped, CarPhysicsBody* car) const;
 
-    bool ProcessProjectileVsMap(b2Contact* contact, ProjectilePhysicsBody* projectile, int mapx, int mapy) const;
-    bool ProcessProjectileVsCar(b2Contact* contact, ProjectilePhysicsBody* projectile, CarPhysicsBody* car) const;
-    bool ProcessProjectileVsPed(b2Contact* contact, ProjectilePhysicsBody* projectile, PedPhysicsBody* ped) const;
-
     // post solve collisions
     void HandleCollision(b2Contact* contact, PedPhysicsBody* ped, CarPhysicsBody* car, const b2ContactImpulse* impulse);
     void HandleCollision(b2Contact* contact, CarPhysicsBody* carA, CarPhysicsBody* carB, const b2ContactImpulse* impulse);
@@ -91,6 +121,7 @@ private:
 
     float mSimulationTimeAccumulator;
     float mSimulationStepTime;
+    float mNominalStepTime; // step time without adaptive stretching
 
     float mGravity; // meters per second
 
@@ -102,7 +133,7 @@ private:
     // bodies lists
     std::vector<PhysicsBody*> mPedsBodiesList;
     std::vector<PhysicsBody*> mCarsBodiesList;
-    std::vector<PhysicsBody*> mProjectileBodiesList;
+    std::vector<ProjectilePhysicsBody*> mProjectileBodiesList;
 };
 
 extern PhysicsManager gPhysics;
\ No newline at end of file
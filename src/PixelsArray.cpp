@@ -122,7 +122,7 @@ bool PixelsArray::LoadFromFile(const std::string& fileName, eTextureFormat force
         }
     }
 
-    std::ifstream fileStream;
+    FileInputStream fileStream;
     if (!gFiles.OpenBinaryFile(fileName, fileStream))
         return false;
 
@@ -131,7 +131,7 @@ bool PixelsArray::LoadFromFile(const std::string& fileName, eTextureFormat force
         // read, fill 'data' with 'size' bytes.  return number of bytes actually read
         [](void *user, char *data, int size) -> int
         {
-            std::ifstream& fs = *static_cast<std::ifstream*>(user);
+            std::istream& fs = *static_cast<FileInputStream*>(user);
             fs.read(data, size);
             std::streamsize bytes = fs.gcount();
             return static_cast<int>(bytes);
@@ -140,14 +140,14 @@ bool PixelsArray::LoadFromFile(const std::string& fileName, eTextureFormat force
         // skip, skip the next 'n' bytes, or 'unget' the last -n bytes if negative
         [](void *user, int n) -> void
         {
-            std::ifstream& fs = *static_cast<std::ifstream*>(user);
+            std::istream& fs = *static_cast<FileInputStream*>(user);
             fs.seekg(n, std::ios::cur);
         }
         ,
         // eof, returns nonzero if we are at end of file/data
         [](void *user) -> int
         {
-            std::ifstream& fs = *static_cast<std::ifstream*>(user);
+            std::istream& fs = *static_cast<FileInputStream*>(user);
             return fs.eof() ? 1 : 0;
         }
     };
@@ -16,7 +16,10 @@ RenderProgram::~RenderProgram()
 bool RenderProgram::Initialize()
 {
     if (IsProgramInited())
+    {
+        mSourceCodeRequest = FileReadFuture();
         return true;
+    }
 
     return Reinitialize();
 }
@@ -34,13 +37,21 @@ bool RenderProgram::Reinitialize()
     }
 
     // load source code
-    std::string shaderSourceCode;
-    if (!gFiles.ReadTextFile(mSourceFileName, shaderSourceCode))
+    if (!mSourceCodeRequest.valid())
+    {
+        RequestSourceCode();
+    }
+    std::shared_ptr<const FileReadResult> sourceCodeContent = mSourceCodeRequest.get();
+    mSourceCodeRequest = FileReadFuture();
+
+    if (!sourceCodeContent->mSuccess)
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot read shader source from %s", mSourceFileName);
         return false;
     }
 
+    std::string shaderSourceCode(sourceCodeContent->mContent.begin(), sourceCodeContent->mContent.end());
+
     bool isCompiled = mGpuProgram->CompileSourceCode(shaderSourceCode.c_str());
     if (isCompiled)
     {
@@ -56,6 +67,8 @@ bool RenderProgram::Reinitialize()
 
 void RenderProgram::Deinit()
 {
+    mSourceCodeRequest = FileReadFuture();
+
     if (mGpuProgram == nullptr)
         return;
 
@@ -64,6 +77,14 @@ void RenderProgram::Deinit()
     mGpuProgram = nullptr;
 }
 
+void RenderProgram::RequestSourceCode()
+{
+    if (mSourceCodeRequest.valid())
+        return;
+
+    mSourceCodeRequest = gFiles.ReadBinaryFileAsync(mSourceFileName, eFileRequestPriority_High);
+}
+
 bool RenderProgram::IsProgramInited() const
 {
     return mGpuProgram && mGpuProgram->IsProgramCompiled();
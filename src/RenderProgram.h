@@ -21,6 +21,9 @@ public:
     bool Reinitialize();
     void Deinit();
 
+    // start loading shader source in background, it will be picked up on next initialization
+    void RequestSourceCode();
+
     // test whether program is initialized and currently active
     bool IsProgramInited() const;
     bool IsActive() const;
@@ -38,4 +41,7 @@ protected:
     // overridable
     virtual void InitUniformParameters();
     virtual void BindUniformParameters();
+
+protected:
+    FileReadFuture mSourceCodeRequest;
 };
\ No newline at end of file
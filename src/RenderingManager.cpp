@@ -9,6 +9,7 @@
 #include "TrafficManager.h"
 #include "ParticleEffectsManager.h"
 #include "ParticleRenderdata.h"
+#include "MemoryTracker.h"
 
 RenderingManager gRenderManager;
 
@@ -54,6 +55,8 @@ void RenderingManager::Deinit()
 
 void RenderingManager::RenderFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Render);
+
     gGraphicsDevice.ClearScreen();
     gSpriteManager.RenderFrameBegin();
     mMapRenderer.RenderFrameBegin();
@@ -101,6 +104,14 @@ void RenderingManager::FreeRenderPrograms()
 
 bool RenderingManager::InitRenderPrograms()
 {
+    // all sources are loaded in background while programs are compiled one by one
+    mDefaultTexColorProgram.RequestSourceCode();
+    mGuiTexColorProgram.RequestSourceCode();
+    mCityMeshProgram.RequestSourceCode();
+    mSpritesProgram.RequestSourceCode();
+    mParticleProgram.RequestSourceCode();
+    mDebugProgram.RequestSourceCode();
+
     mDefaultTexColorProgram.Initialize();
     mGuiTexColorProgram.Initialize();
     mCityMeshProgram.Initialize(); 
@@ -115,6 +126,13 @@ void RenderingManager::ReloadRenderPrograms()
 {
     gConsole.LogMessage(eLogMessage_Info, "Reloading render programs...");
 
+    mDefaultTexColorProgram.RequestSourceCode();
+    mGuiTexColorProgram.RequestSourceCode();
+    mDebugProgram.RequestSourceCode();
+    mSpritesProgram.RequestSourceCode();
+    mParticleProgram.RequestSourceCode();
+    mCityMeshProgram.RequestSourceCode();
+
     mDefaultTexColorProgram.Reinitialize();
     mGuiTexColorProgram.Reinitialize();
     mDebugProgram.Reinitialize();
@@ -151,6 +169,8 @@ void RenderingManager::DetachRenderView(RenderView* renderview)
 
 void RenderingManager::RegisterParticleEffect(ParticleEffect* particleEffect)
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Render);
+
     debug_assert(particleEffect);
 
     if (particleEffect == nullptr)
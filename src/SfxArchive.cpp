@@ -14,16 +14,17 @@ bool SfxArchive::LoadArchive(const std::string& archiveName)
     std::string dataName = cxx::va("%s.RAW", archiveName.c_str());
     // read meta information
     
-    std::ifstream metaFile;
+    FileInputStream metaFile;
     if (!gFiles.OpenBinaryFile(metaName, metaFile))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot open audio metadata '%s'", metaName.c_str());
         return false;
     }
 
-    if (!gFiles.OpenBinaryFile(dataName, mRawDataStream))
+    // read all samples with single request instead of seeking for each entry
+    if (!gFiles.ReadBinaryFile(dataName, mRawData))
     {
-        gConsole.LogMessage(eLogMessage_Warning, "Cannot open audio data '%s'", dataName.c_str());
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot read audio data '%s'", dataName.c_str());
         return false;
     }
 
@@ -71,19 +72,37 @@ bool SfxArchive::LoadArchive(const std::string& archiveName)
         currEntry.mSampleRate = currEntrySrc.mSampleRate;
         currEntry.mBitsPerSample = mainMenuSounds ? 16 : 8;
         currEntry.mChannelsCount = (mainMenuSounds && icurr < 3) ? 2 : 1;
+
+        if ((currEntry.mDataOffset + (size_t) currEntry.mDataLength) > mRawData.size())
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Audio entry %d is out of data bounds in '%s'", icurr, archiveName.c_str());
+            continue;
+        }
+        currEntry.mData = mRawData.data() + currEntry.mDataOffset;
     }
 
     return true;
 }
 
 void SfxArchive::FreeArchive()
+{
+    mAudioEntries.clear();
+    FreeRawData();
+}
+
+void SfxArchive::FreeRawData()
 {
     for (SfxArchiveEntry& currEntry: mAudioEntries)
     {
-        SafeDeleteArray(currEntry.mData);
+        currEntry.mData = nullptr;
     }
-    mAudioEntries.clear();
-    mRawDataStream.close();
+    mRawData.clear();
+    mRawData.shrink_to_fit();
+}
+
+int SfxArchive::GetRawDataLength() const
+{
+    return (int) mRawData.size();
 }
 
 bool SfxArchive::IsLoaded() const
@@ -113,13 +132,9 @@ bool SfxArchive::GetEntryData(int entryIndex, SfxArchiveEntry& output)
     int MaxEntriesCount = GetEntriesCount();
     if (entryIndex < MaxEntriesCount)
     {
-        SfxArchiveEntry& currEntry = mAudioEntries[entryIndex];
-        if (currEntry.mData == nullptr) // force load audio data from raw stream
-        {
-            currEntry.mData = new unsigned char[currEntry.mDataLength];
-            mRawDataStream.seekg(currEntry.mDataOffset);
-            mRawDataStream.read((char*)currEntry.mData, currEntry.mDataLength);
-        }
+        const SfxArchiveEntry& currEntry = mAudioEntries[entryIndex];
+        if (currEntry.mData == nullptr) // out of bounds or raw data is already released
+            return false;
 
         output = currEntry;
         return true;
@@ -128,20 +143,6 @@ bool SfxArchive::GetEntryData(int entryIndex, SfxArchiveEntry& output)
     return false;
 }
 
-void SfxArchive::FreeEntryData(int entryIndex)
-{
-    int MaxEntriesCount = GetEntriesCount();
-    if (entryIndex < MaxEntriesCount)
-    {
-        SfxArchiveEntry& currEntry = mAudioEntries[entryIndex];
-        SafeDeleteArray(currEntry.mData);
-    }
-    else
-    {
-        debug_assert(false);
-    }
-}
-
 void SfxArchive::DumpSounds(const std::string& outputDirectory)
 {
     cxx::ensure_path_exists(outputDirectory);
@@ -9,7 +9,7 @@ struct SfxArchiveEntry
     unsigned int mBitsPerSample = 0;
     unsigned int mChannelsCount = 0;
 
-    unsigned char* mData = nullptr;
+    unsigned char* mData = nullptr; // points into archive raw data
 };
 
 // Contains audio entries within archive
@@ -19,24 +19,26 @@ public:
     SfxArchive() = default;
     ~SfxArchive();
 
-    // Load audio entries from archive
+    // Load audio entries from archive, samples data is read at once
     // @param archiveName: Achive name without extension
     bool LoadArchive(const std::string& archiveName);
     void FreeArchive();
     bool IsLoaded() const;
 
+    // Release samples data but keep entries info, should be done once audio buffers are created
+    void FreeRawData();
+    // Get size of samples data in memory
+    int GetRawDataLength() const;
+
     // Reading audio entries
     bool GetEntryInfo(int entryIndex, SfxArchiveEntry& output) const;
     bool GetEntryData(int entryIndex, SfxArchiveEntry& output);
     int GetEntriesCount() const;
 
-    // Unload entry data from memory
-    void FreeEntryData(int entryIndex);
-
     // Save all audio entries to wav files
     void DumpSounds(const std::string& outputDirectory);
 
 private:
     std::vector<SfxArchiveEntry> mAudioEntries;
-    std::ifstream mRawDataStream;
+    std::vector<unsigned char> mRawData;
 };
\ No newline at end of file
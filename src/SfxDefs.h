@@ -1,5 +1,14 @@
 #pragma once
 
+// sound playback priority, voices with higher priority may steal audio sources from lower priority ones
+enum eSfxPriority
+{
+    eSfxPriority_Low, // footsteps, doors
+    eSfxPriority_Normal,
+    eSfxPriority_High, // gunshots, explosions
+    eSfxPriority_Critical, // game messages, always audible
+};
+
 // level sound constants
 enum 
 {
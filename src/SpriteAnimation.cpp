@@ -1,14 +1,15 @@
 #include "stdafx.h"
 #include "SpriteAnimation.h"
 
-bool SpriteAnimData::Deserialize(cxx::json_document_node configNode)
+bool SpriteAnimData::Deserialize(cxx::json_reader_node configNode)
 {
     Clear();
 
     cxx::json_get_attribute(configNode, "fps", mFrameRate);
 
     int numFrames = 0;
-    if (cxx::json_node_array framesNode = configNode["frames"])
+    cxx::json_reader_node framesNode = configNode["frames"];
+    if (framesNode.is_array())
     {
         numFrames = framesNode.get_elements_count();
         mFrames.resize(numFrames);
@@ -33,9 +34,10 @@ bool SpriteAnimData::Deserialize(cxx::json_document_node configNode)
     }
 
     // read frame actions
-    if (cxx::json_node_array actionsNode = configNode["actions"])
+    cxx::json_reader_node actionsNode = configNode["actions"];
+    if (actionsNode.is_array())
     {
-        for (cxx::json_node_object currActionNode = actionsNode.first_child();
+        for (cxx::json_reader_node currActionNode = actionsNode.first_child();
             currActionNode; currActionNode = currActionNode.next_sibling())
         {
             int frameIndex = 0;
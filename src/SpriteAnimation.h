@@ -78,7 +78,7 @@ public:
     SpriteAnimData() = default;
 
     // Read animation data from json node, returns false on error
-    bool Deserialize(cxx::json_document_node configNode);
+    bool Deserialize(cxx::json_reader_node configNode);
     void Clear();
     void ClearFrameActions();
 
@@ -4,6 +4,7 @@
 #include "SpriteManager.h"
 #include "RenderView.h"
 #include "GpuTexture2D.h"
+#include "MemoryManager.h"
 
 const unsigned int NumVerticesPerSprite = 4;
 const unsigned int NumIndicesPerSprite = 6;
@@ -23,9 +24,17 @@ void SpriteBatch::Deinit()
 void SpriteBatch::Clear()
 {
     mSpritesList.clear();
-    mDrawVertices.clear();
-    mDrawIndices.clear();
     mBatchesList.clear();
+
+    if (mDrawVertices)
+    {
+        mDrawDataAllocator->deallocate(mDrawVertices);
+        mDrawVertices = nullptr;
+        mDrawIndices = nullptr;
+    }
+    mDrawVerticesCount = 0;
+    mDrawIndicesCount = 0;
+    mDrawDataAllocator = nullptr;
 }
 
 void SpriteBatch::DrawSprite(const Sprite2D& sourceSprite)
@@ -38,13 +47,15 @@ void SpriteBatch::Flush()
     if (!mSpritesList.empty())
     {
         SortSprites();
-        GenerateSpritesBatches();
-        RenderSpritesBatches();
+        if (GenerateSpritesBatches())
+        {
+            RenderSpritesBatches();
+        }
     }
     Clear();
 }
 
-void SpriteBatch::GenerateSpritesBatches()
+bool SpriteBatch::GenerateSpritesBatches()
 {
     int numSprites = mSpritesList.size();
 
@@ -54,12 +65,31 @@ void SpriteBatch::GenerateSpritesBatches()
     int totalIndexCount = numSprites * NumIndicesPerSprite; 
     debug_assert(totalIndexCount > 0);
 
-    // allocate memory for mesh data
-    mDrawVertices.resize(totalVertexCount);
-    SpriteVertex3D* vertexData = mDrawVertices.data();
+    // allocate memory for mesh data, vertices and indices are placed in single block
+    unsigned int vertexDataBytes = totalVertexCount * Sizeof_SpriteVertex3D;
+    unsigned int indexDataBytes = totalIndexCount * Sizeof_DrawIndex;
+
+    unsigned char* drawData = nullptr;
+    mDrawDataAllocator = gMemoryManager.GetDoubleBufferedAllocator(eFrameMemoryCategory_Mesh);
+    if (mDrawDataAllocator)
+    {
+        drawData = (unsigned char*) mDrawDataAllocator->allocate(vertexDataBytes + indexDataBytes);
+    }
+    if (drawData == nullptr)
+    {
+        mDrawDataAllocator = gMemoryManager.mHeapAllocator;
+        drawData = (unsigned char*) mDrawDataAllocator->allocate(vertexDataBytes + indexDataBytes);
+        if (drawData == nullptr)
+            return false;
+    }
+
+    mDrawVertices = (SpriteVertex3D*) drawData;
+    mDrawVerticesCount = totalVertexCount;
+    SpriteVertex3D* vertexData = mDrawVertices;
 
-    mDrawIndices.resize(totalIndexCount);
-    DrawIndex* indexData = mDrawIndices.data();
+    mDrawIndices = (DrawIndex*) (drawData + vertexDataBytes);
+    mDrawIndicesCount = totalIndexCount;
+    DrawIndex* indexData = mDrawIndices;
 
     // initial batch
     mBatchesList.clear();
@@ -143,13 +173,14 @@ void SpriteBatch::GenerateSpritesBatches()
         indexData[indexOffset + 4] = vertexOffset + 2;
         indexData[indexOffset + 5] = vertexOffset + 3;
     }
+    return true;
 }
 
 void SpriteBatch::RenderSpritesBatches()
 {
     SpriteVertex3D_Format vFormat;
-    mTrimeshBuffer.SetVertices(Sizeof_SpriteVertex3D * mDrawVertices.size(), mDrawVertices.data());
-    mTrimeshBuffer.SetIndices(Sizeof_DrawIndex * mDrawIndices.size(), mDrawIndices.data());
+    mTrimeshBuffer.SetVertices(Sizeof_SpriteVertex3D * mDrawVerticesCount, mDrawVertices);
+    mTrimeshBuffer.SetIndices(Sizeof_DrawIndex * mDrawIndicesCount, mDrawIndices);
     mTrimeshBuffer.Bind(vFormat);
 
     for (const DrawSpriteBatch& currBatch: mBatchesList)
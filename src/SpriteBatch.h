@@ -36,7 +36,7 @@ public:
     void DrawSprite(const Sprite2D& sourceSprite);
 
 private:
-    void GenerateSpritesBatches();
+    bool GenerateSpritesBatches();
     void RenderSpritesBatches();
     void SortSprites();
 
@@ -53,9 +53,12 @@ private:
     // all sprites stored as is until they needs to be flushed
     std::vector<Sprite2D> mSpritesList;
 
-    // draw data buffers
-    std::vector<SpriteVertex3D> mDrawVertices;
-    std::vector<DrawIndex> mDrawIndices;
+    // draw data buffers, allocated on double buffered frame heap for upload stage
+    cxx::memory_allocator* mDrawDataAllocator = nullptr;
+    SpriteVertex3D* mDrawVertices = nullptr;
+    DrawIndex* mDrawIndices = nullptr;
+    unsigned int mDrawVerticesCount = 0;
+    unsigned int mDrawIndicesCount = 0;
 
     std::vector<DrawSpriteBatch> mBatchesList;
     TrimeshBuffer mTrimeshBuffer;
@@ -109,7 +109,7 @@ bool SpriteManager::InitObjectsSpritesheet()
 
     // allocate temporary bitmap
     PixelsArray spritesBitmap;
-    if (!spritesBitmap.Create(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY, gMemoryManager.mFrameHeapAllocator))
+    if (!spritesBitmap.Create(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
     {
         debug_assert(false);
         return false;
@@ -196,7 +196,7 @@ bool SpriteManager::InitBlocksTexture()
 
     // allocate temporary bitmap
     PixelsArray blockBitmap;
-    if (!blockBitmap.Create(eTextureFormat_R8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, gMemoryManager.mFrameHeapAllocator))
+    if (!blockBitmap.Create(eTextureFormat_R8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
     {
         debug_assert(false);
         return false;
@@ -342,7 +342,7 @@ void SpriteManager::DumpBlocksTexture(const std::string& outputLocation)
     cxx::ensure_path_exists(outputLocation);
     // allocate temporary bitmap
     PixelsArray blockBitmap;
-    if (!blockBitmap.Create(eTextureFormat_RGBA8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, gMemoryManager.mFrameHeapAllocator))
+    if (!blockBitmap.Create(eTextureFormat_RGBA8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
     {
         debug_assert(false);
         return;
@@ -388,7 +388,7 @@ void SpriteManager::DumpSpriteTextures(const std::string& outputLocation)
             PixelsArray spriteBitmap;
             spriteBitmap.Create(eTextureFormat_RGBA8, 
                 cityStyle.mSprites[sprite_index].mWidth, 
-                cityStyle.mSprites[sprite_index].mHeight, gMemoryManager.mFrameHeapAllocator);
+                cityStyle.mSprites[sprite_index].mHeight, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels));
             cityStyle.GetSpriteTexture(sprite_index, &spriteBitmap, 0, 0);
             
             // dump to file
@@ -415,7 +415,7 @@ void SpriteManager::DumpCarsTextures(const std::string& outputLocation)
         PixelsArray spriteBitmap;
         spriteBitmap.Create(eTextureFormat_RGBA8, 
             cityStyle.mSprites[sprite_index].mWidth, 
-            cityStyle.mSprites[sprite_index].mHeight, gMemoryManager.mFrameHeapAllocator);
+            cityStyle.mSprites[sprite_index].mHeight, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels));
         cityStyle.GetSpriteTexture(sprite_index, &spriteBitmap, 0, 0);
             
         // dump to file
@@ -443,7 +443,7 @@ void SpriteManager::DumpSpriteDeltas(const std::string& outputLocation)
         SpriteInfo& sprite = gGameMap.mStyleData.mSprites[isprite];
 
         PixelsArray spriteBitmap;
-        spriteBitmap.Create(eTextureFormat_RGBA8, sprite.mWidth, sprite.mHeight, gMemoryManager.mFrameHeapAllocator);
+        spriteBitmap.Create(eTextureFormat_RGBA8, sprite.mWidth, sprite.mHeight, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels));
         for (int idelta = 0; idelta < sprite.mDeltaCount; ++idelta)
         {
             if (!cityStyle.GetSpriteTexture(isprite, BIT(idelta), &spriteBitmap, 0, 0))
@@ -472,7 +472,7 @@ void SpriteManager::DumpSpriteDeltas(const std::string& outputLocation, int spri
     SpriteInfo& sprite = cityStyle.mSprites[spriteIndex];
 
     PixelsArray spriteBitmap;
-    spriteBitmap.Create(eTextureFormat_RGBA8, sprite.mWidth, sprite.mHeight, gMemoryManager.mFrameHeapAllocator);
+    spriteBitmap.Create(eTextureFormat_RGBA8, sprite.mWidth, sprite.mHeight, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels));
     for (int idelta = 0; idelta < sprite.mDeltaCount; ++idelta)
     {
         if (!cityStyle.GetSpriteTexture(spriteIndex, BIT(idelta), &spriteBitmap, 0, 0))
@@ -566,7 +566,7 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
             PixelsArray pixels;
             if (!pixels.Create(currElement.mTexture->mFormat, 
                 currElement.mTexture->mSize.x, 
-                currElement.mTexture->mSize.y, gMemoryManager.mFrameHeapAllocator))
+                currElement.mTexture->mSize.y, gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
             {
                 debug_assert(false);
             }
@@ -595,7 +595,7 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
 
     PixelsArray pixels;
     if (!pixels.Create(eTextureFormat_R8UI, dimensions.x, dimensions.y, 
-        gMemoryManager.mFrameHeapAllocator))
+        gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
     {
         debug_assert(false);
     }
@@ -679,7 +679,7 @@ void SpriteManager::InitExplosionFrames()
 
     PixelsArray pixels;
     if (!pixels.Create(eTextureFormat_R8UI, textureSizex, textureSizey, 
-        gMemoryManager.mFrameHeapAllocator))
+        gMemoryManager.GetFrameAllocator(eFrameMemoryCategory_Pixels)))
     {
         debug_assert(false);
         return;
@@ -1,36 +1,97 @@
 #include "stdafx.h"
 #include "StyleData.h"
+#include "cvars.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+// entity definitions, each one can be precompiled to binary blob with same name and .bin extension
+static const char* EntityConfigFiles[] =
+{
+    "entities/gta_objects.json",
+    "entities/ped_animations.json",
+    "entities/pedestrians.json",
+    "entities/weapons.json",
+};
+
+static void CompileEntitiesCommandProc(const std::string& commandParams);
+
+// cvars
+CvarBoolean gCvarUseCompiledEntities("g_useCompiledEntities", false, "Load entity definitions from precompiled binary blobs", CvarFlags_Archive | CvarFlags_Init);
+CvarCommand gCvarCompileEntities("g_compileEntities", CompileEntitiesCommandProc, "Compile entity definitions to binary blobs", CvarFlags_None);
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string GetEntityBlobName(const char* configName)
+{
+    std::string blobName = configName;
+    blobName.erase(blobName.find_last_of('.'));
+    blobName.append(".bin");
+    return blobName;
+}
+
+static void CompileEntitiesCommandProc(const std::string& commandParams)
+{
+    cxx::json_reader configReader;
+    std::vector<unsigned char> configContent;
+    for (const char* currConfigName: EntityConfigFiles)
+    {
+        if (!gFiles.ReadBinaryFile(currConfigName, configContent) ||
+            !configReader.parse_document((const char*) configContent.data(), configContent.size()))
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot parse '%s'", currConfigName);
+            continue;
+        }
+
+        configReader.save_binary(configContent);
+
+        std::string blobName = GetEntityBlobName(currConfigName);
+        std::ofstream blobFile;
+        if (!gFiles.CreateBinaryFile(blobName, blobFile) || !blobFile.write((const char*) configContent.data(), configContent.size()))
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot write '%s'", blobName.c_str());
+            continue;
+        }
+        gConsole.LogMessage(eLogMessage_Info, "Compiled '%s'", blobName.c_str());
+    }
+}
 
 //////////////////////////////////////////////////////////////////////////
 
 // read distance in map units and convert it to meters
-inline bool ParseMapUnits(cxx::json_document_node node, const std::string& attribute, float& output)
+inline bool ParseMapUnits(cxx::json_reader_node node, const char* attribute, float& output)
 {
-    cxx::json_document_node attribute_node = node[attribute];
-    if (cxx::json_node_numeric numeric_node = attribute_node)
+    float mapUnits = 0.0f;
+    if (node[attribute].get_value(mapUnits))
     {
-        output = Convert::MapUnitsToMeters(numeric_node.get_value_float());
+        output = Convert::MapUnitsToMeters(mapUnits);
         return true;
     }
     return false;
 }
 
 // read gameobject flags
-inline bool ParseObjectFlags(cxx::json_document_node node, const std::string& attribute, eGameObjectFlags& flags)
+inline bool ParseObjectFlags(cxx::json_reader_node node, const char* attribute, eGameObjectFlags& flags)
 {
-    if (cxx::json_node_array flagsNode = node[attribute])
+    cxx::json_reader_node flagsNode = node[attribute];
+    if (flagsNode.is_array())
     {
-        for (cxx::json_node_string currFlag = flagsNode.first_child();
+        for (cxx::json_reader_node currFlag = flagsNode.first_child();
             currFlag; currFlag = currFlag.next_sibling())
         {
-            std::string flag_string = currFlag.get_value();
-            if (flag_string == "invisible")
+            const char* flag_string = currFlag.get_value_cstr();
+            if (flag_string == nullptr)
+            {
+                debug_assert(false);
+                continue;
+            }
+
+            if (strcmp(flag_string, "invisible") == 0)
             {
                 flags = (flags | eGameObjectFlags_Invisible);
                 continue;
             }
 
-            if (flag_string == "carobject")
+            if (strcmp(flag_string, "carobject") == 0)
             {
                 flags = (flags | eGameObjectFlags_CarPart);
                 continue;
@@ -113,17 +174,27 @@ int StyleData::GetBlockTextureLinearIndex(eBlockType blockType, int blockIndex)
     return 0;
 }
 
-bool StyleData::LoadFromFile(const std::string& stylesName)
+bool StyleData::LoadFromFile(const std::string& stylesName, FileReadFuture contentRequest)
 {
     Cleanup();
 
-    std::ifstream file;
-    if (!gFiles.OpenBinaryFile(stylesName, file))
+    if (!contentRequest.valid())
+    {
+        contentRequest = gFiles.ReadBinaryFileAsync(stylesName, eFileRequestPriority_High);
+    }
+    std::shared_ptr<const FileReadResult> styleContent = contentRequest.get();
+    if (!styleContent->mSuccess)
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot open style file '%s'", stylesName.c_str());
         return false;
     }
 
+    // whole file is in memory, seeking around is cheap
+    char* styleData = (char*) styleContent->mContent.data();
+    cxx::memory_istream styleDataBuffer(styleData, styleData + styleContent->mContent.size());
+
+    std::istream file(&styleDataBuffer);
+
     file.seekg(0, std::ios::end);
     std::streampos fileSize = file.tellg();
     file.seekg(0, std::ios::beg);
@@ -223,8 +294,6 @@ bool StyleData::LoadFromFile(const std::string& stylesName)
         return false;
     }
 
-    file.close();
-
     if (!InitGameObjects())
     {
         gConsole.LogMessage(eLogMessage_Warning, "Fail to initialize game objects");
@@ -610,7 +679,7 @@ int StyleData::GetVehicleSpriteIndex(eVehicleClass vehicleClass, int spriteId) c
     return GetSpriteIndex(spriteType, spriteId);
 }
 
-bool StyleData::ReadBlockTextures(std::ifstream& file)
+bool StyleData::ReadBlockTextures(std::istream& file)
 {
     const int totalBlocks = (mSideBlocksCount + mLidBlocksCount + mAuxBlocksCount);
 
@@ -632,7 +701,7 @@ bool StyleData::ReadBlockTextures(std::ifstream& file)
     return true;
 }
 
-bool StyleData::ReadCLUTs(std::ifstream& file, int dataLength)
+bool StyleData::ReadCLUTs(std::istream& file, int dataLength)
 {
     const int palCount = dataLength / sizeof(Palette256);
     if (palCount == 0)
@@ -670,7 +739,7 @@ bool StyleData::ReadCLUTs(std::ifstream& file, int dataLength)
     return true;
 }
 
-bool StyleData::ReadPaletteIndices(std::ifstream& file, int dataLength)
+bool StyleData::ReadPaletteIndices(std::istream& file, int dataLength)
 {
     mPaletteIndices.resize(dataLength / sizeof(unsigned short));
     // read bunch of shorts
@@ -680,7 +749,7 @@ bool StyleData::ReadPaletteIndices(std::ifstream& file, int dataLength)
     return true;
 }
 
-bool StyleData::ReadAnimations(std::ifstream& file, int dataLength)
+bool StyleData::ReadAnimations(std::istream& file, int dataLength)
 {
     unsigned char numAnimationBlocks = 0;
     if (!cxx::read_from_stream(file, numAnimationBlocks))
@@ -711,7 +780,7 @@ bool StyleData::ReadAnimations(std::ifstream& file, int dataLength)
     return true;
 }
 
-bool StyleData::ReadObjects(std::ifstream& file, int dataLength)
+bool StyleData::ReadObjects(std::istream& file, int dataLength)
 {
     for (int icurrentObject = 0; dataLength > 0; ++icurrentObject)
     {
@@ -746,7 +815,7 @@ bool StyleData::ReadObjects(std::ifstream& file, int dataLength)
     return dataLength == 0;
 }
 
-bool StyleData::ReadVehicles(std::ifstream& file, int dataLength)
+bool StyleData::ReadVehicles(std::istream& file, int dataLength)
 {
     for (int icurrent = 0; dataLength > 0; ++icurrent)
     {
@@ -881,7 +950,7 @@ bool StyleData::ReadVehicles(std::ifstream& file, int dataLength)
     return dataLength == 0;
 }
 
-bool StyleData::ReadSprites(std::ifstream& file, int dataLength)
+bool StyleData::ReadSprites(std::istream& file, int dataLength)
 {
     for (; dataLength > 0;)
     {
@@ -917,7 +986,7 @@ bool StyleData::ReadSprites(std::ifstream& file, int dataLength)
     return dataLength == 0;
 }
 
-bool StyleData::ReadSpriteGraphics(std::ifstream& file, int dataLength)
+bool StyleData::ReadSpriteGraphics(std::istream& file, int dataLength)
 {
     if (dataLength > 0)
     {
@@ -930,7 +999,7 @@ bool StyleData::ReadSpriteGraphics(std::ifstream& file, int dataLength)
     return true;
 }
 
-bool StyleData::ReadSpriteNumbers(std::ifstream& file, int dataLength)
+bool StyleData::ReadSpriteNumbers(std::istream& file, int dataLength)
 {
     if (dataLength > 0)
     {
@@ -974,14 +1043,13 @@ bool StyleData::ReadWeaponTypes()
 {
     mWeaponTypes.resize(eWeapon_COUNT);
 
-    cxx::json_document weaponsConfig;
-    if (!gFiles.ReadConfig("entities/weapons.json", weaponsConfig))
+    if (!ReadEntityConfig("entities/weapons.json"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot read 'entities/weapons.json'");
         return false;
     }
 
-    for (cxx::json_node_object currentNode = weaponsConfig.get_root_node().first_child();
+    for (cxx::json_reader_node currentNode = mEntityConfig.get_root_node().first_child();
         currentNode; currentNode = currentNode.next_sibling())
     {
         WeaponInfo currentWeapon;
@@ -1000,14 +1068,13 @@ bool StyleData::ReadPedestrianTypes()
 {
     mPedestrianTypes.resize(ePedestrianType_COUNT);
 
-    cxx::json_document pedsConfig;
-    if (!gFiles.ReadConfig("entities/pedestrians.json", pedsConfig))
+    if (!ReadEntityConfig("entities/pedestrians.json"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot read 'entities/pedestrians.json'");
         return false;
     }
 
-    for (cxx::json_node_object currentNode = pedsConfig.get_root_node().first_child();
+    for (cxx::json_reader_node currentNode = mEntityConfig.get_root_node().first_child();
         currentNode; currentNode = currentNode.next_sibling())
     {
         PedestrianInfo currentPedestrian;
@@ -1025,24 +1092,22 @@ bool StyleData::ReadPedestrianTypes()
 
 void StyleData::ReadPedestrianAnimations()
 {
-    cxx::json_document configDocument;
-    if (!gFiles.ReadConfig("entities/ped_animations.json", configDocument))
+    if (!ReadEntityConfig("entities/ped_animations.json"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load ped animations config");
         return;
     }
 
-    std::string currAnimName;
-    for (cxx::json_node_object currentNode = configDocument.get_root_node().first_child();
+    for (cxx::json_reader_node currentNode = mEntityConfig.get_root_node().first_child();
         currentNode; currentNode = currentNode.next_sibling())
     {
-        currAnimName = currentNode.get_element_name();
+        const char* currAnimName = currentNode.get_element_name();
 
         // parse id
         ePedestrianAnimID animID = ePedestrianAnim_Null;
-        if (!cxx::parse_enum(currAnimName.c_str(), animID))
+        if (!cxx::parse_enum(currAnimName, animID))
         {
-            gConsole.LogMessage(eLogMessage_Warning, "Unknown ped anim id '%s'", currAnimName.c_str());
+            gConsole.LogMessage(eLogMessage_Warning, "Unknown ped anim id '%s'", currAnimName);
             continue;
         }
         SpriteAnimData& animDesc = mPedestrianAnimations[animID];
@@ -1066,14 +1131,13 @@ bool StyleData::InitGameObjects()
         gConsole.LogMessage(eLogMessage_Info, "Found %d gameobjects which is odd, normal value is %d", rawObjectsCount, GameObjectType_MAX);
     }
 
-    cxx::json_document gameobjects_config;
-    if (!gFiles.ReadConfig("entities/gta_objects.json", gameobjects_config))
+    if (!ReadEntityConfig("entities/gta_objects.json"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load gta objects config");
         return false;
     }
 
-    cxx::json_node_array arrayNode = gameobjects_config.get_root_node();
+    cxx::json_reader_node arrayNode = mEntityConfig.get_root_node();
     int arrayElements = arrayNode.get_elements_count();
 
     if (arrayElements != rawObjectsCount)
@@ -1086,7 +1150,9 @@ bool StyleData::InitGameObjects()
     // default init objects
     mObjects.clear();
     mObjects.resize(GameObjectType_MAX);
-    for (int icurr = 0; icurr < numElementsToLoad; ++icurr)
+
+    cxx::json_reader_node currObjectNode = arrayNode.first_child();
+    for (int icurr = 0; icurr < numElementsToLoad; ++icurr, currObjectNode = currObjectNode.next_sibling())
     {
         GameObjectInfo& currObject = mObjects[icurr];
         currObject.mObjectType = icurr;
@@ -1094,8 +1160,7 @@ bool StyleData::InitGameObjects()
 
         ObjectRawData& objectRaw = mObjectsRaw[icurr];
 
-        cxx::json_node_object currObjectNode = arrayNode[icurr];
-        if (!currObjectNode)
+        if (!currObjectNode.is_object())
         {
             debug_assert(false);
             continue;
@@ -1150,6 +1215,44 @@ bool StyleData::InitGameObjects()
     return true;
 }
 
+bool StyleData::ReadEntityConfig(const char* configName)
+{
+    bool hasSource = gFiles.ReadBinaryFile(configName, mEntityConfigContent);
+
+    // precompiled blob does not need parsing, but it must be built from current json source
+    if (gCvarUseCompiledEntities.mValue)
+    {
+        std::string blobName = GetEntityBlobName(configName);
+        if (gFiles.ReadBinaryFile(blobName, mEntityBlobContent) &&
+            mEntityConfig.load_binary(mEntityBlobContent.data(), mEntityBlobContent.size()))
+        {
+            if (!hasSource)
+                return true;
+
+            if (mEntityConfig.get_source_length() == mEntityConfigContent.size() &&
+                mEntityConfig.get_source_hash() == cxx::json_reader::compute_source_hash((const char*) mEntityConfigContent.data(), mEntityConfigContent.size()))
+            {
+                return true;
+            }
+            gConsole.LogMessage(eLogMessage_Warning, "Compiled entities '%s' are outdated, fallback to json", blobName.c_str());
+        }
+        else
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot load compiled entities '%s', fallback to json", blobName.c_str());
+        }
+    }
+
+    if (!hasSource)
+        return false;
+
+    if (!mEntityConfig.parse_document((const char*) mEntityConfigContent.data(), mEntityConfigContent.size()))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot parse config file '%s'", configName);
+        return false;
+    }
+    return true;
+}
+
 int StyleData::GetWreckedVehicleSpriteIndex(eVehicleClass vehicleClass) const
 {
     static unsigned int StandardCarSpriteVariationCounter = 0;
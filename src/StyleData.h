@@ -31,7 +31,8 @@ public:
     StyleData();
     // Load style data from specific file, returns false on error
     // @param stylesName: Target file name
-    bool LoadFromFile(const std::string& stylesName);
+    // @param contentRequest: Optional async read of target file which is already in progress
+    bool LoadFromFile(const std::string& stylesName, FileReadFuture contentRequest = FileReadFuture());
     void Cleanup();
     bool IsLoaded() const;
 
@@ -117,15 +118,15 @@ private:
 
     // Reading style data internals
     // @param file: Source stream
-    bool ReadBlockTextures(std::ifstream& file);
-    bool ReadCLUTs(std::ifstream& file, int dataLength);
-    bool ReadPaletteIndices(std::ifstream& file, int dataLength);
-    bool ReadAnimations(std::ifstream& file, int dataLength);
-    bool ReadObjects(std::ifstream& file, int dataLength);
-    bool ReadVehicles(std::ifstream& file, int dataLength);
-    bool ReadSprites(std::ifstream& file, int dataLength);
-    bool ReadSpriteGraphics(std::ifstream& file, int dataLength);
-    bool ReadSpriteNumbers(std::ifstream& file, int dataLength);
+    bool ReadBlockTextures(std::istream& file);
+    bool ReadCLUTs(std::istream& file, int dataLength);
+    bool ReadPaletteIndices(std::istream& file, int dataLength);
+    bool ReadAnimations(std::istream& file, int dataLength);
+    bool ReadObjects(std::istream& file, int dataLength);
+    bool ReadVehicles(std::istream& file, int dataLength);
+    bool ReadSprites(std::istream& file, int dataLength);
+    bool ReadSpriteGraphics(std::istream& file, int dataLength);
+    bool ReadSpriteNumbers(std::istream& file, int dataLength);
 
     void ReadPedestrianAnimations();
     bool ReadWeaponTypes();
@@ -133,6 +134,10 @@ private:
 
     bool InitGameObjects();
 
+    // Load entity definitions either from json source or from precompiled binary blob
+    // @param configName: Json source file name
+    bool ReadEntityConfig(const char* configName);
+
     bool DoDataIntegrityCheck() const;
 
 private:
@@ -166,6 +171,11 @@ private:
     // sprites animations
     SpriteAnimData mPedestrianAnimations[ePedestrianAnim_COUNT];
 
+    // entity definitions reader, buffers are reused between configs
+    cxx::json_reader mEntityConfig;
+    std::vector<unsigned char> mEntityConfigContent;
+    std::vector<unsigned char> mEntityBlobContent;
+
     // counters
     int mTileClutsCount; 
     int mSpriteClutsCount; 
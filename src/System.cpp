@@ -3,6 +3,7 @@
 #include "GraphicsDevice.h"
 #include "RenderingManager.h"
 #include "MemoryManager.h"
+#include "MemoryTracker.h"
 #include "CarnageGame.h"
 #include "ImGuiManager.h"
 #include "TimeManager.h"
@@ -25,7 +26,10 @@ CvarBoolean gCvarGraphicsVSync("r_vsync", true, "Is vertical synchronization ena
 CvarBoolean gCvarGraphicsTexFiltering("r_texFiltering", false, "Is texture filtering enabled", CvarFlags_Archive | CvarFlags_Readonly);
 
 // physics
-CvarFloat gCvarPhysicsFramerate("g_physicsFps", 60.0f, "Physical world update framerate", CvarFlags_Archive | CvarFlags_Init);
+CvarFloat gCvarPhysicsFramerate("g_physicsFps", 60.0f, 1.0f, 1000.0f, "Physical world update framerate", CvarFlags_Archive);
+CvarInt gCvarPhysicsMaxSteps("g_physicsMaxSteps", 4, 1, 32, "Max physical world simulation steps per frame", CvarFlags_Archive);
+CvarBoolean gCvarPhysicsAdaptiveStep("g_physicsAdaptiveStep", false, "Stretch physical world simulation step under high load", CvarFlags_Archive);
+CvarFloat gCvarPhysicsMinFramerate("g_physicsMinFps", 20.0f, 1.0f, 1000.0f, "Lowest physical world update framerate for adaptive step", CvarFlags_Archive);
 
 // memory
 CvarBoolean gCvarMemEnableFrameHeapAllocator("mem_enableFrameHeapAllocator", true, "Enable frame heap allocator", CvarFlags_Archive | CvarFlags_Init);
@@ -248,16 +252,17 @@ bool System::ExecuteFrame()
     if (mQuitRequested)
         return false;
 
+    gConsole.UpdateFrame();
     gInputs.UpdateFrame();
     gTimeManager.UpdateFrame();
     gMemoryManager.FlushFrameHeapMemory();
+    gMemoryTracker.UpdateFrame();
     gImGuiManager.UpdateFrame();
     gGuiManager.UpdateFrame();
     gCarnageGame.UpdateFrame();
     if (gAudioDevice.IsInitialized())
     {
-        gAudioManager.UpdateFrame();
-        gAudioDevice.UpdateFrame(); // update at logic frame end
+        gAudioManager.UpdateFrame(); // update at logic frame end
     }
 
     // update screen params
@@ -7,6 +7,7 @@
 #include "AiManager.h"
 #include "GameCheatsWindow.h"
 #include "AiCharacterController.h"
+#include "MemoryTracker.h"
 
 TrafficManager gTrafficManager;
 
@@ -16,6 +17,9 @@ TrafficManager::TrafficManager()
 
 void TrafficManager::StartupTraffic()
 {   
+    BuildSpawnCandidatesIndex();
+    UpdateTrafficRegions();
+
     mLastGenHareKrishnasTime = gTimeManager.mGameTime;
 
     mLastGenPedsTime = 0.0f;
@@ -24,6 +28,8 @@ void TrafficManager::StartupTraffic()
     mLastGenCarsTime = 0.0f;
     GenerateCars();
 
+    SeedAbstractCars();
+
 }
 
 void TrafficManager::CleanupTraffic()
@@ -37,16 +43,412 @@ void TrafficManager::CleanupTraffic()
     {
         TryRemoveTrafficPed(currPedestrian);
     }
+
+    mCarsSpawnIndex.Clear();
+    mPedsSpawnIndex.Clear();
+    mTrafficRegions.clear();
+    mAbstractCars.clear();
 }
 
 void TrafficManager::UpdateFrame()
 {
+    MEMORY_TAG_SCOPE(eMemoryTag_Traffic);
+
+    UpdateTrafficRegions();
+    UpdateAbstractCars();
+
     GeneratePeds();
     GenerateCars();
 }
 
+void TrafficManager::UpdateTrafficRegions()
+{
+    mTrafficRegions.clear();
+    mAverageViewArea = 0.0f;
+
+    int viewsCount = 0;
+    for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
+    {
+        if (humanPlayer == nullptr)
+            continue;
+
+        const cxx::aabbox2d_t& onScreenArea = humanPlayer->mPlayerView.mOnScreenArea;
+        glm::vec2 areaSize = onScreenArea.mMax - onScreenArea.mMin;
+        mAverageViewArea += areaSize.x * areaSize.y;
+        ++viewsCount;
+
+        TrafficRegion region;
+        region.mOnScreenArea = onScreenArea;
+        region.mViewsCount = 1;
+        mTrafficRegions.push_back(region);
+    }
+
+    if (viewsCount > 0)
+    {
+        mAverageViewArea /= viewsCount;
+    }
+
+    // merge overlapping views until there is nothing to merge
+    for (bool hasMerged = true; hasMerged; )
+    {
+        hasMerged = false;
+        for (size_t iregion = 0; iregion < mTrafficRegions.size() && !hasMerged; ++iregion)
+        for (size_t iother = iregion + 1; iother < mTrafficRegions.size(); ++iother)
+        {
+            TrafficRegion& region = mTrafficRegions[iregion];
+            const TrafficRegion& otherRegion = mTrafficRegions[iother];
+            if (!region.mOnScreenArea.contains(otherRegion.mOnScreenArea))
+                continue;
+
+            region.mOnScreenArea = region.mOnScreenArea.union_with(otherRegion.mOnScreenArea);
+            region.mViewsCount += otherRegion.mViewsCount;
+            mTrafficRegions.erase(mTrafficRegions.begin() + iother);
+            hasMerged = true;
+            break;
+        }
+    }
+}
+
+bool TrafficManager::IsRelevantObject(const GameObject* gameObject, float expandDistance) const
+{
+    for (const TrafficRegion& currRegion: mTrafficRegions)
+    {
+        cxx::aabbox2d_t onScreenArea = currRegion.mOnScreenArea;
+        onScreenArea.mMax.x += expandDistance;
+        onScreenArea.mMax.y += expandDistance;
+        onScreenArea.mMin.x -= expandDistance;
+        onScreenArea.mMin.y -= expandDistance;
+
+        if (gameObject->IsOnScreen(onScreenArea))
+            return true;
+    }
+    return false;
+}
+
+// test whether traffic object should be counted in region population
+inline bool IsTrafficPopulationObject(const Pedestrian* pedestrian)
+{
+    return pedestrian->IsTrafficFlag() && !pedestrian->IsMarkedForDeletion() && !pedestrian->IsCarPassenger();
+}
+
+inline bool IsTrafficPopulationObject(const Vehicle* vehicle)
+{
+    return vehicle->IsTrafficFlag() && !vehicle->IsMarkedForDeletion();
+}
+
+template<typename TObjectClass>
+void TrafficManager::ComputeSpawnQuotas(const std::vector<TObjectClass*>& objectsList, int maxObjectsPerView, int maxDistance,
+    int spawnBudget, std::vector<int>& outputSpawnCounts)
+{
+    const float expandDistance = Convert::MapUnitsToMeters(maxDistance * 1.0f);
+
+    // merged region gets quota by its area but no more than all its views would have separately
+    for (TrafficRegion& currRegion: mTrafficRegions)
+    {
+        glm::vec2 areaSize = currRegion.mOnScreenArea.mMax - currRegion.mOnScreenArea.mMin;
+        float areaScale = (mAverageViewArea > 0.0f) ? ((areaSize.x * areaSize.y) / mAverageViewArea) : 1.0f;
+
+        currRegion.mQuota = (int) (maxObjectsPerView * areaScale + 0.5f);
+        currRegion.mQuota = glm::clamp(currRegion.mQuota, maxObjectsPerView, maxObjectsPerView * currRegion.mViewsCount);
+        currRegion.mPopulation = 0;
+    }
+
+    // count population, each object belongs to single region
+    for (TObjectClass* currObject: objectsList)
+    {
+        if (!IsTrafficPopulationObject(currObject))
+            continue;
+
+        for (TrafficRegion& currRegion: mTrafficRegions)
+        {
+            cxx::aabbox2d_t onScreenArea = currRegion.mOnScreenArea;
+            onScreenArea.mMax.x += expandDistance;
+            onScreenArea.mMax.y += expandDistance;
+            onScreenArea.mMin.x -= expandDistance;
+            onScreenArea.mMin.y -= expandDistance;
+
+            if (currObject->IsOnScreen(onScreenArea))
+            {
+                ++currRegion.mPopulation;
+                break;
+            }
+        }
+    }
+
+    // distribute spawn budget proportionally to missing population
+    int totalDeficit = 0;
+    for (const TrafficRegion& currRegion: mTrafficRegions)
+    {
+        totalDeficit += std::max(0, currRegion.mQuota - currRegion.mPopulation);
+    }
+
+    outputSpawnCounts.clear();
+    for (const TrafficRegion& currRegion: mTrafficRegions)
+    {
+        int regionDeficit = std::max(0, currRegion.mQuota - currRegion.mPopulation);
+        int spawnCount = 0;
+        if (totalDeficit > spawnBudget)
+        {
+            spawnCount = (regionDeficit * spawnBudget + totalDeficit - 1) / totalDeficit;
+        }
+        else
+        {
+            spawnCount = regionDeficit;
+        }
+        outputSpawnCounts.push_back(spawnCount);
+    }
+}
+
 void TrafficManager::DebugDraw(DebugRenderer& debugRender)
 {
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+    for (const AbstractCar& currCar: mAbstractCars)
+    {
+        float height = Convert::MapUnitsToMeters(laneGraph.mNodes[currCar.mFromNode].mMapLayer * 1.0f);
+        glm::vec2 fromPosition = laneGraph.GetNodePosition2(currCar.mFromNode);
+        glm::vec2 toPosition = laneGraph.GetNodePosition2(currCar.mToNode);
+        glm::vec2 carPosition = glm::mix(fromPosition, toPosition, currCar.mLaneProgress);
+        debugRender.DrawLine(glm::vec3(fromPosition.x, height, fromPosition.y), glm::vec3(carPosition.x, height, carPosition.y), Color32_Yellow, false);
+    }
+}
+
+void TrafficManager::SeedAbstractCars()
+{
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+    if (laneGraph.mNodes.empty())
+        return;
+
+    cxx::randomizer& random = gCarnageGame.mGameRand;
+
+    const float expandDistance = Convert::MapUnitsToMeters(gGameParams.mTrafficGenCarsMaxDistance + 1.0f);
+    const int NodesCount = (int) laneGraph.mNodes.size();
+    const int SeedCarsCount = gGameParams.mTrafficAbstractMaxCars / 2;
+    for (int iattempt = 0; iattempt < SeedCarsCount * 2 && (int) mAbstractCars.size() < SeedCarsCount; ++iattempt)
+    {
+        int fromNode = random.generate_int(0, NodesCount - 1);
+        int toNode = ChooseNextLaneNode(AiRoadLaneGraph::InvalidNodeIndex, fromNode);
+        if (toNode == AiRoadLaneGraph::InvalidNodeIndex)
+            continue;
+
+        // should not be seen by players
+        glm::vec2 position = laneGraph.GetNodePosition2(fromNode);
+        bool isRelevant = cxx::contains_if(mTrafficRegions, [&position, expandDistance](const TrafficRegion& region)
+        {
+            cxx::aabbox2d_t onScreenArea = region.mOnScreenArea;
+            onScreenArea.mMax += expandDistance;
+            onScreenArea.mMin -= expandDistance;
+            return onScreenArea.contains(position);
+        });
+        if (isRelevant)
+            continue;
+
+        VehicleInfo* carInfo = ChooseRandomTrafficCarModel();
+        if (carInfo == nullptr)
+            break;
+
+        AbstractCar abstractCar;
+        abstractCar.mCarInfo = carInfo;
+        abstractCar.mFromNode = fromNode;
+        abstractCar.mToNode = toNode;
+        abstractCar.mLaneProgress = random.generate_float();
+        mAbstractCars.push_back(abstractCar);
+    }
+}
+
+void TrafficManager::UpdateAbstractCars()
+{
+    if (mAbstractCars.empty())
+        return;
+
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+
+    // lane nodes are neighbour blocks so distance between them is single map unit
+    const float progressDelta = Convert::MetersToMapUnits(gGameParams.mAiCarDriveSpeed) * gTimeManager.mGameFrameDelta;
+    const float expandDistance = Convert::MapUnitsToMeters(gGameParams.mTrafficGenCarsMaxDistance * 1.0f);
+
+    bool regionsPopulationCounted = false;
+    for (size_t icar = 0; icar < mAbstractCars.size(); )
+    {
+        AbstractCar& currCar = mAbstractCars[icar];
+
+        // advance along lanes
+        currCar.mLaneProgress += progressDelta;
+        bool isDeadEnd = false;
+        while (currCar.mLaneProgress >= 1.0f)
+        {
+            int nextNode = ChooseNextLaneNode(currCar.mFromNode, currCar.mToNode);
+            if (nextNode == AiRoadLaneGraph::InvalidNodeIndex)
+            {
+                isDeadEnd = true;
+                break;
+            }
+            currCar.mFromNode = currCar.mToNode;
+            currCar.mToNode = nextNode;
+            currCar.mLaneProgress -= 1.0f;
+        }
+
+        if (isDeadEnd)
+        {
+            currCar = mAbstractCars.back();
+            mAbstractCars.pop_back();
+            continue;
+        }
+
+        // promote to physical car when it approaches player view, but not right before player eyes
+        glm::vec2 position = glm::mix(laneGraph.GetNodePosition2(currCar.mFromNode), 
+            laneGraph.GetNodePosition2(currCar.mToNode), currCar.mLaneProgress);
+
+        bool shouldPromote = false;
+        for (TrafficRegion& currRegion: mTrafficRegions)
+        {
+            if (currRegion.mOnScreenArea.contains(position))
+                break;
+
+            cxx::aabbox2d_t generationArea = currRegion.mOnScreenArea;
+            generationArea.mMax += expandDistance;
+            generationArea.mMin -= expandDistance;
+            if (!generationArea.contains(position))
+                continue;
+
+            if (!regionsPopulationCounted)
+            {
+                ComputeSpawnQuotas(gGameObjectsManager.mVehiclesList, gGameParams.mTrafficGenMaxCars, gGameParams.mTrafficGenCarsMaxDistance,
+                    0, mRegionSpawnCounts);
+                regionsPopulationCounted = true;
+            }
+
+            if (currRegion.mPopulation < currRegion.mQuota)
+            {
+                ++currRegion.mPopulation;
+                shouldPromote = true;
+            }
+            break;
+        }
+
+        if (shouldPromote && TryPromoteAbstractCar(icar))
+        {
+            mAbstractCars[icar] = mAbstractCars.back();
+            mAbstractCars.pop_back();
+            continue;
+        }
+        ++icar;
+    }
+}
+
+void TrafficManager::TryDemoteTrafficCar(Vehicle* car)
+{
+    if ((int) mAbstractCars.size() >= gGameParams.mTrafficAbstractMaxCars)
+        return;
+
+    if (car->IsMarkedForDeletion() || !car->IsTrafficFlag() || car->IsWrecked() || car->IsBurn())
+        return;
+
+    if (car->GetCarDriver() == nullptr)
+        return;
+
+    bool hasNonTrafficPassengers = cxx::contains_if(car->mPassengers, [](Pedestrian* carDriver)
+    {
+        return !carDriver->IsTrafficFlag();
+    });
+
+    if (hasNonTrafficPassengers)
+        return;
+
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+
+    glm::ivec3 carLogPos = Convert::MetersToMapUnits(car->mPhysicsBody->GetPosition());
+    int currentNode = laneGraph.GetNodeIndex(carLogPos.x, carLogPos.z, carLogPos.y);
+    if (currentNode == AiRoadLaneGraph::InvalidNodeIndex)
+        return;
+
+    // continue along lane which matches car heading the most
+    glm::vec2 carHeading = car->mPhysicsBody->GetSignVector();
+    glm::vec2 currentNodePosition = laneGraph.GetNodePosition2(currentNode);
+
+    int bestNode = AiRoadLaneGraph::InvalidNodeIndex;
+    float bestDot = -1.0f;
+
+    const int* nodeEdges = laneGraph.GetNodeEdges(currentNode);
+    for (int iedge = 0, EdgesCount = laneGraph.GetNodeEdgesCount(currentNode); iedge < EdgesCount; ++iedge)
+    {
+        glm::vec2 toNextNode = laneGraph.GetNodePosition2(nodeEdges[iedge]) - currentNodePosition;
+        float currDot = glm::dot(glm::normalize(toNextNode), carHeading);
+        if (currDot > bestDot)
+        {
+            bestDot = currDot;
+            bestNode = nodeEdges[iedge];
+        }
+    }
+
+    if (bestNode == AiRoadLaneGraph::InvalidNodeIndex)
+        return;
+
+    AbstractCar abstractCar;
+    abstractCar.mCarInfo = car->mCarInfo;
+    abstractCar.mFromNode = currentNode;
+    abstractCar.mToNode = bestNode;
+    abstractCar.mLaneProgress = 0.0f;
+    mAbstractCars.push_back(abstractCar);
+}
+
+bool TrafficManager::TryPromoteAbstractCar(int abstractCarIndex)
+{
+    const AbstractCar& abstractCar = mAbstractCars[abstractCarIndex];
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+
+    glm::vec2 fromPosition = laneGraph.GetNodePosition2(abstractCar.mFromNode);
+    glm::vec2 toPosition = laneGraph.GetNodePosition2(abstractCar.mToNode);
+    glm::vec2 position2 = glm::mix(fromPosition, toPosition, abstractCar.mLaneProgress);
+
+    // wait until lane is free
+    const float minDistance2 = glm::pow(Convert::MapUnitsToMeters(1.0f), 2.0f);
+    for (Vehicle* currVehicle: gGameObjectsManager.mVehiclesList)
+    {
+        if (glm::distance2(currVehicle->GetPosition2(), position2) < minDistance2)
+            return false;
+    }
+
+    const AiRoadLaneGraph::LaneNode& fromNode = laneGraph.mNodes[abstractCar.mFromNode];
+    glm::vec3 position (position2.x, Convert::MapUnitsToMeters(fromNode.mMapLayer * 1.0f), position2.y);
+    position.y = gGameMap.GetHeightAtPosition(position);
+
+    glm::vec2 direction = toPosition - fromPosition;
+    cxx::angle_t carHeading(glm::degrees(atan2f(direction.y, direction.x)), cxx::angle_t::units::degrees);
+
+    Vehicle* vehicle = GenerateTrafficCar(position, carHeading, abstractCar.mCarInfo);
+    return vehicle != nullptr;
+}
+
+int TrafficManager::ChooseNextLaneNode(int fromNode, int currentNode) const
+{
+    const AiRoadLaneGraph& laneGraph = gAiManager.mRoadLaneGraph;
+
+    glm::vec2 currentNodePosition = laneGraph.GetNodePosition2(currentNode);
+    glm::vec2 heading (0.0f, 0.0f);
+    if (fromNode != AiRoadLaneGraph::InvalidNodeIndex)
+    {
+        heading = glm::normalize(currentNodePosition - laneGraph.GetNodePosition2(fromNode));
+    }
+
+    int candidateNodes[4];
+    int candidatesCount = 0;
+
+    const int* nodeEdges = laneGraph.GetNodeEdges(currentNode);
+    for (int iedge = 0, EdgesCount = laneGraph.GetNodeEdgesCount(currentNode); 
+        iedge < EdgesCount && candidatesCount < CountOf(candidateNodes); ++iedge)
+    {
+        glm::vec2 toNextNode = laneGraph.GetNodePosition2(nodeEdges[iedge]) - currentNodePosition;
+        if (glm::dot(glm::normalize(toNextNode), heading) < -0.5f)
+            continue;
+
+        candidateNodes[candidatesCount++] = nodeEdges[iedge];
+    }
+
+    if (candidatesCount == 0)
+        return AiRoadLaneGraph::InvalidNodeIndex;
+
+    int chooseCandidate = gCarnageGame.mGameRand.generate_int(0, candidatesCount - 1);
+    return candidateNodes[chooseCandidate];
 }
 
 void TrafficManager::GeneratePeds()
@@ -64,15 +466,14 @@ void TrafficManager::GeneratePeds()
     if (!gGameCheatsWindow.mEnableTrafficPedsGeneration)
         return;
 
-    for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
-    {   
-        if (humanPlayer == nullptr)
-            continue;
+    ComputeSpawnQuotas(gGameObjectsManager.mPedestriansList, gGameParams.mTrafficGenMaxPeds, gGameParams.mTrafficGenPedsMaxDistance,
+        gGameParams.mTrafficGenPedsPerTurn, mRegionSpawnCounts);
 
-        int generatePedsCount = GetPedsToGenerateCount(humanPlayer->mPlayerView);
-        if (generatePedsCount > 0)
+    for (size_t iregion = 0; iregion < mTrafficRegions.size(); ++iregion)
+    {   
+        if (mRegionSpawnCounts[iregion] > 0)
         {
-            GenerateTrafficPeds(generatePedsCount, humanPlayer->mPlayerView);
+            GenerateTrafficPeds(mRegionSpawnCounts[iregion], mTrafficRegions[iregion].mOnScreenArea);
         }
     }
 }
@@ -90,26 +491,7 @@ void TrafficManager::RemoveOffscreenPeds()
         if (pedestrian->IsCarPassenger())
             continue;
 
-        bool isOnScreen = false;
-        for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
-        {   
-            if (humanPlayer == nullptr)
-                continue;
-
-            cxx::aabbox2d_t onScreenArea = humanPlayer->mPlayerView.mOnScreenArea;
-            onScreenArea.mMax.x += offscreenDistance;
-            onScreenArea.mMax.y += offscreenDistance;
-            onScreenArea.mMin.x -= offscreenDistance;
-            onScreenArea.mMin.y -= offscreenDistance;
-
-            if (pedestrian->IsOnScreen(onScreenArea))
-            {
-                isOnScreen = true;
-                break;
-            }
-        }
-
-        if (isOnScreen)
+        if (IsRelevantObject(pedestrian, offscreenDistance))
             continue;
 
         // remove ped
@@ -117,7 +499,7 @@ void TrafficManager::RemoveOffscreenPeds()
     }
 }
 
-void TrafficManager::GenerateTrafficPeds(int pedsCount, RenderView& view)
+void TrafficManager::GenerateTrafficPeds(int pedsCount, const cxx::aabbox2d_t& onScreenArea)
 {
     cxx::randomizer& random = gCarnageGame.mGameRand;
 
@@ -125,61 +507,10 @@ void TrafficManager::GenerateTrafficPeds(int pedsCount, RenderView& view)
 
     Rect innerRect;
     Rect outerRect;
-    // get map area on screen
-    {
-        Point minBlock;
-        minBlock.x = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMin.x);
-        minBlock.y = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMin.y);
-
-        Point maxBlock;
-        maxBlock.x = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMax.x) + 1;
-        maxBlock.y = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMax.y) + 1;
-
-        innerRect.x = minBlock.x;
-        innerRect.y = minBlock.y;
-        innerRect.w = (maxBlock.x - minBlock.x);
-        innerRect.h = (maxBlock.y - minBlock.y);
-
-        // expand
-        int expandSize = gGameParams.mTrafficGenPedsMaxDistance;
-        outerRect = innerRect;
-        outerRect.x -= expandSize;
-        outerRect.y -= expandSize;
-        outerRect.w += expandSize * 2;
-        outerRect.h += expandSize * 2;
-    }
+    GetTrafficGenArea(onScreenArea, gGameParams.mTrafficGenPedsMaxDistance, innerRect, outerRect);
     
     mCandidatePosArray.clear();
-
-    for (int iy = 0; iy < outerRect.h; ++iy)
-    for (int ix = 0; ix < outerRect.w; ++ix)
-    {
-        Point pos (ix + outerRect.x, iy + outerRect.y);
-        if (innerRect.PointWithin(pos))
-            continue;
-
-        // scan candidate from top
-        for (int iz = (MAP_LAYERS_COUNT - 1); iz > 0; --iz)
-        {
-            const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(pos.x, pos.y, iz);
-
-            if (mapBlock->mGroundType == eGroundType_Air)
-                continue;
-
-            if (mapBlock->mGroundType == eGroundType_Pawement)
-            {
-                if (mapBlock->mIsRailway)
-                    continue;
-
-                CandidatePos candidatePos;
-                candidatePos.mMapX = pos.x;
-                candidatePos.mMapY = pos.y;
-                candidatePos.mMapLayer = iz;
-                mCandidatePosArray.push_back(candidatePos);
-            }
-            break;
-        }
-    }
+    mPedsSpawnIndex.QueryRing(innerRect, outerRect, mCandidatePosArray);
 
     if (mCandidatePosArray.empty())
         return;
@@ -209,32 +540,6 @@ void TrafficManager::GenerateTrafficPeds(int pedsCount, RenderView& view)
     }
 }
 
-int TrafficManager::GetPedsToGenerateCount(RenderView& view) const
-{
-    int pedestriansCounter = 0;
-
-    float offscreenDistance = Convert::MapUnitsToMeters(gGameParams.mTrafficGenPedsMaxDistance * 1.0f);
-
-    cxx::aabbox2d_t onScreenArea = view.mOnScreenArea;
-    onScreenArea.mMax.x += offscreenDistance;
-    onScreenArea.mMax.y += offscreenDistance;
-    onScreenArea.mMin.x -= offscreenDistance;
-    onScreenArea.mMin.y -= offscreenDistance;
-
-    for (Pedestrian* pedestrian: gGameObjectsManager.mPedestriansList)
-    {
-        if (!pedestrian->IsTrafficFlag() || pedestrian->IsMarkedForDeletion() || pedestrian->IsCarPassenger())
-            continue;
-
-        if (pedestrian->IsOnScreen(onScreenArea))
-        {
-            ++pedestriansCounter;
-        }
-    }
-
-    return std::max(0, (gGameParams.mTrafficGenMaxPeds - pedestriansCounter));
-}
-
 int TrafficManager::CountTrafficPedestrians() const
 {
     int counter = 0;
@@ -261,32 +566,6 @@ int TrafficManager::CountTrafficCars() const
     return counter;
 }
 
-int TrafficManager::GetCarsToGenerateCount(RenderView& view) const
-{
-    int carsCounter = 0;
-
-    float offscreenDistance = Convert::MapUnitsToMeters(gGameParams.mTrafficGenCarsMaxDistance * 1.0f);
-
-    cxx::aabbox2d_t onScreenArea = view.mOnScreenArea;
-    onScreenArea.mMax.x += offscreenDistance;
-    onScreenArea.mMax.y += offscreenDistance;
-    onScreenArea.mMin.x -= offscreenDistance;
-    onScreenArea.mMin.y -= offscreenDistance;
-
-    for (Vehicle* car: gGameObjectsManager.mVehiclesList)
-    {
-        if (!car->IsTrafficFlag() || car->IsMarkedForDeletion())
-            continue;
-
-        if (car->IsOnScreen(onScreenArea))
-        {
-            ++carsCounter;
-        }
-    }
-
-    return std::max(0, (gGameParams.mTrafficGenMaxCars - carsCounter));
-}
-
 void TrafficManager::GenerateCars()
 {
     if ((mLastGenCarsTime > 0.0f) && 
@@ -302,20 +581,19 @@ void TrafficManager::GenerateCars()
     if (!gGameCheatsWindow.mEnableTrafficCarsGeneration)
         return;
 
-    for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
-    {   
-        if (humanPlayer == nullptr)
-            continue;
+    ComputeSpawnQuotas(gGameObjectsManager.mVehiclesList, gGameParams.mTrafficGenMaxCars, gGameParams.mTrafficGenCarsMaxDistance,
+        gGameParams.mTrafficGenCarsPerTurn, mRegionSpawnCounts);
 
-        int generateCarsCount = GetCarsToGenerateCount(humanPlayer->mPlayerView);
-        if (generateCarsCount > 0)
+    for (size_t iregion = 0; iregion < mTrafficRegions.size(); ++iregion)
+    {   
+        if (mRegionSpawnCounts[iregion] > 0)
         {
-            GenerateTrafficCars(generateCarsCount, humanPlayer->mPlayerView);
+            GenerateTrafficCars(mRegionSpawnCounts[iregion], mTrafficRegions[iregion].mOnScreenArea);
         }
     }
 }
 
-void TrafficManager::GenerateTrafficCars(int carsCount, RenderView& view)
+void TrafficManager::GenerateTrafficCars(int carsCount, const cxx::aabbox2d_t& onScreenArea)
 {
     cxx::randomizer& random = gCarnageGame.mGameRand;
 
@@ -323,66 +601,10 @@ void TrafficManager::GenerateTrafficCars(int carsCount, RenderView& view)
 
     Rect innerRect;
     Rect outerRect;
-    // get map area on screen
-    {
-        Point minBlock;
-        minBlock.x = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMin.x);
-        minBlock.y = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMin.y);
-
-        Point maxBlock;
-        maxBlock.x = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMax.x) + 1;
-        maxBlock.y = (int) Convert::MetersToMapUnits(view.mOnScreenArea.mMax.y) + 1;
-
-        innerRect.x = minBlock.x;
-        innerRect.y = minBlock.y;
-        innerRect.w = (maxBlock.x - minBlock.x);
-        innerRect.h = (maxBlock.y - minBlock.y);
-
-        // expand
-        int expandSize = gGameParams.mTrafficGenCarsMaxDistance;
-        outerRect = innerRect;
-        outerRect.x -= expandSize;
-        outerRect.y -= expandSize;
-        outerRect.w += expandSize * 2;
-        outerRect.h += expandSize * 2;
-    }
+    GetTrafficGenArea(onScreenArea, gGameParams.mTrafficGenCarsMaxDistance, innerRect, outerRect);
     
     mCandidatePosArray.clear();
-
-    for (int iy = 0; iy < outerRect.h; ++iy)
-    for (int ix = 0; ix < outerRect.w; ++ix)
-    {
-        Point pos (ix + outerRect.x, iy + outerRect.y);
-        if (innerRect.PointWithin(pos))
-            continue;
-
-        // scan candidate from top
-        for (int iz = (MAP_LAYERS_COUNT - 1); iz > 0; --iz)
-        {
-            const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(pos.x, pos.y, iz);
-
-            if (mapBlock->mGroundType == eGroundType_Air)
-                continue;
-
-            if (mapBlock->mGroundType == eGroundType_Road)
-            {
-                int bits = (int) (mapBlock->mDownDirection) + 
-                    (int) (mapBlock->mUpDirection) +
-                    (int) (mapBlock->mLeftDirection) + 
-                    (int) (mapBlock->mRightDirection);
-
-                if ((bits == 0 || bits > 1) || mapBlock->mIsRailway)
-                    continue;
-
-                CandidatePos candidatePos;
-                candidatePos.mMapX = pos.x;
-                candidatePos.mMapY = pos.y;
-                candidatePos.mMapLayer = iz;
-                mCandidatePosArray.push_back(candidatePos);
-            }
-            break;
-        }
-    }
+    mCarsSpawnIndex.QueryRing(innerRect, outerRect, mCandidatePosArray);
 
     if (mCandidatePosArray.empty())
         return;
@@ -411,28 +633,10 @@ void TrafficManager::RemoveOffscreenCars()
         if (currentCar->IsMarkedForDeletion() || !currentCar->IsTrafficFlag())
             continue;
 
-        bool isOnScreen = false;
-        for (HumanPlayer* humanPlayer: gCarnageGame.mHumanPlayers)
-        {   
-            if (humanPlayer == nullptr)
-                continue;
-
-            cxx::aabbox2d_t onScreenArea = humanPlayer->mPlayerView.mOnScreenArea;
-            onScreenArea.mMax.x += offscreenDistance;
-            onScreenArea.mMax.y += offscreenDistance;
-            onScreenArea.mMin.x -= offscreenDistance;
-            onScreenArea.mMin.y -= offscreenDistance;
-
-            if (currentCar->IsOnScreen(onScreenArea))
-            {
-                isOnScreen = true;
-                break;
-            }
-        }
-
-        if (isOnScreen)
+        if (IsRelevantObject(currentCar, offscreenDistance))
             continue;
 
+        TryDemoteTrafficCar(currentCar);
         TryRemoveTrafficCar(currentCar);
     }
 }
@@ -465,7 +669,31 @@ Vehicle* TrafficManager::GenerateRandomTrafficCar(int posx, int posy, int posz)
     cxx::angle_t carHeading(turnAngle, cxx::angle_t::units::degrees);
     positions.y = gGameMap.GetHeightAtPosition(positions);
 
-    // choose car model
+    VehicleInfo* carInfo = ChooseRandomTrafficCarModel();
+    if (carInfo == nullptr)
+        return nullptr;
+
+    return GenerateTrafficCar(positions, carHeading, carInfo);
+}
+
+Vehicle* TrafficManager::GenerateTrafficCar(const glm::vec3& position, cxx::angle_t heading, VehicleInfo* carInfo)
+{
+    Vehicle* vehicle = gGameObjectsManager.CreateVehicle(position, heading, carInfo);
+    debug_assert(vehicle);
+    if (vehicle)
+    {
+        vehicle->mFlags = (vehicle->mFlags | eGameObjectFlags_Traffic);
+        // todo: remap
+
+        Pedestrian* carDriver = GenerateRandomTrafficCarDriver(vehicle);
+        debug_assert(carDriver);
+    }
+
+    return vehicle;
+}
+
+VehicleInfo* TrafficManager::ChooseRandomTrafficCarModel() const
+{
     std::vector<VehicleInfo*> models;
     for(VehicleInfo& currModel: gGameMap.mStyleData.mVehicles)
     {
@@ -488,21 +716,8 @@ Vehicle* TrafficManager::GenerateRandomTrafficCar(int posx, int posy, int posz)
     if (models.empty())
         return nullptr;
 
-    // shuffle candidates
-    gCarnageGame.mGameRand.shuffle(models);
-
-    Vehicle* vehicle = gGameObjectsManager.CreateVehicle(positions, carHeading, models.front());
-    debug_assert(vehicle);
-    if (vehicle)
-    {
-        vehicle->mFlags = (vehicle->mFlags | eGameObjectFlags_Traffic);
-        // todo: remap
-
-        Pedestrian* carDriver = GenerateRandomTrafficCarDriver(vehicle);
-        debug_assert(carDriver);
-    }
-
-    return vehicle;
+    int chooseModel = gCarnageGame.mGameRand.generate_int(0, (int) models.size() - 1);
+    return models[chooseModel];
 }
 
 Pedestrian* TrafficManager::GenerateRandomTrafficPedestrian(int posx, int posy, int posz)
@@ -638,4 +853,153 @@ bool TrafficManager::TryRemoveTrafficPed(Pedestrian* pedestrian)
         
     pedestrian->MarkForDeletion();
     return true;
+}
+
+void TrafficManager::GetTrafficGenArea(const cxx::aabbox2d_t& onScreenArea, int expandSize, Rect& innerRect, Rect& outerRect) const
+{
+    Point minBlock;
+    minBlock.x = (int) Convert::MetersToMapUnits(onScreenArea.mMin.x);
+    minBlock.y = (int) Convert::MetersToMapUnits(onScreenArea.mMin.y);
+
+    Point maxBlock;
+    maxBlock.x = (int) Convert::MetersToMapUnits(onScreenArea.mMax.x) + 1;
+    maxBlock.y = (int) Convert::MetersToMapUnits(onScreenArea.mMax.y) + 1;
+
+    innerRect.x = minBlock.x;
+    innerRect.y = minBlock.y;
+    innerRect.w = (maxBlock.x - minBlock.x);
+    innerRect.h = (maxBlock.y - minBlock.y);
+
+    // expand
+    outerRect = innerRect;
+    outerRect.x -= expandSize;
+    outerRect.y -= expandSize;
+    outerRect.w += expandSize * 2;
+    outerRect.h += expandSize * 2;
+}
+
+void TrafficManager::BuildSpawnCandidatesIndex()
+{
+    mCarsSpawnIndex.Clear();
+    mPedsSpawnIndex.Clear();
+
+    for (int iy = 0; iy < MAP_DIMENSIONS; ++iy)
+    {
+        mCarsSpawnIndex.mRowStart[iy] = (int) mCarsSpawnIndex.mCandidates.size();
+        mPedsSpawnIndex.mRowStart[iy] = (int) mPedsSpawnIndex.mCandidates.size();
+
+        for (int ix = 0; ix < MAP_DIMENSIONS; ++ix)
+        {
+            // scan pedestrians candidate from top
+            for (int iz = (MAP_LAYERS_COUNT - 1); iz > 0; --iz)
+            {
+                const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(ix, iy, iz);
+
+                if (mapBlock->mGroundType == eGroundType_Air)
+                    continue;
+
+                if (mapBlock->mGroundType == eGroundType_Pawement)
+                {
+                    if (mapBlock->mIsRailway)
+                        continue;
+
+                    CandidatePos candidatePos;
+                    candidatePos.mMapX = ix;
+                    candidatePos.mMapY = iy;
+                    candidatePos.mMapLayer = iz;
+                    mPedsSpawnIndex.mCandidates.push_back(candidatePos);
+                }
+                break;
+            }
+
+            // scan cars candidate from top
+            for (int iz = (MAP_LAYERS_COUNT - 1); iz > 0; --iz)
+            {
+                const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(ix, iy, iz);
+
+                if (mapBlock->mGroundType == eGroundType_Air)
+                    continue;
+
+                if (mapBlock->mGroundType == eGroundType_Road)
+                {
+                    // single direction road blocks only
+                    int bits = (int) (mapBlock->mDownDirection) + 
+                        (int) (mapBlock->mUpDirection) +
+                        (int) (mapBlock->mLeftDirection) + 
+                        (int) (mapBlock->mRightDirection);
+
+                    if ((bits == 0 || bits > 1) || mapBlock->mIsRailway)
+                        continue;
+
+                    CandidatePos candidatePos;
+                    candidatePos.mMapX = ix;
+                    candidatePos.mMapY = iy;
+                    candidatePos.mMapLayer = iz;
+                    mCarsSpawnIndex.mCandidates.push_back(candidatePos);
+                }
+                break;
+            }
+        }
+    }
+
+    mCarsSpawnIndex.mRowStart[MAP_DIMENSIONS] = (int) mCarsSpawnIndex.mCandidates.size();
+    mPedsSpawnIndex.mRowStart[MAP_DIMENSIONS] = (int) mPedsSpawnIndex.mCandidates.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void TrafficManager::SpawnCandidatesIndex::Clear()
+{
+    mCandidates.clear();
+    for (int& rowStart: mRowStart)
+    {
+        rowStart = 0;
+    }
+}
+
+void TrafficManager::SpawnCandidatesIndex::QueryRing(const Rect& innerRect, const Rect& outerRect, std::vector<CandidatePos>& outputCandidates) const
+{
+    const int minY = std::max(outerRect.y, 0);
+    const int maxY = std::min(outerRect.y + outerRect.h, MAP_DIMENSIONS); // exclusive
+    const int minX = outerRect.x;
+    const int maxX = outerRect.x + outerRect.w; // exclusive
+
+    auto CompareX = [](const CandidatePos& candidate, int mapx)
+    {
+        return candidate.mMapX < mapx;
+    };
+
+    for (int iy = minY; iy < maxY; ++iy)
+    {
+        auto rowBegin = mCandidates.begin() + mRowStart[iy];
+        auto rowEnd = mCandidates.begin() + mRowStart[iy + 1];
+        if (rowBegin == rowEnd)
+            continue;
+
+        // skip inner area span on rows that intersects it
+        int skipMinX = maxX;
+        int skipMaxX = maxX;
+        if (iy >= innerRect.y && iy < (innerRect.y + innerRect.h))
+        {
+            skipMinX = innerRect.x;
+            skipMaxX = innerRect.x + innerRect.w;
+        }
+
+        for (auto iter = std::lower_bound(rowBegin, rowEnd, minX, CompareX); iter != rowEnd; ++iter)
+        {
+            if (iter->mMapX >= maxX)
+                break;
+
+            if (iter->mMapX >= skipMinX && iter->mMapX < skipMaxX)
+            {
+                iter = std::lower_bound(iter, rowEnd, skipMaxX, CompareX);
+                if (iter == rowEnd)
+                    break;
+
+                if (iter->mMapX >= maxX)
+                    break;
+            }
+            outputCandidates.push_back(*iter);
+        }
+    }
 }
\ No newline at end of file
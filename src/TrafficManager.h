@@ -1,7 +1,6 @@
 #pragma once
 
 class DebugRenderer;
-class RenderView;
 
 // This class generates randomly wander pedestrians and vehicles on currently visible area on map
 class TrafficManager final: public cxx::noncopyable
@@ -21,35 +20,94 @@ public:
     int CountTrafficPedestrians() const;
     int CountTrafficCars() const;
 
+    // Test whether game object is located within map area visible by any human player,
+    // relevant areas are updated once per frame
+    // @param gameObject: Object to test
+    // @param expandDistance: Extra distance around visible areas, meters
+    bool IsRelevantObject(const GameObject* gameObject, float expandDistance) const;
+
 private:
+    // map area visible by one or more human players, overlapping player views are merged together
+    struct TrafficRegion
+    {
+    public:
+        cxx::aabbox2d_t mOnScreenArea; // meters
+        int mViewsCount = 0;
+        int mPopulation = 0; // current number of traffic objects within area
+        int mQuota = 0; // max number of traffic objects within area
+    };
+
+    void UpdateTrafficRegions();
+
+    // count traffic objects within regions and distribute spawn budget between them
+    // @param objectsList: Traffic pedestrians or vehicles
+    // @param maxObjectsPerView: Population limit for single player view
+    // @param maxDistance: Distance around visible areas where objects are counted, blocks
+    // @param spawnBudget: Max number of objects generated on current turn
+    // @param outputSpawnCounts: Number of objects to generate for each region
+    template<typename TObjectClass>
+    void ComputeSpawnQuotas(const std::vector<TObjectClass*>& objectsList, int maxObjectsPerView, int maxDistance,
+        int spawnBudget, std::vector<int>& outputSpawnCounts);
+
     // traffic pedestrians generation
     void GeneratePeds();
-    void GenerateTrafficPeds(int pedsCount, RenderView& view);
+    void GenerateTrafficPeds(int pedsCount, const cxx::aabbox2d_t& onScreenArea);
     void RemoveOffscreenPeds();
-    int GetPedsToGenerateCount(RenderView& view) const;
 
     // traffic cars generation
     void GenerateCars();
-    void GenerateTrafficCars(int carsCount, RenderView& view);
+    void GenerateTrafficCars(int carsCount, const cxx::aabbox2d_t& onScreenArea);
     void RemoveOffscreenCars();
-    int GetCarsToGenerateCount(RenderView& view) const;
+
+    // off-screen traffic cars simulation
+    void SeedAbstractCars();
+    void UpdateAbstractCars();
+    // try to keep traffic car simulated along road lanes when it gets removed from view
+    void TryDemoteTrafficCar(Vehicle* car);
+    // create physical car from abstract one
+    bool TryPromoteAbstractCar(int abstractCarIndex);
+    // choose random outgoing lane, but never turn back
+    int ChooseNextLaneNode(int fromNode, int currentNode) const;
 
     // traffic objects generation
     Pedestrian* GenerateRandomTrafficCarDriver(Vehicle* vehicle);
     Pedestrian* GenerateRandomTrafficPedestrian(int posx, int posy, int posz);
     Pedestrian* GenerateHareKrishnas(int posx, int posy, int posz);
     Vehicle* GenerateRandomTrafficCar(int posx, int posy, int posz);
+    Vehicle* GenerateTrafficCar(const glm::vec3& position, cxx::angle_t heading, VehicleInfo* carInfo);
+    VehicleInfo* ChooseRandomTrafficCarModel() const;
 
     // attempt to remove traffic pedestrian or vehicle
     bool TryRemoveTrafficPed(Pedestrian* ped);
     bool TryRemoveTrafficCar(Vehicle* car);
 
+    // scan map blocks and collect all valid spawn positions for traffic cars and pedestrians
+    void BuildSpawnCandidatesIndex();
+
+    // get map area on screen and expanded area around it, map units
+    void GetTrafficGenArea(const cxx::aabbox2d_t& onScreenArea, int expandSize, Rect& innerRect, Rect& outerRect) const;
+
 private:
     float mLastGenPedsTime = 0.0;
     float mLastGenCarsTime = 0.0f;
     float mLastGenHareKrishnasTime = 0.0f;
 
+    std::vector<TrafficRegion> mTrafficRegions;
+    float mAverageViewArea = 0.0f; // square meters
+
+    // traffic car outside of players view, moves along road lanes without physics
+    struct AbstractCar
+    {
+    public:
+        VehicleInfo* mCarInfo = nullptr;
+        int mFromNode = 0;
+        int mToNode = 0;
+        float mLaneProgress = 0.0f; // position between lane nodes, 0 to 1
+    };
+    std::vector<AbstractCar> mAbstractCars;
+
     // buffers
+    std::vector<int> mRegionSpawnCounts;
     struct CandidatePos
     {
         int mMapX;
@@ -57,6 +115,25 @@ private:
         int mMapLayer;
     };
     std::vector<CandidatePos> mCandidatePosArray;
+
+    // spawn positions sorted by row and then by column
+    struct SpawnCandidatesIndex
+    {
+    public:
+        void Clear();
+
+        // add candidates located within outer area but outside of inner area to output list
+        // @param innerRect, outerRect: Area, map units
+        // @param outputCandidates: Output list, will not be cleared
+        void QueryRing(const Rect& innerRect, const Rect& outerRect, std::vector<CandidatePos>& outputCandidates) const;
+
+    public:
+        std::vector<CandidatePos> mCandidates;
+        // first candidate index for each map row, last element is total candidates count
+        int mRowStart[MAP_DIMENSIONS + 1];
+    };
+    SpawnCandidatesIndex mCarsSpawnIndex;
+    SpawnCandidatesIndex mPedsSpawnIndex;
 };
 
 extern TrafficManager gTrafficManager;
\ No newline at end of file
@@ -80,7 +80,7 @@ bool Weapon::Fire(Pedestrian* shooter)
 
         if (weaponInfo->mShotSound != -1)
         {
-            gAudioManager.PlaySfxLevel(weaponInfo->mShotSound, projectilePos, false);
+            gAudioManager.PlaySfxLevel(weaponInfo->mShotSound, projectilePos, false, eSfxPriority_High);
         }
 
         // broardcast event
@@ -1,7 +1,7 @@
 #include "stdafx.h"
 #include "WeaponInfo.h"
 
-bool WeaponInfo::SetupFromConfg(cxx::json_document_node configNode)
+bool WeaponInfo::SetupFromConfg(cxx::json_reader_node configNode)
 {
     Clear();
 
@@ -38,15 +38,17 @@ bool WeaponInfo::SetupFromConfg(cxx::json_document_node configNode)
         cxx::json_get_attribute(configNode, "projectile_hit_object_sfx", mProjectileHitObjectSound);
 
         // read projectile offsets
-        if (cxx::json_node_array offsetsNode = configNode["projectile_offset"])
+        cxx::json_reader_node offsetsNode = configNode["projectile_offset"];
+        if (offsetsNode.is_array())
         {
-            for (cxx::json_node_object currOffsetNode = offsetsNode.first_child();
+            for (cxx::json_reader_node currOffsetNode = offsetsNode.first_child();
                 currOffsetNode; currOffsetNode = currOffsetNode.next_sibling())
             {
                 ProjectileOffset projectileOffset;
                 if (cxx::json_get_attribute(currOffsetNode, "anim", projectileOffset.mAnimationID))
                 {
-                    if (cxx::json_node_array pxNode = currOffsetNode["px"])
+                    cxx::json_reader_node pxNode = currOffsetNode["px"];
+                    if (pxNode.is_array())
                     {
                         int pixels_x = 0;
                         int pixels_y = 0;
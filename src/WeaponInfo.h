@@ -9,7 +9,7 @@ public:
     WeaponInfo() = default;
 
     // Load weapon info from json node
-    bool SetupFromConfg(cxx::json_document_node configNode);
+    bool SetupFromConfg(cxx::json_reader_node configNode);
 
     // Reset weapon info to default state
     void Clear();
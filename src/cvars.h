@@ -8,6 +8,10 @@
 
 //////////////////////////////////////////////////////////////////////////
 
+// console
+extern CvarString gCvarConsoleLogFile; // write console messages to file
+extern CvarInt gCvarConsoleRateLimit; // max messages per second for each category
+
 // graphics
 extern CvarPoint gCvarGraphicsScreenDims; // screen dimensions
 extern CvarBoolean gCvarGraphicsFullscreen; // is fullscreen mode enabled
@@ -16,15 +20,29 @@ extern CvarBoolean gCvarGraphicsTexFiltering; // is texture filtering enabled
 
 // physics
 extern CvarFloat gCvarPhysicsFramerate; // physical world update framerate
+extern CvarInt gCvarPhysicsMaxSteps; // max simulation steps per frame, remaining time gets dropped
+extern CvarBoolean gCvarPhysicsAdaptiveStep; // stretch simulation step under high load
+extern CvarFloat gCvarPhysicsMinFramerate; // lowest physical world update framerate for adaptive step
 
 // memory
 extern CvarBoolean gCvarMemEnableFrameHeapAllocator; // enable frame heap allocator
+extern CvarCommand gCvarMemSnapshot; // take named memory snapshot
+extern CvarCommand gCvarMemDiff; // print difference between two memory snapshots
 
 // audio
 extern CvarBoolean gCvarAudioActive; // enable audio system
+extern CvarFloat gCvarAudioHearingDistance; // distance after which sounds are not heard, meters
+
+// ai
+extern CvarInt gCvarAiPathBudget; // max pathfinding search nodes processed per frame
+extern CvarInt gCvarAiPathCacheSize; // max number of cached path segments between portals
+extern CvarInt gCvarAiUpdateBudget; // max time spent on ai controllers update per frame, microseconds
 
 // game
 extern CvarString gCvarGtaDataPath; // config gta data location
+extern CvarString gCvarPackFile; // game data pack file to mount
+extern CvarBoolean gCvarUseCompiledEntities; // load entity definitions from binary blobs
+extern CvarCommand gCvarCompileEntities; // compile entity definitions to binary blobs
 extern CvarString gCvarMapname; // current map name
 extern CvarString gCvarCurrentBaseDir; // current gta data location
 extern CvarEnum<eGtaGameVersion> gCvarGameVersion; // current gta game version
@@ -37,14 +55,28 @@ extern CvarEnum<eWeatherEffect> gCvarWeatherEffect; // currently active weather
 
 inline void CvarsRegisterGlobal()
 {
+    gConsole.RegisterVariable(&gCvarConsoleLogFile);
+    gConsole.RegisterVariable(&gCvarConsoleRateLimit);
     gConsole.RegisterVariable(&gCvarGraphicsScreenDims);
     gConsole.RegisterVariable(&gCvarGraphicsFullscreen);
     gConsole.RegisterVariable(&gCvarGraphicsVSync);
     gConsole.RegisterVariable(&gCvarGraphicsTexFiltering);
     gConsole.RegisterVariable(&gCvarPhysicsFramerate);
+    gConsole.RegisterVariable(&gCvarPhysicsMaxSteps);
+    gConsole.RegisterVariable(&gCvarPhysicsAdaptiveStep);
+    gConsole.RegisterVariable(&gCvarPhysicsMinFramerate);
     gConsole.RegisterVariable(&gCvarMemEnableFrameHeapAllocator);
+    gConsole.RegisterVariable(&gCvarMemSnapshot);
+    gConsole.RegisterVariable(&gCvarMemDiff);
     gConsole.RegisterVariable(&gCvarAudioActive);
+    gConsole.RegisterVariable(&gCvarAudioHearingDistance);
+    gConsole.RegisterVariable(&gCvarAiPathBudget);
+    gConsole.RegisterVariable(&gCvarAiPathCacheSize);
+    gConsole.RegisterVariable(&gCvarAiUpdateBudget);
     gConsole.RegisterVariable(&gCvarGtaDataPath);
+    gConsole.RegisterVariable(&gCvarPackFile);
+    gConsole.RegisterVariable(&gCvarUseCompiledEntities);
+    gConsole.RegisterVariable(&gCvarCompileEntities);
     gConsole.RegisterVariable(&gCvarMapname);
     gConsole.RegisterVariable(&gCvarCurrentBaseDir);
     gConsole.RegisterVariable(&gCvarGameVersion);
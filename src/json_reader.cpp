@@ -0,0 +1,655 @@
+#include "stdafx.h"
+#include "json_reader.h"
+
+namespace cxx
+{
+
+// binary blob layout: header, nodes, strings
+// header: signature, version, nodes count, strings length, source length, source hash
+static const unsigned int JsonBlobSignature = 0x4A443343; // 'C3DJ'
+static const unsigned int JsonBlobVersion = 2;
+static const unsigned int JsonBlobHeaderSize = 24;
+
+static const int JsonMaxDepth = 128;
+static const int JsonMaxNumberLength = 64;
+
+//////////////////////////////////////////////////////////////////////////
+
+json_reader_node::json_reader_node(const json_reader* reader, unsigned int nodeIndex)
+    : mReader(reader)
+    , mNodeIndex(nodeIndex)
+{
+}
+
+json_reader_node json_reader_node::next_sibling() const
+{
+    if (mReader == nullptr)
+        return json_reader_node {};
+
+    unsigned int siblingIndex = mReader->mNodes[mNodeIndex].mNextSibling;
+    if (siblingIndex == 0)
+        return json_reader_node {};
+
+    return json_reader_node { mReader, siblingIndex };
+}
+
+json_reader_node json_reader_node::first_child() const
+{
+    if (mReader == nullptr)
+        return json_reader_node {};
+
+    unsigned int childIndex = mReader->mNodes[mNodeIndex].mFirstChild;
+    if (childIndex == 0)
+        return json_reader_node {};
+
+    return json_reader_node { mReader, childIndex };
+}
+
+json_reader_node json_reader_node::operator [] (const std::string& name) const
+{
+    return find_child(name.c_str(), name.length());
+}
+
+json_reader_node json_reader_node::operator [] (const char* name) const
+{
+    debug_assert(name);
+    return find_child(name, strlen(name));
+}
+
+json_reader_node json_reader_node::find_child(const char* name, size_t nameLength) const
+{
+    if (!is_object())
+        return json_reader_node {};
+
+    for (unsigned int childIndex = mReader->mNodes[mNodeIndex].mFirstChild; childIndex; )
+    {
+        const json_reader::node_data& childNode = mReader->mNodes[childIndex];
+        if (childNode.mNameLength == nameLength &&
+            memcmp(mReader->mStrings.data() + childNode.mNameOffset, name, nameLength) == 0)
+        {
+            return json_reader_node { mReader, childIndex };
+        }
+        childIndex = childNode.mNextSibling;
+    }
+    return json_reader_node {};
+}
+
+json_reader_node json_reader_node::operator [] (int elementIndex) const
+{
+    if (elementIndex < 0 || elementIndex >= get_elements_count())
+        return json_reader_node {};
+
+    unsigned int childIndex = mReader->mNodes[mNodeIndex].mFirstChild;
+    for (int icurr = 0; icurr < elementIndex; ++icurr)
+    {
+        childIndex = mReader->mNodes[childIndex].mNextSibling;
+    }
+    return json_reader_node { mReader, childIndex };
+}
+
+int json_reader_node::get_elements_count() const
+{
+    if (is_array() || is_object())
+        return (int) mReader->mNodes[mNodeIndex].mChildrenCount;
+
+    return 0;
+}
+
+const char* json_reader_node::get_element_name() const
+{
+    if (mReader == nullptr)
+        return "";
+
+    return mReader->mStrings.data() + mReader->mNodes[mNodeIndex].mNameOffset;
+}
+
+json_reader_node_type json_reader_node::get_type() const
+{
+    if (mReader == nullptr)
+        return json_reader_node_type_null;
+
+    return (json_reader_node_type) mReader->mNodes[mNodeIndex].mType;
+}
+
+bool json_reader_node::get_value(bool& output) const
+{
+    if (!is_boolean())
+        return false;
+
+    output = mReader->mNodes[mNodeIndex].mNumber != 0.0;
+    return true;
+}
+
+bool json_reader_node::get_value(int& output) const
+{
+    if (!is_number())
+        return false;
+
+    // same conversion as cJSON valueint
+    double numberValue = mReader->mNodes[mNodeIndex].mNumber;
+    if (numberValue >= INT_MAX)
+    {
+        output = INT_MAX;
+    }
+    else if (numberValue <= (double) INT_MIN)
+    {
+        output = INT_MIN;
+    }
+    else
+    {
+        output = (int) numberValue;
+    }
+    return true;
+}
+
+bool json_reader_node::get_value(float& output) const
+{
+    if (!is_number())
+        return false;
+
+    output = (float) mReader->mNodes[mNodeIndex].mNumber;
+    return true;
+}
+
+bool json_reader_node::get_value(std::string& output) const
+{
+    if (!is_string())
+        return false;
+
+    const json_reader::node_data& node = mReader->mNodes[mNodeIndex];
+    output.assign(mReader->mStrings.data() + node.mStringOffset, node.mStringLength);
+    return true;
+}
+
+const char* json_reader_node::get_value_cstr() const
+{
+    if (!is_string())
+        return nullptr;
+
+    return mReader->mStrings.data() + mReader->mNodes[mNodeIndex].mStringOffset;
+}
+
+int json_reader_node::get_value_length() const
+{
+    if (!is_string())
+        return 0;
+
+    return (int) mReader->mNodes[mNodeIndex].mStringLength;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool json_get_attribute(json_reader_node json_node, const char* attribute_name, bool& output)
+{
+    return json_node[attribute_name].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, const char* attribute_name, std::string& output)
+{
+    return json_node[attribute_name].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, const char* attribute_name, int& output)
+{
+    return json_node[attribute_name].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, const char* attribute_name, float& output)
+{
+    return json_node[attribute_name].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, int item_index, bool& output)
+{
+    return json_node[item_index].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, int item_index, std::string& output)
+{
+    return json_node[item_index].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, int item_index, int& output)
+{
+    return json_node[item_index].get_value(output);
+}
+
+bool json_get_attribute(json_reader_node json_node, int item_index, float& output)
+{
+    return json_node[item_index].get_value(output);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool json_reader::parse_document(const std::string& content)
+{
+    return parse_document(content.c_str(), content.length());
+}
+
+bool json_reader::parse_document(const char* content, size_t contentLength)
+{
+    close_document();
+
+    if (content == nullptr)
+        return false;
+
+    // escaped strings never grow when unescaped
+    mStrings.reserve(contentLength + 1);
+    mStrings.push_back(0); // shared empty string
+
+    mCursor = content;
+    mContentEnd = content + contentLength;
+    mDepth = 0;
+    mSourceLength = contentLength;
+    mSourceHash = compute_source_hash(content, contentLength);
+
+    // skip utf-8 bom
+    if (contentLength > 2 && memcmp(content, "\xEF\xBB\xBF", 3) == 0)
+    {
+        mCursor += 3;
+    }
+
+    unsigned int rootIndex = add_node();
+    bool isSuccess = parse_value(rootIndex);
+    if (isSuccess)
+    {
+        skip_whitespaces();
+        isSuccess = (mCursor == mContentEnd);
+    }
+
+    mCursor = nullptr;
+    mContentEnd = nullptr;
+
+    if (!isSuccess)
+    {
+        close_document();
+        return false;
+    }
+    return true;
+}
+
+bool json_reader::load_binary(const void* blobData, size_t blobLength)
+{
+    close_document();
+
+    if (blobData == nullptr || blobLength < JsonBlobHeaderSize)
+        return false;
+
+    unsigned int header[6];
+    memcpy(header, blobData, JsonBlobHeaderSize);
+    if (header[0] != JsonBlobSignature || header[1] != JsonBlobVersion)
+        return false;
+
+    const size_t nodesCount = header[2];
+    const size_t stringsLength = header[3];
+    if (nodesCount == 0 || stringsLength == 0 ||
+        (JsonBlobHeaderSize + nodesCount * sizeof(node_data) + stringsLength) != blobLength)
+    {
+        return false;
+    }
+
+    const unsigned char* nodesData = (const unsigned char*) blobData + JsonBlobHeaderSize;
+    mNodes.resize(nodesCount);
+    memcpy(mNodes.data(), nodesData, nodesCount * sizeof(node_data));
+
+    const unsigned char* stringsData = nodesData + nodesCount * sizeof(node_data);
+    mStrings.assign(stringsData, stringsData + stringsLength);
+
+    // validate references so that broken blob cannot cause out of bounds access
+    // children and siblings always follow node, which also rules out cycles
+    bool isValid = (mStrings.back() == 0);
+    for (size_t inode = 0; inode < nodesCount && isValid; ++inode)
+    {
+        const node_data& currNode = mNodes[inode];
+        isValid = (currNode.mType <= json_reader_node_type_object) &&
+            (currNode.mFirstChild < nodesCount) && (currNode.mNextSibling < nodesCount) &&
+            (currNode.mFirstChild == 0 || currNode.mFirstChild > inode) &&
+            (currNode.mNextSibling == 0 || currNode.mNextSibling > inode) &&
+            ((size_t) currNode.mNameOffset + currNode.mNameLength < stringsLength) &&
+            ((size_t) currNode.mStringOffset + currNode.mStringLength < stringsLength) &&
+            ((currNode.mFirstChild == 0) == (currNode.mChildrenCount == 0));
+    }
+
+    if (!isValid)
+    {
+        close_document();
+        return false;
+    }
+    mSourceLength = header[4];
+    mSourceHash = header[5];
+    return true;
+}
+
+void json_reader::save_binary(std::vector<unsigned char>& outputData) const
+{
+    outputData.clear();
+
+    if (mNodes.empty())
+        return;
+
+    const unsigned int header[6] =
+    {
+        JsonBlobSignature,
+        JsonBlobVersion,
+        (unsigned int) mNodes.size(),
+        (unsigned int) mStrings.size(),
+        (unsigned int) mSourceLength,
+        mSourceHash
+    };
+    outputData.resize(JsonBlobHeaderSize + mNodes.size() * sizeof(node_data) + mStrings.size());
+
+    unsigned char* outputPointer = outputData.data();
+    memcpy(outputPointer, header, JsonBlobHeaderSize);
+    outputPointer += JsonBlobHeaderSize;
+    memcpy(outputPointer, mNodes.data(), mNodes.size() * sizeof(node_data));
+    outputPointer += mNodes.size() * sizeof(node_data);
+    memcpy(outputPointer, mStrings.data(), mStrings.size());
+}
+
+void json_reader::close_document()
+{
+    mNodes.clear();
+    mStrings.clear();
+    mSourceLength = 0;
+    mSourceHash = 0;
+}
+
+unsigned int json_reader::compute_source_hash(const char* content, size_t contentLength)
+{
+    // fnv-1a
+    unsigned int hashValue = 2166136261U;
+    for (size_t icurr = 0; icurr < contentLength; ++icurr)
+    {
+        hashValue ^= (unsigned char) content[icurr];
+        hashValue *= 16777619U;
+    }
+    return hashValue;
+}
+
+json_reader_node json_reader::get_root_node() const
+{
+    if (mNodes.empty())
+        return json_reader_node {};
+
+    return json_reader_node { this, 0 };
+}
+
+unsigned int json_reader::add_node()
+{
+    unsigned int nodeIndex = (unsigned int) mNodes.size();
+    mNodes.emplace_back();
+    return nodeIndex;
+}
+
+void json_reader::skip_whitespaces()
+{
+    for (;;)
+    {
+        while (mCursor < mContentEnd && (unsigned char) *mCursor <= 32)
+        {
+            ++mCursor;
+        }
+
+        // skip oneline comment, same as config documents
+        if ((mContentEnd - mCursor) > 1 && mCursor[0] == '/' && mCursor[1] == '/')
+        {
+            while (mCursor < mContentEnd && *mCursor++ != '\n') {}
+            continue;
+        }
+        break;
+    }
+}
+
+bool json_reader::parse_literal(const char* literal)
+{
+    size_t literalLength = strlen(literal);
+    if ((size_t) (mContentEnd - mCursor) < literalLength || memcmp(mCursor, literal, literalLength) != 0)
+        return false;
+
+    mCursor += literalLength;
+    return true;
+}
+
+bool json_reader::parse_value(unsigned int nodeIndex)
+{
+    skip_whitespaces();
+    if (mCursor == mContentEnd)
+        return false;
+
+    // nodes array might be reallocated while parsing children, so node is accessed by index
+    switch (*mCursor)
+    {
+        case '{':
+        case '[':
+        {
+            const bool isObject = (*mCursor == '{');
+            const char closingChar = isObject ? '}' : ']';
+
+            if (++mDepth > JsonMaxDepth)
+                return false;
+
+            mNodes[nodeIndex].mType = isObject ? json_reader_node_type_object : json_reader_node_type_array;
+            ++mCursor;
+            skip_whitespaces();
+            if (mCursor < mContentEnd && *mCursor == closingChar)
+            {
+                ++mCursor;
+                --mDepth;
+                return true;
+            }
+
+            unsigned int prevChildIndex = 0;
+            for (;;)
+            {
+                unsigned int nameOffset = 0;
+                unsigned int nameLength = 0;
+                if (isObject)
+                {
+                    skip_whitespaces();
+                    if (mCursor == mContentEnd || *mCursor != '"' || !parse_string(nameOffset, nameLength))
+                        return false;
+
+                    skip_whitespaces();
+                    if (mCursor == mContentEnd || *mCursor != ':')
+                        return false;
+
+                    ++mCursor;
+                }
+
+                unsigned int childIndex = add_node();
+                mNodes[childIndex].mNameOffset = nameOffset;
+                mNodes[childIndex].mNameLength = nameLength;
+                if (prevChildIndex == 0)
+                {
+                    mNodes[nodeIndex].mFirstChild = childIndex;
+                }
+                else
+                {
+                    mNodes[prevChildIndex].mNextSibling = childIndex;
+                }
+                ++mNodes[nodeIndex].mChildrenCount;
+                prevChildIndex = childIndex;
+
+                if (!parse_value(childIndex))
+                    return false;
+
+                skip_whitespaces();
+                if (mCursor == mContentEnd)
+                    return false;
+
+                if (*mCursor == ',')
+                {
+                    ++mCursor;
+                    continue;
+                }
+
+                if (*mCursor == closingChar)
+                {
+                    ++mCursor;
+                    break;
+                }
+                return false;
+            }
+            --mDepth;
+            return true;
+        }
+
+        case '"':
+        {
+            mNodes[nodeIndex].mType = json_reader_node_type_string;
+
+            unsigned int stringOffset = 0;
+            unsigned int stringLength = 0;
+            if (!parse_string(stringOffset, stringLength))
+                return false;
+
+            mNodes[nodeIndex].mStringOffset = stringOffset;
+            mNodes[nodeIndex].mStringLength = stringLength;
+            return true;
+        }
+
+        case 't':
+            mNodes[nodeIndex].mType = json_reader_node_type_boolean;
+            mNodes[nodeIndex].mNumber = 1.0;
+            return parse_literal("true");
+
+        case 'f':
+            mNodes[nodeIndex].mType = json_reader_node_type_boolean;
+            mNodes[nodeIndex].mNumber = 0.0;
+            return parse_literal("false");
+
+        case 'n':
+            mNodes[nodeIndex].mType = json_reader_node_type_null;
+            return parse_literal("null");
+    }
+
+    // number, content is not necessarily zero terminated so it is copied to local buffer
+    char numberBuffer[JsonMaxNumberLength + 1];
+    int numberLength = 0;
+    while (mCursor < mContentEnd && numberLength < JsonMaxNumberLength &&
+        ((*mCursor >= '0' && *mCursor <= '9') || *mCursor == '-' || *mCursor == '+' || *mCursor == '.' || *mCursor == 'e' || *mCursor == 'E'))
+    {
+        numberBuffer[numberLength++] = *mCursor++;
+    }
+    numberBuffer[numberLength] = 0;
+
+    char* numberEnd = nullptr;
+    double numberValue = strtod(numberBuffer, &numberEnd);
+    if (numberLength == 0 || numberEnd != numberBuffer + numberLength)
+        return false;
+
+    mNodes[nodeIndex].mType = json_reader_node_type_number;
+    mNodes[nodeIndex].mNumber = numberValue;
+    return true;
+}
+
+bool json_reader::parse_string(unsigned int& outputOffset, unsigned int& outputLength)
+{
+    debug_assert(*mCursor == '"');
+    ++mCursor;
+
+    const size_t stringOffset = mStrings.size();
+    for (;;)
+    {
+        if (mCursor == mContentEnd)
+            return false;
+
+        char currChar = *mCursor++;
+        if (currChar == '"')
+            break;
+
+        if (currChar != '\\')
+        {
+            mStrings.push_back(currChar);
+            continue;
+        }
+
+        if (mCursor == mContentEnd)
+            return false;
+
+        currChar = *mCursor++;
+        switch (currChar)
+        {
+            case '"': case '\\': case '/': mStrings.push_back(currChar); break;
+            case 'b': mStrings.push_back('\b'); break;
+            case 'f': mStrings.push_back('\f'); break;
+            case 'n': mStrings.push_back('\n'); break;
+            case 'r': mStrings.push_back('\r'); break;
+            case 't': mStrings.push_back('\t'); break;
+            case 'u':
+            {
+                auto ParseHex4 = [this](unsigned int& codepoint) -> bool
+                {
+                    if (mContentEnd - mCursor < 4)
+                        return false;
+
+                    codepoint = 0;
+                    for (int icurr = 0; icurr < 4; ++icurr)
+                    {
+                        const char hexChar = *mCursor++;
+                        codepoint <<= 4;
+                        if (hexChar >= '0' && hexChar <= '9') codepoint |= (hexChar - '0');
+                        else if (hexChar >= 'a' && hexChar <= 'f') codepoint |= (hexChar - 'a' + 10);
+                        else if (hexChar >= 'A' && hexChar <= 'F') codepoint |= (hexChar - 'A' + 10);
+                        else
+                            return false;
+                    }
+                    return true;
+                };
+
+                unsigned int codepoint = 0;
+                if (!ParseHex4(codepoint))
+                    return false;
+
+                // surrogate pair
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+                {
+                    unsigned int lowSurrogate = 0;
+                    if (mContentEnd - mCursor < 2 || mCursor[0] != '\\' || mCursor[1] != 'u')
+                        return false;
+
+                    mCursor += 2;
+                    if (!ParseHex4(lowSurrogate) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+                        return false;
+
+                    codepoint = 0x10000 + (((codepoint & 0x3FF) << 10) | (lowSurrogate & 0x3FF));
+                }
+
+                // encode utf-8, never longer than escape sequence
+                if (codepoint < 0x80)
+                {
+                    mStrings.push_back((char) codepoint);
+                }
+                else if (codepoint < 0x800)
+                {
+                    mStrings.push_back((char) (0xC0 | (codepoint >> 6)));
+                    mStrings.push_back((char) (0x80 | (codepoint & 0x3F)));
+                }
+                else if (codepoint < 0x10000)
+                {
+                    mStrings.push_back((char) (0xE0 | (codepoint >> 12)));
+                    mStrings.push_back((char) (0x80 | ((codepoint >> 6) & 0x3F)));
+                    mStrings.push_back((char) (0x80 | (codepoint & 0x3F)));
+                }
+                else
+                {
+                    mStrings.push_back((char) (0xF0 | (codepoint >> 18)));
+                    mStrings.push_back((char) (0x80 | ((codepoint >> 12) & 0x3F)));
+                    mStrings.push_back((char) (0x80 | ((codepoint >> 6) & 0x3F)));
+                    mStrings.push_back((char) (0x80 | (codepoint & 0x3F)));
+                }
+            }
+            break;
+
+            default:
+                return false;
+        }
+    }
+
+    outputOffset = (unsigned int) stringOffset;
+    outputLength = (unsigned int) (mStrings.size() - stringOffset);
+    mStrings.push_back(0);
+    return true;
+}
+
+} // namespace cxx
\ No newline at end of file
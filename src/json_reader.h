@@ -0,0 +1,211 @@
+#pragma once
+
+namespace cxx
+{
+    class json_reader;
+
+    // json value type
+    enum json_reader_node_type
+    {
+        json_reader_node_type_null,
+        json_reader_node_type_boolean,
+        json_reader_node_type_number,
+        json_reader_node_type_string,
+        json_reader_node_type_array,
+        json_reader_node_type_object,
+    };
+
+    // readonly element of json reader document, lightweight handle which does not allocate memory
+    class json_reader_node
+    {
+        friend class json_reader;
+
+    public:
+        json_reader_node() = default;
+
+        // get next sibling element
+        json_reader_node next_sibling() const;
+
+        // get first child element of object or array element
+        json_reader_node first_child() const;
+
+        // get child node element by name, lookup does not allocate memory
+        // @param name: Node name
+        json_reader_node operator [] (const std::string& name) const;
+        json_reader_node operator [] (const char* name) const;
+
+        // get array element by index if array
+        // get child element by index if object
+        // @param elementIndex: Array element index
+        json_reader_node operator [] (int elementIndex) const;
+
+        // get number of elements in array
+        // get number of child elements if object
+        int get_elements_count() const;
+
+        // get name of element, empty for array elements and root
+        const char* get_element_name() const;
+
+        // get element type
+        json_reader_node_type get_type() const;
+
+        inline bool is_boolean() const { return get_type() == json_reader_node_type_boolean; }
+        inline bool is_number() const { return get_type() == json_reader_node_type_number; }
+        inline bool is_string() const { return get_type() == json_reader_node_type_string; }
+        inline bool is_array() const { return get_type() == json_reader_node_type_array; }
+        inline bool is_object() const { return get_type() == json_reader_node_type_object; }
+
+        // get element value, returns false on type mismatch
+        bool get_value(bool& output) const;
+        bool get_value(int& output) const;
+        bool get_value(float& output) const;
+        bool get_value(std::string& output) const;
+
+        // get string element value without copying
+        // @returns null on type mismatch
+        const char* get_value_cstr() const;
+        int get_value_length() const;
+
+        // operators
+        inline bool operator == (const json_reader_node& rhs) const { return mReader && rhs.mReader == mReader && rhs.mNodeIndex == mNodeIndex; }
+        inline bool operator != (const json_reader_node& rhs) const { return !(*this == rhs); }
+        inline operator bool () const { return mReader != nullptr; }
+
+    private:
+        json_reader_node(const json_reader* reader, unsigned int nodeIndex);
+
+        json_reader_node find_child(const char* name, size_t nameLength) const;
+
+    private:
+        const json_reader* mReader = nullptr;
+        unsigned int mNodeIndex = 0;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+
+    // helpers
+
+    // get attribute by name
+
+    bool json_get_attribute(json_reader_node json_node, const char* attribute_name, bool& output);
+    bool json_get_attribute(json_reader_node json_node, const char* attribute_name, std::string& output);
+    bool json_get_attribute(json_reader_node json_node, const char* attribute_name, int& output);
+    bool json_get_attribute(json_reader_node json_node, const char* attribute_name, float& output);
+
+    template<typename TEnumClass>
+    inline bool json_get_attribute(json_reader_node json_node, const char* attribute_name, TEnumClass& output)
+    {
+        static_assert(std::is_enum<TEnumClass>::value, "Enum expected");
+        if (const char* enumValueString = json_node[attribute_name].get_value_cstr())
+        {
+            if (parse_enum(enumValueString, output))
+                return true;
+
+            debug_assert(false);
+        }
+        return false;
+    }
+
+    // get attribute by index
+
+    bool json_get_attribute(json_reader_node json_node, int item_index, bool& output);
+    bool json_get_attribute(json_reader_node json_node, int item_index, std::string& output);
+    bool json_get_attribute(json_reader_node json_node, int item_index, int& output);
+    bool json_get_attribute(json_reader_node json_node, int item_index, float& output);
+
+    template<typename TEnumClass>
+    inline bool json_get_attribute(json_reader_node json_node, int item_index, TEnumClass& output)
+    {
+        static_assert(std::is_enum<TEnumClass>::value, "Enum expected");
+        if (const char* enumValueString = json_node[item_index].get_value_cstr())
+        {
+            if (parse_enum(enumValueString, output))
+                return true;
+
+            debug_assert(false);
+        }
+        return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+
+    // readonly json document,
+    // all elements are stored in flat nodes array and strings are stored in single buffer,
+    // buffers are kept between loads so reusing same reader does not allocate memory after warm up;
+    // document can be saved to binary blob and loaded back without parsing
+    class json_reader: public noncopyable
+    {
+        friend class json_reader_node;
+
+    public:
+        json_reader() = default;
+
+        // parse json document from text
+        // @param content: Content string
+        // @param contentLength: Content length
+        bool parse_document(const char* content, size_t contentLength);
+        bool parse_document(const std::string& content);
+
+        // load document from binary blob produced by save_binary
+        // @param blobData: Blob content
+        // @param blobLength: Blob content length
+        bool load_binary(const void* blobData, size_t blobLength);
+
+        // save parsed document to binary blob, blob also keeps source text length and hash
+        // @param outputData: Blob content
+        void save_binary(std::vector<unsigned char>& outputData) const;
+
+        // get length and hash of json text document was parsed from, it is stored in binary blob as well
+        // so outdated blob can be detected
+        inline size_t get_source_length() const { return mSourceLength; }
+        inline unsigned int get_source_hash() const { return mSourceHash; }
+
+        // compute hash of json text the same way as it is done on parsing
+        // @param content: Content string
+        // @param contentLength: Content length
+        static unsigned int compute_source_hash(const char* content, size_t contentLength);
+
+        // clear document content but keep allocated buffers
+        void close_document();
+
+        // get root json element of document
+        json_reader_node get_root_node() const;
+
+        // operators
+        inline operator bool () const { return !mNodes.empty(); }
+
+    private:
+        // flat node data, layout is stored in binary blob as is
+        struct node_data
+        {
+        public:
+            unsigned int mType = json_reader_node_type_null;
+            unsigned int mNameOffset = 0; // within strings buffer
+            unsigned int mNameLength = 0;
+            unsigned int mStringOffset = 0; // within strings buffer
+            unsigned int mStringLength = 0;
+            unsigned int mFirstChild = 0; // node index, 0 if none
+            unsigned int mNextSibling = 0; // node index, 0 if none
+            unsigned int mChildrenCount = 0;
+            double mNumber = 0.0; // numeric and boolean value
+        };
+
+        bool parse_value(unsigned int nodeIndex);
+        bool parse_string(unsigned int& outputOffset, unsigned int& outputLength);
+        bool parse_literal(const char* literal);
+        void skip_whitespaces();
+        unsigned int add_node();
+
+    private:
+        std::vector<node_data> mNodes; // first node is root
+        std::vector<char> mStrings; // zero terminated strings
+        size_t mSourceLength = 0;
+        unsigned int mSourceHash = 0;
+
+        // parsing state
+        const char* mCursor = nullptr;
+        const char* mContentEnd = nullptr;
+        int mDepth = 0;
+    };
+
+} // namespace cxx
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "lz4_utils.h"
+
+namespace cxx
+{
+
+bool lz4_decompress_block(const unsigned char* source_data, unsigned int source_length, unsigned char* output_data, unsigned int output_length)
+{
+    const unsigned char* source_cursor = source_data;
+    const unsigned char* source_end = source_data + source_length;
+    unsigned char* output_cursor = output_data;
+    unsigned char* output_end = output_data + output_length;
+
+    // reads extended length bytes which follow 15 in token
+    auto read_length = [&source_cursor, source_end](unsigned int& length) -> bool
+    {
+        if (length != 15)
+            return true;
+
+        for (;;)
+        {
+            if (source_cursor == source_end)
+                return false;
+
+            unsigned char length_byte = *source_cursor++;
+            length += length_byte;
+            if (length_byte != 255)
+                return true;
+        }
+    };
+
+    while (source_cursor < source_end)
+    {
+        const unsigned char token = *source_cursor++;
+
+        // literals
+        unsigned int literals_length = (token >> 4);
+        if (!read_length(literals_length))
+            return false;
+
+        if (literals_length > (unsigned int) (source_end - source_cursor) ||
+            literals_length > (unsigned int) (output_end - output_cursor))
+        {
+            return false;
+        }
+        memcpy(output_cursor, source_cursor, literals_length);
+        output_cursor += literals_length;
+        source_cursor += literals_length;
+
+        // last sequence contains literals only
+        if (source_cursor == source_end)
+            break;
+
+        // match
+        if (source_end - source_cursor < 2)
+            return false;
+
+        unsigned int match_offset = source_cursor[0] | (source_cursor[1] << 8);
+        source_cursor += 2;
+        if (match_offset == 0 || match_offset > (unsigned int) (output_cursor - output_data))
+            return false;
+
+        unsigned int match_length = (token & 0x0F);
+        if (!read_length(match_length))
+            return false;
+
+        match_length += 4; // min match length
+        if (match_length > (unsigned int) (output_end - output_cursor))
+            return false;
+
+        // regions may overlap, copy byte by byte
+        const unsigned char* match_cursor = output_cursor - match_offset;
+        for (unsigned int icursor = 0; icursor < match_length; ++icursor)
+        {
+            output_cursor[icursor] = match_cursor[icursor];
+        }
+        output_cursor += match_length;
+    }
+    return output_cursor == output_end;
+}
+
+} // namespace cxx
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace cxx
+{
+    // decompress data in lz4 block format, frame format is not supported
+    // @param source_data: Compressed block
+    // @param source_length: Compressed block length
+    // @param output_data: Output buffer
+    // @param output_length: Exact length of decompressed data
+    // @returns false on malformed input
+    bool lz4_decompress_block(const unsigned char* source_data, unsigned int source_length, unsigned char* output_data, unsigned int output_length);
+
+} // namespace cxx
\ No newline at end of file
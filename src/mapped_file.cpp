@@ -0,0 +1,152 @@
+#include "stdafx.h"
+#include "mapped_file.h"
+
+#if OS_NAME == OS_LINUX
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+#endif
+
+namespace cxx
+{
+
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+#if OS_NAME == OS_WINDOWS
+
+bool mapped_file::open(const std::string& pathto)
+{
+    close();
+
+    mFileHandle = ::CreateFileA(pathto.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mFileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(mFileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    mMappingHandle = ::CreateFileMappingA(mFileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mMappingHandle == NULL)
+    {
+        close();
+        return false;
+    }
+
+    mMappedData = (unsigned char*) ::MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (mMappedData == nullptr)
+    {
+        close();
+        return false;
+    }
+    mMappedSize = (size_t) fileSize.QuadPart;
+    return true;
+}
+
+void mapped_file::close()
+{
+    if (mMappedData)
+    {
+        ::UnmapViewOfFile(mMappedData);
+        mMappedData = nullptr;
+    }
+    if (mMappingHandle != NULL)
+    {
+        ::CloseHandle(mMappingHandle);
+        mMappingHandle = NULL;
+    }
+    if (mFileHandle != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(mFileHandle);
+        mFileHandle = INVALID_HANDLE_VALUE;
+    }
+    mMappedSize = 0;
+}
+
+#elif OS_NAME == OS_LINUX
+
+bool mapped_file::open(const std::string& pathto)
+{
+    close();
+
+    int fileDescriptor = ::open(pathto.c_str(), O_RDONLY);
+    if (fileDescriptor == -1)
+        return false;
+
+    struct stat fileStat;
+    if (::fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+    {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    void* mappedData = ::mmap(nullptr, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // mapping remains valid after descriptor is closed
+    ::close(fileDescriptor);
+
+    if (mappedData == MAP_FAILED)
+        return false;
+
+    mMappedData = (unsigned char*) mappedData;
+    mMappedSize = (size_t) fileStat.st_size;
+    return true;
+}
+
+void mapped_file::close()
+{
+    if (mMappedData)
+    {
+        ::munmap(mMappedData, mMappedSize);
+        mMappedData = nullptr;
+    }
+    mMappedSize = 0;
+}
+
+#else
+
+bool mapped_file::open(const std::string& pathto)
+{
+    close();
+
+    std::ifstream fileStream(pathto, std::ios::in | std::ios::binary);
+    if (!fileStream.is_open())
+        return false;
+
+    fileStream.seekg(0, std::ios::end);
+    size_t fileSize = (size_t) fileStream.tellg();
+    fileStream.seekg(0);
+    if (fileSize == 0)
+        return false;
+
+    mMappedData = (unsigned char*) malloc(fileSize);
+    if (mMappedData == nullptr)
+        return false;
+
+    if (!fileStream.read((char*) mMappedData, fileSize))
+    {
+        close();
+        return false;
+    }
+    mMappedSize = fileSize;
+    return true;
+}
+
+void mapped_file::close()
+{
+    if (mMappedData)
+    {
+        free(mMappedData);
+        mMappedData = nullptr;
+    }
+    mMappedSize = 0;
+}
+
+#endif
+
+} // namespace cxx
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace cxx
+{
+    // implements read only file mapping into memory,
+    // when mapping is not supported by platform file content gets loaded into memory buffer
+
+    class mapped_file: public cxx::noncopyable
+    {
+    public:
+        ~mapped_file();
+
+        // map file content into memory
+        // @param pathto: Path to file
+        // @returns false on error
+        bool open(const std::string& pathto);
+
+        // unmap file content
+        void close();
+
+        // test whether file is mapped
+        inline bool is_open() const { return mMappedData != nullptr; }
+
+        // get mapped content
+        inline const unsigned char* data() const { return mMappedData; }
+        inline size_t size() const { return mMappedSize; }
+
+    private:
+        unsigned char* mMappedData = nullptr;
+        size_t mMappedSize = 0;
+#if OS_NAME == OS_WINDOWS
+        HANDLE mFileHandle = INVALID_HANDLE_VALUE;
+        HANDLE mMappingHandle = NULL;
+#endif
+    };
+
+} // namespace cxx
\ No newline at end of file
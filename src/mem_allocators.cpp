@@ -39,18 +39,19 @@ bool linear_memory_allocator::init_allocator(unsigned int bufferSizeTotal)
 
 void* linear_memory_allocator::allocate(unsigned int dataLength)
 {
-    unsigned int allocPos = cxx::align_up(mMemorySizeUsed, 16);
-    if (allocPos + dataLength + sizeof(linear_alloc_header) <= mMemorySizeFree)
+    // header is placed right before data, data itself is aligned
+    unsigned int dataPos = cxx::align_up(mMemorySizeUsed + (unsigned int) sizeof(linear_alloc_header), 16);
+    if (dataPos + dataLength <= mMemorySizeTotal)
     {
-        unsigned char* dataPointer = ((unsigned char*) mMemoryBuffer) + allocPos;
+        unsigned char* dataPointer = ((unsigned char*) mMemoryBuffer) + dataPos;
 
         // write header
-        linear_alloc_header* headerPointer = (linear_alloc_header*) dataPointer;
+        linear_alloc_header* headerPointer = (linear_alloc_header*) (dataPointer - sizeof(linear_alloc_header));
         headerPointer->mAllocationLength = dataLength;
 
-        mMemorySizeUsed = allocPos + sizeof(linear_alloc_header) + dataLength;
+        mMemorySizeUsed = dataPos + dataLength;
         mMemorySizeFree = mMemorySizeTotal - mMemorySizeUsed;
-        return dataPointer + sizeof(linear_alloc_header);
+        return dataPointer;
     }
     else
     {   
@@ -76,7 +77,7 @@ void* linear_memory_allocator::reallocate(void* dataPointer, unsigned int dataLe
     dataPointer = allocate(dataLength);
     if (dataPointer) // copy old memory
     {
-        memcpy(dataPointer, sourcePointer, headerPointer->mAllocationLength);
+        memcpy(dataPointer, sourcePointer, std::min(headerPointer->mAllocationLength, dataLength));
         return dataPointer;
     }
     return nullptr;
@@ -92,11 +93,21 @@ void linear_memory_allocator::deallocate(void* dataPointer)
     linear_alloc_header* headerPointer = (linear_alloc_header*) (sourcePointer - sizeof(linear_alloc_header));
     if (sourcePointer + headerPointer->mAllocationLength == mMemoryBuffer + mMemorySizeUsed)
     {
-        mMemorySizeUsed -= (headerPointer->mAllocationLength + sizeof(linear_alloc_header));
-        mMemorySizeFree += (headerPointer->mAllocationLength + sizeof(linear_alloc_header));
+        mMemorySizeUsed = (unsigned int) (((unsigned char*) headerPointer) - mMemoryBuffer);
+        mMemorySizeFree = mMemorySizeTotal - mMemorySizeUsed;
     }
 }
 
+unsigned int linear_memory_allocator::get_allocation_length(void* dataPointer) const
+{
+    unsigned char* sourcePointer = (unsigned char*) dataPointer;
+    // sanity check
+    debug_assert(sourcePointer >= mMemoryBuffer && sourcePointer <= (mMemoryBuffer + mMemorySizeTotal));
+
+    linear_alloc_header* headerPointer = (linear_alloc_header*) (sourcePointer - sizeof(linear_alloc_header));
+    return headerPointer->mAllocationLength;
+}
+
 void linear_memory_allocator::reset()
 {
     mMemorySizeUsed = 0;
@@ -61,6 +61,13 @@ namespace cxx
         // reset allocations
         void reset() override;
 
+        // get memory usage info
+        inline unsigned int get_used_size() const { return mMemorySizeUsed; }
+        inline unsigned int get_total_size() const { return mMemorySizeTotal; }
+
+        // get requested length of previously allocated memory block
+        unsigned int get_allocation_length(void* dataPointer) const;
+
     private:
         unsigned int mMemorySizeTotal = 0;
         unsigned int mMemorySizeUsed = 0;
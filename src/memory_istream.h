@@ -8,12 +8,21 @@ namespace cxx
     class memory_istream: public std::streambuf
     {
     public:
+        memory_istream() = default;
         memory_istream(char* memory_begin, char* memory_end) 
             : mBegin(memory_begin)
             , mEnd(memory_end)
         {
             this->setg(memory_begin, memory_begin, memory_end);
         }
+
+        // change source memory range and reset read position
+        void set_memory(char* memory_begin, char* memory_end)
+        {
+            mBegin = memory_begin;
+            mEnd = memory_end;
+            this->setg(memory_begin, memory_begin, memory_end);
+        }
     
     private:
         // override streambuf
@@ -41,8 +50,8 @@ namespace cxx
         }
 
     private:
-        char* mBegin; 
-        char* mEnd;
+        char* mBegin = nullptr; 
+        char* mEnd = nullptr;
     };
 
     // stream helpers
@@ -8,12 +8,16 @@ namespace cxx
 
     namespace details
     {
+        template<typename TPoolElement, int BlockSize>
+        class object_pool_chunk;
+
         // node contains object data along with additional info
-        template<typename TPoolElement>
+        template<typename TPoolElement, int BlockSize>
         class object_pool_node
         {
         private:
-            using pool_node_t = object_pool_node<TPoolElement>;
+            using pool_node_t = object_pool_node<TPoolElement, BlockSize>;
+            using pool_chunk_t = object_pool_chunk<TPoolElement, BlockSize>;
             using data_storage_t = std::aligned_storage<sizeof(TPoolElement), alignof(TPoolElement)>;
             // raw data bytes
             using raw_data_t = typename data_storage_t::type;
@@ -39,25 +43,29 @@ namespace cxx
             // chain pointers, both null if node is in use
             pool_node_t* mNextFreeNode;
             pool_node_t* mPrevFreeNode;
+            // chunk which node belongs to, never changes
+            pool_chunk_t* mOwnerChunk;
         };
 
         // chunk contains fixed number of nodes
         template<typename TPoolElement, int BlockSize>
         class object_pool_chunk
         {
-            using pool_node_t = object_pool_node<TPoolElement>;
+            using pool_node_t = object_pool_node<TPoolElement, BlockSize>;
             using pool_chunk_t = object_pool_chunk<TPoolElement, BlockSize>;
 
         public:
             object_pool_chunk()
-                : mFreeNodesHead()
-                , mNextChunk()
+                : mNextChunk()
+                , mNextAvailableChunk()
+                , mFreeNodesHead()
             {
                 // init free nodes chain
                 for (int inode = 0; inode < BlockSize; ++inode)
                 {
                     mNodes[inode].mNextFreeNode = (inode < BlockSize - 1) ? &mNodes[inode + 1] : nullptr;
                     mNodes[inode].mPrevFreeNode = (inode > 0) ? &mNodes[inode - 1] : nullptr;
+                    mNodes[inode].mOwnerChunk = this;
                 }
                 mFreeNodesHead = mNodes;
             }
@@ -65,7 +73,7 @@ namespace cxx
             {
 #ifdef _DEBUG
                 int numFreeNodes = 0;
-                for (pool_node_t* currentNode = mFreeNodesHead; currentNode; 
+                for (pool_node_t* currentNode = mFreeNodesHead; currentNode;
                     currentNode = currentNode->mNextFreeNode)
                 {
                     ++numFreeNodes;
@@ -73,26 +81,12 @@ namespace cxx
                 debug_assert(numFreeNodes == BlockSize);
 #endif
                 mFreeNodesHead = nullptr;
-                if (mNextChunk)
-                {
-                    delete mNextChunk;
-                }
             }
-            // request free element from pool chunk
+            // request free element from pool chunk, chunk must have free nodes
             template<typename ... TArgs>
             inline TPoolElement* allocate_object(TArgs&& ... args)
             {
-                if (mFreeNodesHead == nullptr)
-                {
-                    // allocate new chunk
-                    if (mNextChunk == nullptr)
-                    {
-                        mNextChunk = new pool_chunk_t();
-                    }
-
-                    TPoolElement* element = mNextChunk->allocate_object(std::forward<TArgs>(args)...);
-                    return element;
-                }
+                debug_assert(mFreeNodesHead);
 
                 pool_node_t* node = mFreeNodesHead;
                 pop_from_free_nodes_list(node);
@@ -100,31 +94,25 @@ namespace cxx
                 // initialize object
                 return node->construct(std::forward<TArgs>(args)...);
             }
-            // return used element to pool chunk
-            inline void deallocate_object(TPoolElement* element)
+            // return used element to pool chunk, node must belong to this chunk
+            inline void deallocate_object(pool_node_t* node)
             {
-                debug_assert(element);
-                pool_node_t* node = reinterpret_cast<pool_node_t*>(element);
-                if (node >= mNodes && node < mNodes + BlockSize)
-                {
-                    bool isUsedNode = is_used_node(node);
-
-                    debug_assert(isUsedNode);
-                    if (isUsedNode) // valid node
-                    {
-                        node->destruct();
-                        put_to_free_nodes_list(node);
-                    }
-                    return;
-                }
+                debug_assert(node);
+                debug_assert(node->mOwnerChunk == this);
+
+                bool isUsedNode = is_used_node(node);
 
-                if (mNextChunk)
+                debug_assert(isUsedNode);
+                if (isUsedNode) // valid node
                 {
-                    mNextChunk->deallocate_object(element);
-                    return;
+                    node->destruct();
+                    put_to_free_nodes_list(node);
                 }
-                // invalid node
-                debug_assert(false);
+            }
+            // test whether chunk has no more free nodes
+            inline bool is_full() const
+            {
+                return mFreeNodesHead == nullptr;
             }
         private:
             // remove node from free list
@@ -157,17 +145,21 @@ namespace cxx
                 mFreeNodesHead = node;
             }
             // test whether node is free
-            inline bool is_free_node(pool_node_t* node)
+            inline bool is_free_node(pool_node_t* node) const
             {
                 return node->mNextFreeNode || node->mPrevFreeNode || node == mFreeNodesHead;
             }
             // test whether node is used
-            inline bool is_used_node(pool_node_t* node)
+            inline bool is_used_node(pool_node_t* node) const
             {
                 return !is_free_node(node);
             }
-        private:
+        public:
+            // all chunks chain
             pool_chunk_t* mNextChunk;
+            // chunks with free nodes chain, valid only while chunk is not full
+            pool_chunk_t* mNextAvailableChunk;
+        private:
             pool_node_t* mFreeNodesHead;
             pool_node_t mNodes[BlockSize];
         };
@@ -178,6 +170,7 @@ namespace cxx
     template<typename TPoolElement, int BlockSize = 1024>
     class object_pool
     {
+        using pool_node_t = details::object_pool_node<TPoolElement, BlockSize>;
         using pool_chunk_t = details::object_pool_chunk<TPoolElement, BlockSize>;
 
     public:
@@ -190,34 +183,79 @@ namespace cxx
         template<typename ... TArgs>
         inline TPoolElement* create(TArgs&& ... args)
         {
-            if (mFirstChunk == nullptr)
+            if (mAvailableChunksHead == nullptr)
+            {
+                // allocate new chunk
+                pool_chunk_t* newChunk = new pool_chunk_t;
+                newChunk->mNextChunk = mFirstChunk;
+                mFirstChunk = newChunk;
+                mAvailableChunksHead = newChunk;
+                ++mChunksCount;
+            }
+
+            pool_chunk_t* chunk = mAvailableChunksHead;
+            TPoolElement* poolElement = chunk->allocate_object(std::forward<TArgs>(args)...);
+            if (chunk->is_full())
             {
-                mFirstChunk = new pool_chunk_t;
+                mAvailableChunksHead = chunk->mNextAvailableChunk;
+                chunk->mNextAvailableChunk = nullptr;
             }
 
-            TPoolElement* poolElement = mFirstChunk->allocate_object(std::forward<TArgs>(args)...);
+            ++mLiveCount;
+            if (mLiveCount > mPeakCount)
+            {
+                mPeakCount = mLiveCount;
+            }
             return poolElement;
         }
         // return object to pool
         inline void destroy(TPoolElement* element)
         {
-            debug_assert(mFirstChunk);
-            if (mFirstChunk)
+            debug_assert(element);
+            if (element == nullptr)
+                return;
+
+            pool_node_t* node = reinterpret_cast<pool_node_t*>(element);
+            pool_chunk_t* chunk = node->mOwnerChunk;
+            debug_assert(chunk);
+
+            bool wasFull = chunk->is_full();
+            chunk->deallocate_object(node);
+            if (wasFull)
             {
-                mFirstChunk->deallocate_object(element);
+                // chunk has free nodes again
+                chunk->mNextAvailableChunk = mAvailableChunksHead;
+                mAvailableChunksHead = chunk;
             }
+
+            debug_assert(mLiveCount > 0);
+            --mLiveCount;
         }
         // frees allocated memory but does not destruct objects inside pool - user must do it manually
         inline void cleanup()
         {
-            if (mFirstChunk)
+            while (mFirstChunk)
             {
+                pool_chunk_t* nextChunk = mFirstChunk->mNextChunk;
                 delete mFirstChunk;
-                mFirstChunk = nullptr;
+                mFirstChunk = nextChunk;
             }
+            mAvailableChunksHead = nullptr;
+            mChunksCount = 0;
+            mLiveCount = 0;
         }
+        // get number of objects currently allocated from pool
+        inline int get_live_count() const { return mLiveCount; }
+        // get max number of objects allocated at once since pool was created
+        inline int get_peak_count() const { return mPeakCount; }
+        // get number of allocated chunks, each one holds BlockSize objects
+        inline int get_chunks_count() const { return mChunksCount; }
     private:
         pool_chunk_t* mFirstChunk = nullptr;
+        pool_chunk_t* mAvailableChunksHead = nullptr;
+        int mLiveCount = 0;
+        int mPeakCount = 0;
+        int mChunksCount = 0;
     };
 
 } // namespace cxx
\ No newline at end of file
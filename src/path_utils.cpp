@@ -91,12 +91,26 @@ void enum_files_recursive(std::string pathto, enum_files_proc enumproc)
     if (!filesystem::exists(sourcePath))
         return;
 
+    std::string sourcePrefix = sourcePath.generic_string();
+    if (!sourcePrefix.empty() && sourcePrefix.back() != '/')
+    {
+        sourcePrefix.push_back('/');
+    }
+
     filesystem::recursive_directory_iterator iter_directory_end;
     for (filesystem::recursive_directory_iterator iter_directory(sourcePath); 
         iter_directory != iter_directory_end; ++iter_directory)
     {
-        const filesystem::path& currentFile = iter_directory->path();
-        enumproc(currentFile.filename().generic_string());
+        if (!filesystem::is_regular_file(iter_directory->status()))
+            continue;
+
+        // iterator paths are prefixed with source path
+        std::string currentFile = iter_directory->path().generic_string();
+        if (currentFile.length() > sourcePrefix.length() && currentFile.compare(0, sourcePrefix.length(), sourcePrefix) == 0)
+        {
+            currentFile.erase(0, sourcePrefix.length());
+        }
+        enumproc(currentFile);
     }
 }
 
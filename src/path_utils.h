@@ -38,6 +38,10 @@ namespace cxx
     // @param pathto: Location
     // @param enumproc: Enumeration callback
     void enum_files(std::string pathto, enum_files_proc enumproc);
+
+    // enumerate files at specific location including subdirectories, paths are relative to location
+    // @param pathto: Location
+    // @param enumproc: Enumeration callback
     void enum_files_recursive(std::string pathto, enum_files_proc enumproc);
 
 } // namespace cxx
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+namespace cxx
+{
+    // implements bounded lock-free queue for single producer and single consumer threads,
+    // elements are stored in fixed ring buffer so there are no memory allocations
+
+    template<typename TElement, unsigned int Capacity>
+    class spsc_queue final
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity expected to be power of two");
+
+    public:
+        spsc_queue() = default;
+        // disable copy
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator = (const spsc_queue&) = delete;
+
+        // add element to queue, producer thread only
+        // @returns false if queue is full
+        inline bool push(const TElement& element)
+        {
+            const unsigned int writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+            if ((writeIndex - mReadIndex.load(std::memory_order_acquire)) == Capacity)
+                return false;
+
+            mElements[writeIndex & (Capacity - 1)] = element;
+            mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        // take element from queue, consumer thread only
+        // @returns false if queue is empty
+        inline bool pop(TElement& element)
+        {
+            const unsigned int readIndex = mReadIndex.load(std::memory_order_relaxed);
+            if (readIndex == mWriteIndex.load(std::memory_order_acquire))
+                return false;
+
+            element = mElements[readIndex & (Capacity - 1)];
+            mReadIndex.store(readIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        // test whether queue has no elements, result may be outdated immediately
+        inline bool empty() const
+        {
+            return mReadIndex.load(std::memory_order_acquire) == mWriteIndex.load(std::memory_order_acquire);
+        }
+
+    private:
+        TElement mElements[Capacity];
+        // indices are growing continuously and wrapped on access, separated to avoid false sharing
+        alignas(64) std::atomic<unsigned int> mWriteIndex {0};
+        alignas(64) std::atomic<unsigned int> mReadIndex {0};
+    };
+
+} // namespace cxx
\ No newline at end of file
@@ -37,6 +37,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <deque>
 #include <list>
@@ -48,6 +49,10 @@
 #include <cctype>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 #include <functional>
 
 // opengl
@@ -78,12 +83,15 @@
 #include "handle.h"
 #include "intrusive_list.h"
 #include "memory_istream.h"
+#include "mapped_file.h"
 #include "noncopyable.h"
 #include "object_pool.h"
+#include "spsc_queue.h"
 #include "randomizer.h"
 #include "strings.h"
 #include "path_utils.h"
 #include "json_document.h"
+#include "json_reader.h"
 #include "mem_allocators.h"
 #include "iostream_utils.h"
 
@@ -0,0 +1,55 @@
+# Builds game data pack file which can be mounted with g_packfile cvar
+# usage: build_pack.py <source directory> <output pack file> [--lz4]
+# lz4 compression requires python lz4 package
+
+import os, sys, struct
+
+PACK_SIGNATURE = 0x50443343 # 'C3DP'
+PACK_VERSION = 1
+PACK_ENTRY_FLAGS_LZ4 = 1
+
+if len(sys.argv) < 3:
+	print ('usage: build_pack.py <source directory> <output pack file> [--lz4]')
+	sys.exit(1)
+
+source_directory = os.path.abspath(sys.argv[1])
+output_file = os.path.abspath(sys.argv[2])
+use_lz4 = '--lz4' in sys.argv[3:]
+
+if use_lz4:
+	import lz4.block
+
+entries = []
+for root, dirs, files in os.walk(source_directory):
+	dirs.sort()
+	for name in sorted(files):
+		full_path = os.path.join(root, name)
+		if full_path == output_file:
+			continue
+		relative_path = os.path.relpath(full_path, source_directory).replace(os.sep, '/')
+		with open(full_path, 'rb') as f:
+			content = f.read()
+		flags = 0
+		packed = content
+		if use_lz4 and len(content) > 0:
+			compressed = lz4.block.compress(content, store_size=False, mode='high_compression')
+			if len(compressed) < len(content):
+				packed = compressed
+				flags = PACK_ENTRY_FLAGS_LZ4
+		entries.append((relative_path.encode('utf-8'), packed, len(content), flags))
+
+# header, entries data, entries table
+header_size = 16
+data_offset = header_size
+table_offset = header_size + sum(len(packed) for _, packed, _, _ in entries)
+
+with open(output_file, 'wb') as f:
+	f.write(struct.pack('<IIII', PACK_SIGNATURE, PACK_VERSION, len(entries), table_offset))
+	for _, packed, _, _ in entries:
+		f.write(packed)
+	for name, packed, unpacked_size, flags in entries:
+		f.write(struct.pack('<IIIHH', data_offset, len(packed), unpacked_size, flags, len(name)))
+		f.write(name)
+		data_offset += len(packed)
+
+print ('Packed %d files to %s' % (len(entries), output_file))